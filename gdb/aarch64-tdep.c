@@ -36,6 +36,7 @@
 #include "objfiles.h"
 #include "dwarf2.h"
 #include "dwarf2/frame.h"
+#include "sframe-frame.h"
 #include "gdbtypes.h"
 #include "prologue-value.h"
 #include "target-descriptions.h"
@@ -4551,6 +4552,7 @@ aarch64_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
 
   /* Add some default predicates.  */
   frame_unwind_append_unwinder (gdbarch, &aarch64_stub_unwind);
+  sframe_append_unwinders (gdbarch);
   dwarf2_append_unwinders (gdbarch);
   frame_unwind_append_unwinder (gdbarch, &aarch64_prologue_unwind);
 
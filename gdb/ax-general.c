@@ -26,6 +26,7 @@
 
 #include "value.h"
 #include "user-regs.h"
+#include "extract-store-integer.h"
 
 static void append_const (struct agent_expr *x, LONGEST val, int n);
 
@@ -556,3 +557,260 @@ ax_reqs (struct agent_expr *ax)
 
   ax->final_height = height;
 }
+
+/* See ax.h.  */
+
+bool
+ax_eval (const agent_expr &x,
+	 gdb::function_view<bool (int regnum, ULONGEST *val)> read_reg,
+	 gdb::function_view<bool (CORE_ADDR addr, gdb_byte *buf,
+				  int len)> read_mem,
+	 ULONGEST *result)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (x.gdbarch);
+  std::vector<ULONGEST> stack;
+  size_t pc = 0;
+
+  /* Read the N bytes of operand at PC, most significant first.  */
+  auto fetch = [&] (int n, ULONGEST *val)
+    {
+      if (pc + n > x.buf.size ())
+	return false;
+
+      *val = 0;
+      for (int i = 0; i < n; i++)
+	*val = (*val << 8) | x.buf[pc++];
+      return true;
+    };
+
+  auto pop = [&] (ULONGEST *val)
+    {
+      if (stack.empty ())
+	return false;
+
+      *val = stack.back ();
+      stack.pop_back ();
+      return true;
+    };
+
+  while (pc < x.buf.size ())
+    {
+      enum agent_op op = (enum agent_op) x.buf[pc++];
+      ULONGEST a = 0, b = 0, arg = 0;
+
+      /* Pop the operands of the binary operators, B being the top of
+	 the stack.  */
+      switch (op)
+	{
+	case aop_add:
+	case aop_sub:
+	case aop_mul:
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	case aop_bit_and:
+	case aop_bit_or:
+	case aop_bit_xor:
+	case aop_equal:
+	case aop_less_signed:
+	case aop_less_unsigned:
+	  if (!pop (&b) || !pop (&a))
+	    return false;
+	  break;
+
+	default:
+	  break;
+	}
+
+      switch (op)
+	{
+	case aop_add:
+	  stack.push_back (a + b);
+	  break;
+
+	case aop_sub:
+	  stack.push_back (a - b);
+	  break;
+
+	case aop_mul:
+	  stack.push_back (a * b);
+	  break;
+
+	case aop_div_signed:
+	case aop_rem_signed:
+	  /* Leave the error of dividing by zero, and the overflow of
+	     dividing the smallest value by -1, to the evaluation in
+	     GDB.  */
+	  if (b == 0 || ((LONGEST) b == -1 && (LONGEST) a == LONGEST_MIN))
+	    return false;
+	  if (op == aop_div_signed)
+	    stack.push_back ((LONGEST) a / (LONGEST) b);
+	  else
+	    stack.push_back ((LONGEST) a % (LONGEST) b);
+	  break;
+
+	case aop_div_unsigned:
+	case aop_rem_unsigned:
+	  if (b == 0)
+	    return false;
+	  stack.push_back (op == aop_div_unsigned ? a / b : a % b);
+	  break;
+
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	  if (b >= sizeof (ULONGEST) * HOST_CHAR_BIT)
+	    return false;
+	  if (op == aop_lsh)
+	    stack.push_back (a << b);
+	  else if (op == aop_rsh_signed)
+	    stack.push_back ((LONGEST) a >> b);
+	  else
+	    stack.push_back (a >> b);
+	  break;
+
+	case aop_bit_and:
+	  stack.push_back (a & b);
+	  break;
+
+	case aop_bit_or:
+	  stack.push_back (a | b);
+	  break;
+
+	case aop_bit_xor:
+	  stack.push_back (a ^ b);
+	  break;
+
+	case aop_equal:
+	  stack.push_back (a == b);
+	  break;
+
+	case aop_less_signed:
+	  stack.push_back ((LONGEST) a < (LONGEST) b);
+	  break;
+
+	case aop_less_unsigned:
+	  stack.push_back (a < b);
+	  break;
+
+	case aop_log_not:
+	case aop_bit_not:
+	  if (!pop (&a))
+	    return false;
+	  stack.push_back (op == aop_log_not ? !a : ~a);
+	  break;
+
+	case aop_ext:
+	case aop_zero_ext:
+	  if (!fetch (1, &arg) || arg == 0 || !pop (&a))
+	    return false;
+	  if (arg < sizeof (ULONGEST) * HOST_CHAR_BIT)
+	    {
+	      ULONGEST mask = ((ULONGEST) 1 << arg) - 1;
+
+	      a &= mask;
+	      if (op == aop_ext && (a & ((ULONGEST) 1 << (arg - 1))) != 0)
+		a |= ~mask;
+	    }
+	  stack.push_back (a);
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  {
+	    int len = (op == aop_ref8 ? 1
+		       : op == aop_ref16 ? 2
+		       : op == aop_ref32 ? 4 : 8);
+	    gdb_byte buf[8];
+
+	    if (!pop (&a) || !read_mem ((CORE_ADDR) a, buf, len))
+	      return false;
+	    stack.push_back (extract_unsigned_integer (buf, len, byte_order));
+	  }
+	  break;
+
+	case aop_if_goto:
+	  if (!fetch (2, &arg) || !pop (&a))
+	    return false;
+	  if (a != 0)
+	    pc = arg;
+	  break;
+
+	case aop_goto:
+	  if (!fetch (2, &arg))
+	    return false;
+	  pc = arg;
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  {
+	    int len = (op == aop_const8 ? 1
+		       : op == aop_const16 ? 2
+		       : op == aop_const32 ? 4 : 8);
+
+	    if (!fetch (len, &arg))
+	      return false;
+	    stack.push_back (arg);
+	  }
+	  break;
+
+	case aop_reg:
+	  if (!fetch (2, &arg) || !read_reg (arg, &a))
+	    return false;
+	  stack.push_back (a);
+	  break;
+
+	case aop_end:
+	  if (stack.empty ())
+	    return false;
+	  *result = stack.back ();
+	  return true;
+
+	case aop_dup:
+	  if (stack.empty ())
+	    return false;
+	  stack.push_back (stack.back ());
+	  break;
+
+	case aop_pop:
+	  if (!pop (&a))
+	    return false;
+	  break;
+
+	case aop_pick:
+	  if (!fetch (1, &arg) || arg >= stack.size ())
+	    return false;
+	  stack.push_back (stack[stack.size () - 1 - arg]);
+	  break;
+
+	case aop_swap:
+	  if (stack.size () < 2)
+	    return false;
+	  std::swap (stack[stack.size () - 1], stack[stack.size () - 2]);
+	  break;
+
+	case aop_rot:
+	  if (stack.size () < 3)
+	    return false;
+	  std::rotate (stack.end () - 3, stack.end () - 1, stack.end ());
+	  break;
+
+	default:
+	  /* Floating point, tracing, trace state variables and printf
+	     need GDB, or an agent that knows about them.  */
+	  return false;
+	}
+    }
+
+  /* The expression has no end.  */
+  return false;
+}
@@ -19,6 +19,8 @@
 #ifndef AX_H
 #define AX_H
 
+#include "gdbsupport/function-view.h"
+
 /* It's sometimes useful to be able to debug programs that you can't
    really stop for more than a fraction of a second.  To this end, the
    user can specify a tracepoint (like a breakpoint, but you don't
@@ -214,6 +216,21 @@ extern void ax_tsv (struct agent_expr *expr, enum agent_op op, int num);
 extern void ax_string (struct agent_expr *x, const char *str, int slen);
 
 
+/* Evaluate the agent expression X in GDB, reading register number
+   REGNUM (as numbered in the bytecode) with READ_REG, and LEN bytes of
+   memory at ADDR with READ_MEM.  These return false if they can't
+   read the value.  If X runs to its end, store the value on the top
+   of the stack in *RESULT and return true.  Return false if X can't
+   be evaluated here: it reads something that isn't available, uses
+   an operation that needs more than the registers and memory (like
+   trace state variables or floating point), or is malformed.  */
+
+extern bool ax_eval
+  (const agent_expr &x,
+   gdb::function_view<bool (int regnum, ULONGEST *val)> read_reg,
+   gdb::function_view<bool (CORE_ADDR addr, gdb_byte *buf, int len)> read_mem,
+   ULONGEST *result);
+
 /* Functions for printing out expressions, and otherwise debugging
    things.  */
 
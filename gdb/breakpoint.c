@@ -84,6 +84,7 @@
 #include "gdbsupport/array-view.h"
 #include <optional>
 #include "gdbsupport/common-utils.h"
+#include "symbol-name-filter.h"
 
 /* Prototypes for local functions.  */
 
@@ -4538,6 +4539,40 @@ software_breakpoint_inserted_here_p (const address_space *aspace,
 
 /* See breakpoint.h.  */
 
+bool
+only_target_conditions_breakpoint_here_p (const address_space *aspace,
+					  CORE_ADDR pc)
+{
+  bool inserted = false;
+
+  for (bp_location *bl : all_bp_locations_at_addr (pc))
+    {
+      if (bl->loc_type != bp_loc_software_breakpoint
+	  && bl->loc_type != bp_loc_hardware_breakpoint)
+	continue;
+
+      if (!breakpoint_address_match (bl->pspace->aspace.get (), bl->address,
+				     aspace, pc))
+	continue;
+
+      if (bp_location_inserted_here_p (bl, aspace, pc)
+	  && bl->loc_type == bp_loc_software_breakpoint)
+	inserted = true;
+
+      /* Internal breakpoints (like the step-resume breakpoints) and
+	 breakpoints whose condition GDB evaluates must always be
+	 reported, whether or not they are the location holding the
+	 conditions on the target.  */
+      if (unduplicated_should_be_inserted (bl)
+	  && (!is_breakpoint (bl->owner) || bl->cond_bytecode == nullptr))
+	return false;
+    }
+
+  return inserted;
+}
+
+/* See breakpoint.h.  */
+
 int
 hardware_breakpoint_inserted_here_p (const address_space *aspace,
 				     CORE_ADDR pc)
@@ -11745,9 +11780,31 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   std::vector<bp_location *> old_locations = std::move (bp_locations);
   bp_locations.clear ();
 
+  /* Most of the time, only a few locations are added or removed, so
+     rather than sorting all the locations again, only sort the new
+     ones and merge them with the ones that were already in the list,
+     which are still sorted.  Mark the old locations, and then all the
+     current ones, to tell them apart.  */
+  static unsigned long long global_list_mark;
+  const unsigned long long old_mark = ++global_list_mark;
+  const unsigned long long current_mark = ++global_list_mark;
+
+  for (bp_location *loc : old_locations)
+    loc->global_list_mark = old_mark;
+
+  std::vector<bp_location *> added_locations;
   for (breakpoint &b : all_breakpoints ())
     for (bp_location &loc : b.locations ())
-      bp_locations.push_back (&loc);
+      {
+	if (loc.global_list_mark != old_mark)
+	  added_locations.push_back (&loc);
+	loc.global_list_mark = current_mark;
+      }
+
+  bp_locations.reserve (old_locations.size () + added_locations.size ());
+  for (bp_location *loc : old_locations)
+    if (loc->global_list_mark == current_mark)
+      bp_locations.push_back (loc);
 
   /* See if we need to "upgrade" a software breakpoint to a hardware
      breakpoint.  Do this before deciding whether locations are
@@ -11756,9 +11813,28 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   for (bp_location *loc : bp_locations)
     if (!loc->inserted && should_be_inserted (loc))
 	handle_automatic_hardware_breakpoints (loc);
+  for (bp_location *loc : added_locations)
+    if (!loc->inserted && should_be_inserted (loc))
+	handle_automatic_hardware_breakpoints (loc);
 
-  std::sort (bp_locations.begin (), bp_locations.end (),
-	     bp_location_is_less_than);
+  /* The order of the old locations only changes if one of them was
+     upgraded above, or otherwise changed in place.  */
+  if (!std::is_sorted (bp_locations.begin (), bp_locations.end (),
+		       bp_location_is_less_than))
+    std::sort (bp_locations.begin (), bp_locations.end (),
+	       bp_location_is_less_than);
+
+  if (!added_locations.empty ())
+    {
+      std::sort (added_locations.begin (), added_locations.end (),
+		 bp_location_is_less_than);
+      size_t n_old = bp_locations.size ();
+      bp_locations.insert (bp_locations.end (), added_locations.begin (),
+			   added_locations.end ());
+      std::inplace_merge (bp_locations.begin (),
+			  bp_locations.begin () + n_old,
+			  bp_locations.end (), bp_location_is_less_than);
+    }
 
   bp_locations_target_extensions_update ();
 
@@ -13586,11 +13662,140 @@ breakpoint_re_set_one (breakpoint *b)
   b->re_set ();
 }
 
+/* Return true if NAME, the name of a function in a location spec, may
+   match a symbol or minimal symbol of OBJFILE.  */
+
+static bool
+function_name_may_match_in_objfile (const char *name, objfile *objfile)
+{
+  const symbol_name_filter *filter = objfile_symbol_name_filter (objfile);
+  if (filter == nullptr || filter->maybe_contains (name))
+    return true;
+
+  if (objfile->per_bfd->minimal_symbol_count == 0)
+    return false;
+  filter = objfile_minimal_symbol_name_filter (objfile);
+  return filter == nullptr || filter->maybe_contains (name);
+}
+
+/* Return true if the sals of LOCSPEC may change because of the new
+   objfiles OBJFILES.
+
+   This is only known for location specs that name a function,
+   possibly in a given source file, because the locations of such a
+   spec that are in an objfile only depend on the symbols of that
+   objfile with that name.  A new objfile can also remove locations
+   from other objfiles, like the PLT stub of a function it defines,
+   but only if it has a symbol with that name too.  Other specs, like
+   a source line, which can be matched only approximately, or an
+   address expression, may change with any new objfile.  */
+
+static bool
+locspec_may_match_in_objfiles (const location_spec *locspec,
+			       gdb::array_view<objfile *const> objfiles)
+{
+  /* The names that a symbol matching LOCSPEC has to have one of.  */
+  std::vector<std::string> names;
+
+  if (locspec->type () == EXPLICIT_LOCATION_SPEC)
+    {
+      auto *explicit_loc
+	= static_cast<const explicit_location_spec *> (locspec);
+      if (explicit_loc->function_name == nullptr
+	  || explicit_loc->line_offset.sign != LINE_OFFSET_UNKNOWN)
+	return true;
+      names.emplace_back (explicit_loc->function_name.get ());
+    }
+  else if (locspec->type () == LINESPEC_LOCATION_SPEC)
+    {
+      auto *linespec_loc
+	= static_cast<const linespec_location_spec *> (locspec);
+      const char *spec = linespec_loc->spec_string.get ();
+      if (spec == nullptr)
+	return true;
+
+      /* Split SPEC at each ':' that isn't part of a '::', as in
+	 FILE:FUNCTION or FUNCTION:LABEL.  The function name is one of
+	 the parts, and taking all of them into account is safe.
+	 Don't try to interpret anything else: line numbers, offsets,
+	 quoting, Objective-C selectors, convenience variables...  */
+      if (*spec == '\0' || *spec == '-' || *spec == '+' || *spec == '*'
+	  || strpbrk (spec, "'\"$") != nullptr)
+	return true;
+
+      std::string part;
+      for (const char *p = spec; ; ++p)
+	{
+	  if (*p == ':' && p[1] == ':')
+	    {
+	      part += "::";
+	      ++p;
+	      continue;
+	    }
+	  if (*p == ':' || *p == '\0')
+	    {
+	      part.erase (0, part.find_first_not_of (" \t"));
+	      part.erase (part.find_last_not_of (" \t") + 1);
+	      if (part.empty () || isdigit (part[0]))
+		return true;
+	      names.push_back (std::move (part));
+	      part.clear ();
+	      if (*p == '\0')
+		break;
+	      continue;
+	    }
+	  part += *p;
+	}
+    }
+  else
+    return true;
+
+  for (objfile *objfile : objfiles)
+    for (const std::string &name : names)
+      if (function_name_may_match_in_objfile (name.c_str (), objfile))
+	return true;
+
+  return false;
+}
+
+/* Return true if B has to be re-set because the objfiles OBJFILES
+   were added to the current program space.  */
+
+static bool
+breakpoint_re_set_needed_p (breakpoint *b,
+			    gdb::array_view<objfile *const> objfiles)
+{
+  /* Only the locations of user breakpoints, dprintfs and tracepoints
+     just depend on their location specs.  */
+  if (!is_breakpoint (b)
+      && b->type != bp_tracepoint
+      && b->type != bp_fast_tracepoint)
+    return true;
+
+  code_breakpoint *cb = gdb::checked_static_cast<code_breakpoint *> (b);
+  if (breakpoint_location_spec_empty_p (cb))
+    return true;
+
+  /* The locations in libraries that were unloaded meanwhile are only
+     removed by a re-set.  */
+  for (const bp_location &loc : b->locations ())
+    if (loc.shlib_disabled)
+      return true;
+
+  return (locspec_may_match_in_objfiles (cb->locspec.get (), objfiles)
+	  || (cb->locspec_range_end != nullptr
+	      && locspec_may_match_in_objfiles (cb->locspec_range_end.get (),
+						objfiles)));
+}
+
 /* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+   Locations bound to other program spaces are left untouched.  If
+   NEW_OBJFILES is not empty, the only change since the last re-set is
+   that these objfiles were added, and only the breakpoints that may
+   have locations in them are re-set.  */
 
-void
-breakpoint_re_set (void)
+static void
+breakpoint_re_set_1 (gdb::array_view<objfile *const> new_objfiles)
 {
   {
     scoped_restore_current_language save_language;
@@ -13617,6 +13822,14 @@ breakpoint_re_set (void)
 
     for (breakpoint &b : all_breakpoints_safe ())
       {
+	if (!new_objfiles.empty ()
+	    && !breakpoint_re_set_needed_p (&b, new_objfiles))
+	  {
+	    breakpoint_debug_printf ("not re-setting breakpoint %d",
+				     b.number);
+	    continue;
+	  }
+
 	try
 	  {
 	    breakpoint_re_set_one (&b);
@@ -13640,6 +13853,31 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_1 ({});
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (gdb::array_view<objfile *const> objfiles)
+{
+  /* Take the separate debug objfiles into account too.  */
+  std::vector<objfile *> all_objfiles;
+  for (objfile *objfile : objfiles)
+    for (::objfile *iter : objfile->separate_debug_objfiles ())
+      all_objfiles.push_back (iter);
+
+  if (all_objfiles.empty ())
+    return;
+
+  breakpoint_re_set_1 (all_objfiles);
+}
 
 /* Reset the thread number of this breakpoint:
 
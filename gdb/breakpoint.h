@@ -485,6 +485,11 @@ class bp_location : public refcounted_object, public intrusive_list_node<bp_loca
      it becomes 0 this location is retired.  */
   int events_till_retirement = 0;
 
+  /* Used by update_global_location_list to tell the locations that
+     were already in the global location list, that are still there,
+     or that were added, apart, without searching the list.  */
+  unsigned long long global_list_mark = 0;
+
   /* Line number which was used to place this location.
 
      Breakpoint placed into a comment keeps it's user specified line number
@@ -1465,6 +1470,13 @@ extern int breakpoint_inserted_here_p (const address_space *,
 extern int software_breakpoint_inserted_here_p (const address_space *,
 						CORE_ADDR);
 
+/* Return true if there is a software breakpoint inserted at PC in
+   ASPACE, and all the breakpoint locations at PC are user breakpoints
+   whose conditions the target evaluates.  A target may then skip a
+   hit at PC if all the conditions it was given for PC are false.  */
+extern bool only_target_conditions_breakpoint_here_p
+  (const address_space *aspace, CORE_ADDR pc);
+
 /* Return non-zero iff there is a hardware breakpoint inserted at
    PC.  */
 extern int hardware_breakpoint_inserted_here_p (const address_space *,
@@ -1510,8 +1522,19 @@ extern void update_breakpoint_locations
    gdb::array_view<const symtab_and_line> sals,
    gdb::array_view<const symtab_and_line> sals_end);
 
+/* Re-set the locations of all the breakpoints of the current program
+   space.  */
+
 extern void breakpoint_re_set (void);
 
+/* Like breakpoint_re_set, but called when the only change since the
+   last re-set is that OBJFILES were added to the current program
+   space.  Only the breakpoints whose location specs may match in
+   these objfiles are re-set.  */
+
+extern void breakpoint_re_set_objfiles
+  (gdb::array_view<objfile *const> objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
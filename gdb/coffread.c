@@ -2151,6 +2151,8 @@ static const struct sym_fns coff_sym_fns =
   default_symfile_relocate,	/* sym_relocate: Relocate a debug
 				   section.  */
   NULL,				/* sym_probe_fns */
+  NULL,				/* sym_prefetch */
+  NULL,				/* sym_prefetch_release */
 };
 
 void _initialize_coffread ();
@@ -3234,6 +3234,8 @@ static const struct sym_fns aout_sym_fns =
   NULL,
   default_symfile_relocate,	/* Relocate a debug section.  */
   NULL,				/* sym_probe_fns */
+  NULL,				/* sym_prefetch */
+  NULL,				/* sym_prefetch_release */
 };
 
 void _initialize_dbxread ();
@@ -24,6 +24,7 @@
 #include "inferior.h"
 #include "splay-tree.h"
 #include "gdbarch.h"
+#include "gdbsupport/byte-vector.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -390,6 +391,74 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
   return db;
 }
 
+/* Fill the lines of DCACHE covering the LEN bytes at MEMADDR that are
+   not cached yet, with a single request to the target instead of one
+   request per line, if the target supports that.  Lines that can't be
+   read this way are left to dcache_read_line.  */
+
+static void
+dcache_read_lines (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len)
+{
+  ULONGEST n_lines = ((XFORM (dcache, memaddr) + len + dcache->line_size - 1)
+		      / dcache->line_size);
+
+  /* Don't let the lines read here evict each other.  */
+  n_lines = std::min (n_lines, (ULONGEST) dcache_size);
+
+  /* Group the missing lines into ranges of contiguous lines.  Only
+     consider lines entirely within a readable memory region; see
+     dcache_read_line.  */
+  std::vector<memory_read_range> ranges;
+  ULONGEST n_missing = 0;
+  bool extend_last = false;
+  CORE_ADDR line = MASK (dcache, memaddr);
+  for (ULONGEST i = 0; i < n_lines; i++, line += dcache->line_size)
+    {
+      struct mem_region *region = lookup_mem_region (line);
+
+      if (dcache_hit (dcache, line) != nullptr
+	  || region->attrib.mode == MEM_WO
+	  || (region->hi != 0 && line + dcache->line_size > region->hi))
+	{
+	  extend_last = false;
+	  continue;
+	}
+
+      if (extend_last)
+	ranges.back ().len += dcache->line_size;
+      else
+	ranges.push_back ({ line, (ULONGEST) dcache->line_size, nullptr });
+      extend_last = true;
+      n_missing++;
+    }
+
+  /* A single line is read as fast by dcache_read_line.  */
+  if (n_missing < 2)
+    return;
+
+  gdb::byte_vector data (n_missing * dcache->line_size);
+  gdb_byte *buf = data.data ();
+  for (memory_read_range &range : ranges)
+    {
+      range.buf = buf;
+      buf += range.len;
+    }
+
+  if (!target_read_memory_ranges (ranges))
+    return;
+
+  /* Cache the lines that were read entirely.  */
+  for (const memory_read_range &range : ranges)
+    for (ULONGEST offset = 0;
+	 offset + dcache->line_size <= range.xfered_len;
+	 offset += dcache->line_size)
+      {
+	struct dcache_block *db = dcache_alloc (dcache, range.addr + offset);
+
+	memcpy (db->data, range.buf + offset, dcache->line_size);
+      }
+}
+
 /* Using the data cache DCACHE, store in *PTR the contents of the byte at
    address ADDR in the remote machine.  
 
@@ -486,6 +555,11 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->proc_target = proc_target;
     }
 
+  /* Read all the lines that are missing at once, rather than one by
+     one as the loop below would.  */
+  if (XFORM (dcache, memaddr) + len > dcache->line_size)
+    dcache_read_lines (dcache, memaddr, len);
+
   for (i = 0; i < len; i++)
     {
       if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
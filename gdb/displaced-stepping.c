@@ -315,6 +315,16 @@ displaced_step_buffers::restore_in_ptid (ptid_t ptid)
     }
 }
 
+bool
+displaced_step_buffers::in_use () const
+{
+  for (const displaced_step_buffer &buffer : m_buffers)
+    if (buffer.current_thread != nullptr)
+      return true;
+
+  return false;
+}
+
 void _initialize_displaced_stepping ();
 void
 _initialize_displaced_stepping ()
@@ -175,6 +175,9 @@ struct displaced_step_buffers
 
   void restore_in_ptid (ptid_t ptid);
 
+  /* Return true if a thread is using one of the buffers.  */
+  bool in_use () const;
+
 private:
 
   /* State of a single buffer.  */
@@ -22,6 +22,7 @@
 #include "dwarf2/stringify.h"
 #include "dwarf2/index-cache.h"
 #include "cp-support.h"
+#include "gdb-demangle.h"
 #include "c-lang.h"
 #include "ada-lang.h"
 #include "event-top.h"
@@ -284,6 +285,28 @@ cooked_index_shard::add (sect_offset die_offset, enum dwarf_tag tag,
 
 /* See cooked-index.h.  */
 
+cooked_index_entry *
+cooked_index_shard::add_finalized (sect_offset die_offset,
+				   enum dwarf_tag tag,
+				   cooked_index_flag flags,
+				   enum language lang,
+				   const char *name,
+				   const char *canonical,
+				   dwarf2_per_cu_data *per_cu,
+				   bool visible)
+{
+  gdb_assert ((flags & IS_PARENT_DEFERRED) == 0);
+
+  cooked_index_entry *result = create (die_offset, tag, flags, lang, name,
+				       nullptr, per_cu);
+  result->canonical = canonical;
+  if (visible)
+    m_entries.push_back (result);
+  return result;
+}
+
+/* See cooked-index.h.  */
+
 gdb::unique_xmalloc_ptr<char>
 cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
 					       htab_t gnat_entries)
@@ -333,6 +356,11 @@ cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
 void
 cooked_index_shard::finalize (const parent_map_map *parent_maps)
 {
+  /* Nothing to do if the entries came from an already finalized
+     index.  */
+  if (m_finalized)
+    return;
+
   auto hash_name_ptr = [] (const void *p)
     {
       const cooked_index_entry *entry = (const cooked_index_entry *) p;
@@ -402,10 +430,22 @@ cooked_index_shard::finalize (const parent_map_map *parent_maps)
 					INSERT);
 	  if (*slot == nullptr)
 	    {
-	      gdb::unique_xmalloc_ptr<char> canon_name
-		= (entry->lang == language_cplus
-		   ? cp_canonicalize_string (entry->name)
-		   : c_canonicalize_name (entry->name));
+	      gdb::unique_xmalloc_ptr<char> canon_name;
+	      if (entry->lang == language_cplus)
+		{
+		  /* Template instances from common headers are found
+		     in many objfiles, so share the results.  */
+		  enum language lang = language_cplus;
+		  canon_name
+		    = demangle_cache_lookup
+			(demangle_cache_kind::CPLUS_CANONICAL, &lang,
+			 entry->name, [&] (enum language *)
+			   {
+			     return cp_canonicalize_string (entry->name);
+			   });
+		}
+	      else
+		canon_name = c_canonicalize_name (entry->name);
 	      if (canon_name == nullptr)
 		entry->canonical = entry->name;
 	      else
@@ -698,6 +738,32 @@ cooked_index::lookup (unrelocated_addr addr)
 
 /* See cooked-index.h.  */
 
+size_t
+cooked_index_shard::memory_used ()
+{
+  /* The entries and the address map are on the obstack.  */
+  size_t result = (obstack_memory_used (&m_storage)
+		   + m_entries.capacity () * sizeof (m_entries[0])
+		   + m_names.capacity () * sizeof (m_names[0]));
+  for (const auto &name : m_names)
+    result += strlen (name.get ()) + 1;
+  return result;
+}
+
+/* See cooked-index.h.  */
+
+size_t
+cooked_index::memory_used ()
+{
+  wait (cooked_state::FINALIZED, true);
+  size_t result = 0;
+  for (const auto &shard : m_vector)
+    result += shard->memory_used ();
+  return result;
+}
+
+/* See cooked-index.h.  */
+
 std::vector<const addrmap *>
 cooked_index::get_addrmaps ()
 {
@@ -303,12 +303,40 @@ class cooked_index_shard
     return { m_entries.cbegin (), m_entries.cend () };
   }
 
+  /* Return the number of bytes of memory used by this shard.  */
+  size_t memory_used ();
+
   /* Look up an entry by name.  Returns a range of all matching
      results.  If COMPLETING is true, then a larger range, suitable
      for completion, will be returned.  */
   range find (const std::string &name, bool completing) const;
 
-private:
+  /* Create an entry that is read back from an index that was already
+     finalized, e.g. one loaded from the index cache.  CANONICAL is
+     the canonical name of the entry.  The parent is set separately
+     using cooked_index_entry::set_parent.  If VISIBLE is true, the
+     entry is appended to the list of entries; callers must add
+     visible entries in sorted order.  Otherwise, the entry only
+     exists so that it can serve as the parent of other entries.  */
+  cooked_index_entry *add_finalized (sect_offset die_offset,
+				     enum dwarf_tag tag,
+				     cooked_index_flag flags,
+				     enum language lang,
+				     const char *name,
+				     const char *canonical,
+				     dwarf2_per_cu_data *per_cu,
+				     bool visible);
+
+  /* Mark this shard as finalized, so that 'finalize' will not touch
+     it.  This is used after all the entries were added using
+     add_finalized.  MAIN is the entry representing the program's
+     "main", or nullptr.  */
+  void set_finalized (cooked_index_entry *main)
+  {
+    m_main = main;
+    m_entries.shrink_to_fit ();
+    m_finalized = true;
+  }
 
   /* Return the entry that is believed to represent the program's
      "main".  This will return NULL if no such entry is available.  */
@@ -317,6 +345,14 @@ class cooked_index_shard
     return m_main;
   }
 
+  /* Return the address map of this shard.  */
+  const addrmap_fixed *get_addrmap () const
+  {
+    return m_addrmap;
+  }
+
+private:
+
   /* Look up ADDR in the address map, and return either the
      corresponding CU, or nullptr if the address could not be
      found.  */
@@ -366,6 +402,9 @@ class cooked_index_shard
   addrmap_fixed *m_addrmap = nullptr;
   /* Storage for canonical names.  */
   std::vector<gdb::unique_xmalloc_ptr<char>> m_names;
+  /* True if the entries were read back from an already finalized
+     index; see set_finalized.  */
+  bool m_finalized = false;
 };
 
 class cutu_reader;
@@ -511,8 +550,8 @@ class cooked_index_worker
   void set (cooked_state desired_state);
 
   /* Write to the index cache.  */
-  void write_to_cache (const cooked_index *idx,
-		       deferred_warnings *warn) const;
+  virtual void write_to_cache (const cooked_index *idx,
+			       deferred_warnings *warn) const;
 
   /* Helper function that does the work of reading.  This must be able
      to be run in a worker thread without problems.  */
@@ -677,6 +716,18 @@ class cooked_index : public dwarf_scanner_base
      held by this object.  */
   std::vector<const addrmap *> get_addrmaps ();
 
+  /* Return the number of bytes of memory used by the shards of this
+     index.  This waits for the index to be finalized.  */
+  size_t memory_used ();
+
+  /* Return the shards making up this index.  This waits for the
+     index to be finalized.  */
+  const vec_type &get_shards ()
+  {
+    wait (cooked_state::FINALIZED, true);
+    return m_vector;
+  }
+
   /* Return the entry that is believed to represent the program's
      "main".  This will return NULL if no such entry is available.  */
   const cooked_index_entry *get_main () const;
@@ -781,6 +832,37 @@ struct cooked_index_functions : public dwarf2_base_index_functions
     dwarf2_base_index_functions::expand_all_symtabs (objfile);
   }
 
+  size_t memory_used (struct objfile *objfile) override
+  {
+    return wait (objfile, true)->memory_used ();
+  }
+
+  bool map_symbol_names
+    (struct objfile *objfile,
+     gdb::function_view<void (const char *)> callback) override
+  {
+    cooked_index *index = wait (objfile, true);
+    for (const cooked_index_entry *entry : index->all_entries ())
+      {
+	callback (entry->name);
+	if (entry->canonical != entry->name)
+	  callback (entry->canonical);
+      }
+    return true;
+  }
+
+  bool expand_symtabs_for_source_line
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     int line,
+     gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+       override
+  {
+    wait (objfile, true);
+    return (dwarf2_base_index_functions::expand_symtabs_for_source_line
+	    (objfile, file_matcher, line, expansion_notify));
+  }
+
   bool expand_symtabs_matching
     (struct objfile *objfile,
      gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
@@ -41,6 +41,9 @@
 #include "dwarf2/loc.h"
 #include "dwarf2/frame-tailcall.h"
 #include "gdbsupport/gdb_binary_search.h"
+#include "gdbsupport/thread-pool.h"
+#include "gdb_bfd.h"
+#include "observable.h"
 #if GDB_SELF_TEST
 #include "gdbsupport/selftest.h"
 #include "selftest-arch.h"
@@ -169,6 +172,21 @@ struct comp_unit
   /* The FDE table.  */
   dwarf2_fde_table fde_table;
 
+  /* When the FDEs are found using the binary search table of the
+     .eh_frame_hdr section rather than FDE_TABLE, the contents and the
+     address of that section, where the table starts in it and its
+     number of entries.  */
+  gdb::byte_vector eh_frame_hdr;
+  bfd_vma eh_frame_hdr_vma = 0;
+  const gdb_byte *eh_frame_hdr_table = nullptr;
+  size_t eh_frame_hdr_count = 0;
+
+  /* The CIEs and FDEs of the .eh_frame section decoded so far for
+     lookups in the .eh_frame_hdr table, by offset in the section.  FDEs
+     that could not be decoded are recorded as nullptr.  */
+  dwarf2_cie_table eh_frame_cies;
+  std::unordered_map<ULONGEST, dwarf2_fde *> eh_frame_fdes;
+
   /* Hold data used by this module.  */
   auto_obstack obstack;
 };
@@ -1621,6 +1639,11 @@ set_comp_unit (struct objfile *objfile, struct comp_unit *unit)
   return dwarf2_frame_bfd_data.set (abfd, unit);
 }
 
+static comp_unit *get_comp_unit (struct objfile *objfile);
+static dwarf2_fde *find_fde_in_eh_frame_hdr (struct gdbarch *gdbarch,
+					     comp_unit *unit,
+					     unrelocated_addr seek_pc);
+
 /* Find the FDE for *PC.  Return a pointer to the FDE, and store the
    initial location associated with it into *PC.  */
 
@@ -1630,39 +1653,48 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, dwarf2_per_objfile **out_per_objfile)
   for (objfile *objfile : current_program_space->objfiles ())
     {
       CORE_ADDR offset;
+      dwarf2_fde *fde;
 
       if (objfile->obfd == nullptr)
 	continue;
 
-      comp_unit *unit = find_comp_unit (objfile);
-      if (unit == NULL)
+      comp_unit *unit = get_comp_unit (objfile);
+      gdb_assert (unit != NULL);
+
+      if (unit->eh_frame_hdr_count != 0)
 	{
-	  dwarf2_build_frame_info (objfile);
-	  unit = find_comp_unit (objfile);
+	  gdb_assert (!objfile->section_offsets.empty ());
+	  offset = objfile->text_section_offset ();
+
+	  unrelocated_addr seek_pc = (unrelocated_addr) (*pc - offset);
+	  fde = find_fde_in_eh_frame_hdr (objfile->arch (), unit, seek_pc);
 	}
-      gdb_assert (unit != NULL);
+      else
+	{
+	  dwarf2_fde_table *fde_table = &unit->fde_table;
+	  if (fde_table->empty ())
+	    continue;
 
-      dwarf2_fde_table *fde_table = &unit->fde_table;
-      if (fde_table->empty ())
-	continue;
+	  gdb_assert (!objfile->section_offsets.empty ());
+	  offset = objfile->text_section_offset ();
 
-      gdb_assert (!objfile->section_offsets.empty ());
-      offset = objfile->text_section_offset ();
+	  gdb_assert (!fde_table->empty ());
+	  unrelocated_addr seek_pc = (unrelocated_addr) (*pc - offset);
+	  if (seek_pc < (*fde_table)[0]->initial_location)
+	    continue;
 
-      gdb_assert (!fde_table->empty ());
-      unrelocated_addr seek_pc = (unrelocated_addr) (*pc - offset);
-      if (seek_pc < (*fde_table)[0]->initial_location)
-	continue;
+	  auto it = gdb::binary_search (fde_table->begin (), fde_table->end (),
+					seek_pc, bsearch_fde_cmp);
+	  fde = it != fde_table->end () ? *it : nullptr;
+	}
 
-      auto it = gdb::binary_search (fde_table->begin (), fde_table->end (),
-				    seek_pc, bsearch_fde_cmp);
-      if (it != fde_table->end ())
+      if (fde != nullptr)
 	{
-	  *pc = (CORE_ADDR) (*it)->initial_location + offset;
+	  *pc = (CORE_ADDR) fde->initial_location + offset;
 	  if (out_per_objfile != nullptr)
 	    *out_per_objfile = get_dwarf2_per_objfile (objfile);
 
-	  return *it;
+	  return fde;
 	}
     }
   return NULL;
@@ -2120,27 +2152,38 @@ fde_is_less_than (const dwarf2_fde *aa, const dwarf2_fde *bb)
   return aa->initial_location < bb->initial_location;
 }
 
-void
-dwarf2_build_frame_info (struct objfile *objfile)
+/* The sections the FDE table of an objfile is read from.  */
+
+struct dwarf2_frame_sections
 {
-  const gdb_byte *frame_ptr;
-  dwarf2_cie_table cie_table;
-  dwarf2_fde_table fde_table;
+  /* The .eh_frame section.  */
+  asection *eh_frame = nullptr;
+  const gdb_byte *eh_frame_buffer = nullptr;
+  bfd_size_type eh_frame_size = 0;
+
+  /* The .debug_frame section.  */
+  asection *debug_frame = nullptr;
+  const gdb_byte *debug_frame_buffer = nullptr;
+  bfd_size_type debug_frame_size = 0;
+};
 
-  struct gdbarch *gdbarch = objfile->arch ();
-
-  /* Build a minimal decoding of the DWARF2 compilation unit.  */
-  auto unit = std::make_unique<comp_unit> (objfile);
+/* Read the sections holding the call frame information of OBJFILE
+   into SECTIONS, and set the bases of the pointer encodings of UNIT.
+   This must be done in the main thread.  */
 
+static void
+read_frame_sections (struct objfile *objfile, comp_unit *unit,
+		     dwarf2_frame_sections *sections)
+{
   if (objfile->separate_debug_objfile_backlink == NULL)
     {
       /* Do not read .eh_frame from separate file as they must be also
 	 present in the main file.  */
       dwarf2_get_section_info (objfile, DWARF2_EH_FRAME,
-			       &unit->dwarf_frame_section,
-			       &unit->dwarf_frame_buffer,
-			       &unit->dwarf_frame_size);
-      if (unit->dwarf_frame_size)
+			       &sections->eh_frame,
+			       &sections->eh_frame_buffer,
+			       &sections->eh_frame_size);
+      if (sections->eh_frame_size)
 	{
 	  asection *got, *txt;
 
@@ -2157,34 +2200,58 @@ dwarf2_build_frame_info (struct objfile *objfile)
 	  txt = bfd_get_section_by_name (unit->abfd, ".text");
 	  if (txt)
 	    unit->tbase = txt->vma;
+	}
+    }
 
-	  try
-	    {
-	      frame_ptr = unit->dwarf_frame_buffer;
-	      while (frame_ptr < unit->dwarf_frame_buffer + unit->dwarf_frame_size)
-		frame_ptr = decode_frame_entry (gdbarch, unit.get (),
-						frame_ptr, 1,
-						cie_table, &fde_table,
-						EH_CIE_OR_FDE_TYPE_ID);
-	    }
+  dwarf2_get_section_info (objfile, DWARF2_DEBUG_FRAME,
+			   &sections->debug_frame,
+			   &sections->debug_frame_buffer,
+			   &sections->debug_frame_size);
+}
 
-	  catch (const gdb_exception_error &e)
-	    {
-	      warning (_("skipping .eh_frame info of %s: %s"),
-		       objfile_name (objfile), e.what ());
+/* Decode the CIEs and FDEs of SECTIONS into the sorted FDE table of
+   UNIT.  OBJFILE_NAME is the name of the objfile they come from, for
+   warnings.  This does not use the objfile, so that it can be done in
+   a worker thread.  */
 
-	      fde_table.clear ();
-	      /* The cie_table is discarded below.  */
-	    }
+static void
+build_fde_table (struct gdbarch *gdbarch, const char *objfile_name,
+		 const dwarf2_frame_sections &sections, comp_unit *unit)
+{
+  const gdb_byte *frame_ptr;
+  dwarf2_cie_table cie_table;
+  dwarf2_fde_table fde_table;
+
+  if (sections.eh_frame_size)
+    {
+      unit->dwarf_frame_section = sections.eh_frame;
+      unit->dwarf_frame_buffer = sections.eh_frame_buffer;
+      unit->dwarf_frame_size = sections.eh_frame_size;
 
-	  cie_table.clear ();
+      try
+	{
+	  frame_ptr = unit->dwarf_frame_buffer;
+	  while (frame_ptr < unit->dwarf_frame_buffer + unit->dwarf_frame_size)
+	    frame_ptr = decode_frame_entry (gdbarch, unit, frame_ptr, 1,
+					    cie_table, &fde_table,
+					    EH_CIE_OR_FDE_TYPE_ID);
 	}
+
+      catch (const gdb_exception_error &e)
+	{
+	  warning (_("skipping .eh_frame info of %s: %s"),
+		   objfile_name, e.what ());
+
+	  fde_table.clear ();
+	  /* The cie_table is discarded below.  */
+	}
+
+      cie_table.clear ();
     }
 
-  dwarf2_get_section_info (objfile, DWARF2_DEBUG_FRAME,
-			   &unit->dwarf_frame_section,
-			   &unit->dwarf_frame_buffer,
-			   &unit->dwarf_frame_size);
+  unit->dwarf_frame_section = sections.debug_frame;
+  unit->dwarf_frame_buffer = sections.debug_frame_buffer;
+  unit->dwarf_frame_size = sections.debug_frame_size;
   if (unit->dwarf_frame_size)
     {
       size_t num_old_fde_entries = fde_table.size ();
@@ -2193,14 +2260,14 @@ dwarf2_build_frame_info (struct objfile *objfile)
 	{
 	  frame_ptr = unit->dwarf_frame_buffer;
 	  while (frame_ptr < unit->dwarf_frame_buffer + unit->dwarf_frame_size)
-	    frame_ptr = decode_frame_entry (gdbarch, unit.get (), frame_ptr, 0,
+	    frame_ptr = decode_frame_entry (gdbarch, unit, frame_ptr, 0,
 					    cie_table, &fde_table,
 					    EH_CIE_OR_FDE_TYPE_ID);
 	}
       catch (const gdb_exception_error &e)
 	{
 	  warning (_("skipping .debug_frame info of %s: %s"),
-		   objfile_name (objfile), e.what ());
+		   objfile_name, e.what ());
 
 	  fde_table.resize (num_old_fde_entries);
 	}
@@ -2251,10 +2318,484 @@ dwarf2_build_frame_info (struct objfile *objfile)
       fde_prev = fde;
     }
   unit->fde_table.shrink_to_fit ();
+}
+
+void
+dwarf2_build_frame_info (struct objfile *objfile)
+{
+  dwarf2_frame_sections sections;
+
+  /* Build a minimal decoding of the DWARF2 compilation unit.  */
+  auto unit = std::make_unique<comp_unit> (objfile);
+
+  read_frame_sections (objfile, unit.get (), &sections);
+  build_fde_table (objfile->arch (), objfile_name (objfile), sections,
+		   unit.get ());
 
   set_comp_unit (objfile, unit.release ());
 }
 
+/* Return true if the FDEs of OBJFILE should be found using the binary
+   search table of its .eh_frame_hdr section.  The linker builds that
+   table, sorted by initial location, so the FDEs of .eh_frame can then
+   be decoded one at a time, as they are needed.  This is not possible
+   when the objfile also has a .debug_frame section, whose FDEs take
+   precedence.  */
+
+static bool
+can_use_eh_frame_hdr (struct objfile *objfile)
+{
+  bfd *abfd = objfile->obfd.get ();
+
+  if (objfile->separate_debug_objfile_backlink != nullptr
+      || gdb_bfd_requires_relocations (abfd))
+    return false;
+
+  asection *hdr = bfd_get_section_by_name (abfd, ".eh_frame_hdr");
+  if (hdr == nullptr
+      || (bfd_section_flags (hdr) & SEC_HAS_CONTENTS) == 0
+      || bfd_section_size (hdr) == 0)
+    return false;
+
+  return (bfd_get_section_by_name (abfd, ".debug_frame") == nullptr
+	  && bfd_get_section_by_name (abfd, ".zdebug_frame") == nullptr);
+}
+
+/* Return the byte order of the values in the sections of ABFD.  */
+
+static bfd_endian
+frame_bfd_byte_order (bfd *abfd)
+{
+  return bfd_big_endian (abfd) ? BFD_ENDIAN_BIG : BFD_ENDIAN_LITTLE;
+}
+
+/* Parse BUF, the SIZE bytes of an .eh_frame_hdr section at address
+   HDR_VMA, whose values are in BYTE_ORDER.  The section starts with a
+   version number, the encodings of the address of .eh_frame, of the
+   number of entries of the table and of these entries, followed by
+   the address and the number.  The table starts 12 bytes into the
+   section.  Only the encodings used by the linkers are handled: 4-byte
+   values, and table entries relative to the start of the section.
+
+   On success, store the address of the .eh_frame section the table
+   is about in *EH_FRAME_ADDR, and the number of entries of the table
+   in *COUNT, and return true.  Return false if the section can't be
+   used, including if the table is truncated or not sorted.  */
+
+static bool
+parse_eh_frame_hdr (const gdb_byte *buf, size_t size, bfd_vma hdr_vma,
+		    bfd_endian byte_order, bfd_vma *eh_frame_addr,
+		    size_t *count)
+{
+  if (size < 12
+      || buf[0] != 1
+      || ((buf[1] & 0x0f) != DW_EH_PE_udata4
+	  && (buf[1] & 0x0f) != DW_EH_PE_sdata4)
+      || buf[2] != DW_EH_PE_udata4
+      || buf[3] != (DW_EH_PE_datarel | DW_EH_PE_sdata4))
+    return false;
+
+  bfd_vma addr = ((buf[1] & 0x0f) == DW_EH_PE_sdata4
+		  ? extract_signed_integer (buf + 4, 4, byte_order)
+		  : extract_unsigned_integer (buf + 4, 4, byte_order));
+  if ((buf[1] & 0x70) == DW_EH_PE_pcrel)
+    addr += hdr_vma + 4;
+  else if ((buf[1] & 0x70) != DW_EH_PE_absptr)
+    return false;
+
+  size_t n = extract_unsigned_integer (buf + 8, 4, byte_order);
+  if (n == 0 || n > (size - 12) / 8)
+    return false;
+
+  /* Lookups are binary searches, which would find the wrong FDEs in
+     a table that isn't sorted by initial location.  */
+  const gdb_byte *table = buf + 12;
+  for (size_t i = 1; i < n; ++i)
+    if (extract_signed_integer (table + i * 8, 4, byte_order)
+	< extract_signed_integer (table + (i - 1) * 8, 4, byte_order))
+      return false;
+
+  *eh_frame_addr = addr;
+  *count = n;
+  return true;
+}
+
+/* Find the last of the COUNT entries of TABLE, the table of an
+   .eh_frame_hdr section at address HDR_VMA whose values are in
+   BYTE_ORDER, whose initial location is at or before SEEK_PC.  Return
+   the address of the FDE of that entry, or an empty optional if
+   SEEK_PC is before all the entries.  That FDE may still end before
+   SEEK_PC.  */
+
+static std::optional<bfd_vma>
+eh_frame_hdr_lookup (const gdb_byte *table, size_t count, bfd_vma hdr_vma,
+		     bfd_endian byte_order, unrelocated_addr seek_pc)
+{
+  /* Each entry of the table is a pair of offsets from the start of the
+     section: to the initial location of an FDE, and to the FDE.  */
+  auto initial_location = [&] (size_t i)
+    {
+      return (unrelocated_addr) (hdr_vma
+				 + extract_signed_integer (table + i * 8, 4,
+							   byte_order));
+    };
+
+  size_t low = 0;
+  size_t high = count;
+  while (low < high)
+    {
+      size_t mid = low + (high - low) / 2;
+
+      if (initial_location (mid) <= seek_pc)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+  if (low == 0)
+    return {};
+
+  return (hdr_vma
+	  + extract_signed_integer (table + (low - 1) * 8 + 4, 4,
+				    byte_order));
+}
+
+/* Set up UNIT to find the FDEs of OBJFILE using the .eh_frame_hdr
+   section.  Return false if that section can't be used.  */
+
+static bool
+read_eh_frame_hdr (struct objfile *objfile, comp_unit *unit)
+{
+  dwarf2_frame_sections sections;
+
+  read_frame_sections (objfile, unit, &sections);
+  if (sections.eh_frame_size == 0)
+    return false;
+
+  bfd *abfd = unit->abfd;
+  asection *hdr = bfd_get_section_by_name (abfd, ".eh_frame_hdr");
+  if (!gdb_bfd_get_full_section_contents (abfd, hdr, &unit->eh_frame_hdr))
+    return false;
+
+  const gdb_byte *buf = unit->eh_frame_hdr.data ();
+  bfd_vma hdr_vma = bfd_section_vma (hdr);
+  bfd_vma eh_frame_addr;
+  size_t count;
+  if (!parse_eh_frame_hdr (buf, unit->eh_frame_hdr.size (), hdr_vma,
+			   frame_bfd_byte_order (abfd), &eh_frame_addr,
+			   &count))
+    return false;
+
+  /* Check that the table is about the section we read.  */
+  if (eh_frame_addr != bfd_section_vma (sections.eh_frame))
+    return false;
+
+  unit->dwarf_frame_section = sections.eh_frame;
+  unit->dwarf_frame_buffer = sections.eh_frame_buffer;
+  unit->dwarf_frame_size = sections.eh_frame_size;
+  unit->eh_frame_hdr_vma = hdr_vma;
+  unit->eh_frame_hdr_table = buf + 12;
+  unit->eh_frame_hdr_count = count;
+  return true;
+}
+
+/* Find the FDE for SEEK_PC in the .eh_frame_hdr table of UNIT,
+   decoding it if this was not done yet.  */
+
+static dwarf2_fde *
+find_fde_in_eh_frame_hdr (struct gdbarch *gdbarch, comp_unit *unit,
+			  unrelocated_addr seek_pc)
+{
+  std::optional<bfd_vma> fde_addr
+    = eh_frame_hdr_lookup (unit->eh_frame_hdr_table, unit->eh_frame_hdr_count,
+			   unit->eh_frame_hdr_vma,
+			   frame_bfd_byte_order (unit->abfd), seek_pc);
+  if (!fde_addr.has_value ())
+    return nullptr;
+
+  ULONGEST fde_offset
+    = *fde_addr - bfd_section_vma (unit->dwarf_frame_section);
+  if (fde_offset >= unit->dwarf_frame_size)
+    return nullptr;
+
+  dwarf2_fde *fde;
+  auto iter = unit->eh_frame_fdes.find (fde_offset);
+  if (iter != unit->eh_frame_fdes.end ())
+    fde = iter->second;
+  else
+    {
+      dwarf2_fde_table fde_table;
+
+      try
+	{
+	  decode_frame_entry (gdbarch, unit,
+			      unit->dwarf_frame_buffer + fde_offset, 1,
+			      unit->eh_frame_cies, &fde_table,
+			      EH_FDE_TYPE_ID);
+	}
+      catch (const gdb_exception_error &e)
+	{
+	  complaint (_("Invalid FDE at offset %s of %s:%s: %s"),
+		     pulongest (fde_offset),
+		     bfd_get_filename (unit->abfd),
+		     bfd_section_name (unit->dwarf_frame_section),
+		     e.what ());
+	}
+
+      fde = fde_table.empty () ? nullptr : fde_table[0];
+      unit->eh_frame_fdes[fde_offset] = fde;
+    }
+
+  if (fde == nullptr || fde->end_addr () <= seek_pc)
+    return nullptr;
+  return fde;
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Unit test of parse_eh_frame_hdr and eh_frame_hdr_lookup.  */
+
+static void
+eh_frame_hdr_test ()
+{
+  for (bfd_endian byte_order : { BFD_ENDIAN_LITTLE, BFD_ENDIAN_BIG })
+    {
+      /* An .eh_frame_hdr section at 0x1000, for an .eh_frame section
+	 at 0x2000, whose table has three entries.  */
+      const bfd_vma hdr_vma = 0x1000;
+      const ULONGEST entries[3][2] = {
+	{ 0x100, 0x1000 }, { 0x200, 0x1020 }, { 0x300, 0x1040 },
+      };
+
+      gdb::byte_vector hdr (12 + sizeof (entries) / sizeof (ULONGEST) * 4);
+      hdr[0] = 1;
+      hdr[1] = DW_EH_PE_pcrel | DW_EH_PE_sdata4;
+      hdr[2] = DW_EH_PE_udata4;
+      hdr[3] = DW_EH_PE_datarel | DW_EH_PE_sdata4;
+      store_unsigned_integer (&hdr[4], 4, byte_order,
+			      0x2000 - (hdr_vma + 4));
+      store_unsigned_integer (&hdr[8], 4, byte_order, 3);
+      for (size_t i = 0; i < 3; ++i)
+	for (size_t j = 0; j < 2; ++j)
+	  store_unsigned_integer (&hdr[12 + i * 8 + j * 4], 4, byte_order,
+				  entries[i][j]);
+
+      bfd_vma eh_frame_addr = 0;
+      size_t count = 0;
+      SELF_CHECK (parse_eh_frame_hdr (hdr.data (), hdr.size (), hdr_vma,
+				      byte_order, &eh_frame_addr, &count));
+      SELF_CHECK (eh_frame_addr == 0x2000);
+      SELF_CHECK (count == 3);
+
+      auto lookup = [&] (CORE_ADDR pc)
+	{
+	  return eh_frame_hdr_lookup (hdr.data () + 12, count, hdr_vma,
+				      byte_order, (unrelocated_addr) pc);
+	};
+
+      /* A PC before the table has no entry.  */
+      SELF_CHECK (!lookup (0x10ff).has_value ());
+      SELF_CHECK (lookup (0x1100) == bfd_vma (0x2000));
+      SELF_CHECK (lookup (0x11ff) == bfd_vma (0x2000));
+      SELF_CHECK (lookup (0x1250) == bfd_vma (0x2020));
+      SELF_CHECK (lookup (0x1300) == bfd_vma (0x2040));
+      /* A PC after the table gets the last entry, whose FDE is then
+	 checked by the caller.  */
+      SELF_CHECK (lookup (0x9000) == bfd_vma (0x2040));
+
+      /* A table with more entries than the section holds.  */
+      SELF_CHECK (!parse_eh_frame_hdr (hdr.data (), hdr.size () - 1,
+				       hdr_vma, byte_order, &eh_frame_addr,
+				       &count));
+
+      /* An empty table.  */
+      gdb::byte_vector empty = hdr;
+      store_unsigned_integer (&empty[8], 4, byte_order, 0);
+      SELF_CHECK (!parse_eh_frame_hdr (empty.data (), empty.size (),
+				       hdr_vma, byte_order, &eh_frame_addr,
+				       &count));
+
+      /* An unknown version.  */
+      gdb::byte_vector version = hdr;
+      version[0] = 2;
+      SELF_CHECK (!parse_eh_frame_hdr (version.data (), version.size (),
+				       hdr_vma, byte_order, &eh_frame_addr,
+				       &count));
+
+      /* Unhandled encodings of the table entries.  */
+      gdb::byte_vector encoding = hdr;
+      encoding[3] = DW_EH_PE_datarel | DW_EH_PE_sdata8;
+      SELF_CHECK (!parse_eh_frame_hdr (encoding.data (), encoding.size (),
+				       hdr_vma, byte_order, &eh_frame_addr,
+				       &count));
+
+      /* A table that isn't sorted.  */
+      gdb::byte_vector unsorted = hdr;
+      store_unsigned_integer (&unsorted[12], 4, byte_order, 0x250);
+      SELF_CHECK (!parse_eh_frame_hdr (unsorted.data (), unsorted.size (),
+				       hdr_vma, byte_order, &eh_frame_addr,
+				       &count));
+    }
+}
+
+} // namespace selftests
+
+#endif /* GDB_SELF_TEST */
+
+/* The FDE table of an objfile being built by a worker thread.  */
+
+struct pending_fde_table
+{
+  ~pending_fde_table ()
+  {
+    task.wait ();
+  }
+
+  /* The unit whose FDE table is built.  */
+  std::unique_ptr<comp_unit> unit;
+
+  /* The sections the table is built from.  */
+  dwarf2_frame_sections sections;
+
+  /* The complaints and warnings issued while building it.  */
+  complaint_collection complaints;
+
+  /* The task building it.  */
+  gdb::future<void> task;
+};
+
+/* Like dwarf2_frame_bfd_data and dwarf2_frame_objfile_data, for the
+   FDE tables still being built.  */
+static const registry<bfd>::key<pending_fde_table> dwarf2_frame_bfd_pending;
+static const registry<objfile>::key<pending_fde_table>
+  dwarf2_frame_objfile_pending;
+
+/* Find the FDE table being built for OBJFILE, if any.  */
+
+static pending_fde_table *
+find_pending_fde_table (struct objfile *objfile)
+{
+  bfd *abfd = objfile->obfd.get ();
+  if (gdb_bfd_requires_relocations (abfd))
+    return dwarf2_frame_objfile_pending.get (objfile);
+
+  return dwarf2_frame_bfd_pending.get (abfd);
+}
+
+/* Store PENDING on OBJFILE, or the corresponding BFD, as
+   appropriate.  */
+
+static void
+set_pending_fde_table (struct objfile *objfile, pending_fde_table *pending)
+{
+  bfd *abfd = objfile->obfd.get ();
+  if (gdb_bfd_requires_relocations (abfd))
+    return dwarf2_frame_objfile_pending.set (objfile, pending);
+
+  return dwarf2_frame_bfd_pending.set (abfd, pending);
+}
+
+/* Discard the FDE table being built for OBJFILE, after waiting for
+   its task to complete.  */
+
+static void
+clear_pending_fde_table (struct objfile *objfile)
+{
+  bfd *abfd = objfile->obfd.get ();
+  if (gdb_bfd_requires_relocations (abfd))
+    dwarf2_frame_objfile_pending.clear (objfile);
+  else
+    dwarf2_frame_bfd_pending.clear (abfd);
+}
+
+/* Return the comp_unit of OBJFILE, waiting for its FDE table to be
+   built by a worker thread, or building it if that was not started.  */
+
+static comp_unit *
+get_comp_unit (struct objfile *objfile)
+{
+  comp_unit *unit = find_comp_unit (objfile);
+  if (unit != nullptr)
+    return unit;
+
+  pending_fde_table *pending = find_pending_fde_table (objfile);
+  if (pending != nullptr)
+    {
+      pending->task.wait ();
+      re_emit_complaints (pending->complaints);
+      unit = pending->unit.release ();
+      clear_pending_fde_table (objfile);
+      set_comp_unit (objfile, unit);
+      return unit;
+    }
+
+  if (can_use_eh_frame_hdr (objfile))
+    {
+      auto hdr_unit = std::make_unique<comp_unit> (objfile);
+      if (read_eh_frame_hdr (objfile, hdr_unit.get ()))
+	{
+	  unit = hdr_unit.release ();
+	  set_comp_unit (objfile, unit);
+	  return unit;
+	}
+    }
+
+  dwarf2_build_frame_info (objfile);
+  return find_comp_unit (objfile);
+}
+
+/* Start building the FDE table of a new OBJFILE in a worker thread, so
+   that the first unwind through it does not have to wait for all of
+   its call frame information to be decoded.  This is not needed when
+   the .eh_frame_hdr section can be used instead.  */
+
+static void
+dwarf2_frame_new_objfile (struct objfile *objfile)
+{
+  if (objfile->obfd == nullptr
+      || gdb::thread_pool::g_thread_pool->thread_count () == 0
+      || find_comp_unit (objfile) != nullptr
+      || find_pending_fde_table (objfile) != nullptr
+      || can_use_eh_frame_hdr (objfile))
+    return;
+
+  auto unit = std::make_unique<comp_unit> (objfile);
+  dwarf2_frame_sections sections;
+  read_frame_sections (objfile, unit.get (), &sections);
+  if (sections.eh_frame_size == 0 && sections.debug_frame_size == 0)
+    return;
+
+  pending_fde_table *pending = new pending_fde_table;
+  pending->unit = std::move (unit);
+  pending->sections = sections;
+
+  struct gdbarch *gdbarch = objfile->arch ();
+  std::string name = objfile_name (objfile);
+  pending->task = gdb::thread_pool::g_thread_pool->post_task ([=] ()
+    {
+      complaint_interceptor interceptor;
+
+      build_fde_table (gdbarch, name.c_str (), pending->sections,
+		       pending->unit.get ());
+      pending->complaints = interceptor.release ();
+
+      bfd_thread_cleanup ();
+    });
+
+  set_pending_fde_table (objfile, pending);
+}
+
+/* Wait for the FDE table of OBJFILE being built to be done before the
+   objfile and its sections are destroyed.  */
+
+static void
+dwarf2_frame_free_objfile (struct objfile *objfile)
+{
+  if (objfile->obfd != nullptr && find_pending_fde_table (objfile) != nullptr)
+    clear_pending_fde_table (objfile);
+}
+
 /* Handle 'maintenance show dwarf unwinders'.  */
 
 static void
@@ -2283,8 +2824,14 @@ architecture that doesn't support them will have no effect."),
 			   &set_dwarf_cmdlist,
 			   &show_dwarf_cmdlist);
 
+  gdb::observers::new_objfile.attach (dwarf2_frame_new_objfile,
+				      "dwarf2-frame");
+  gdb::observers::free_objfile.attach (dwarf2_frame_free_objfile,
+				       "dwarf2-frame");
+
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
 					 selftests::execute_cfa_program_test);
+  selftests::register_test ("eh_frame_hdr", selftests::eh_frame_hdr_test);
 #endif
 }
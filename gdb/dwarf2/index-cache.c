@@ -34,12 +34,8 @@
 #include <stdlib.h>
 #include "run-on-main-thread.h"
 
-/* When set to true, show debug messages about the index cache.  */
-static bool debug_index_cache = false;
-
-#define index_cache_debug(FMT, ...)					       \
-  debug_prefixed_printf_cond_nofunc (debug_index_cache, "index-cache", \
-				     FMT, ## __VA_ARGS__)
+/* See dwarf-index-cache.h.  */
+bool debug_index_cache = false;
 
 /* The index cache directory, used for "set/show index-cache directory".  */
 static std::string index_cache_directory;
@@ -174,9 +170,8 @@ index_cache_store_context::store () const
 
       /* Write the index itself to the directory, using the build id as the
 	 filename.  */
-      write_dwarf_index (m_per_bfd, m_dir.c_str (),
-			 m_build_id_str.c_str (), dwz_build_id_ptr,
-			 dw_index_kind::GDB_INDEX);
+      write_cooked_index_cache (m_per_bfd, m_dir.c_str (),
+				m_build_id_str.c_str (), dwz_build_id_ptr);
     }
   catch (const gdb_exception_error &except)
     {
@@ -203,8 +198,8 @@ struct index_cache_resource_mmap final : public index_cache_resource
 /* See dwarf-index-cache.h.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource)
 {
   if (!enabled ())
     return {};
@@ -216,8 +211,9 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       return {};
     }
 
-  /* Compute where we would expect a gdb index file for this build id to be.  */
-  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+  /* Compute where we would expect an index file for this build id to
+     be.  */
+  std::string filename = make_index_filename (build_id, suffix);
 
   try
     {
@@ -231,6 +227,9 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       /* Yay, it worked!  Hand the resource to the caller.  */
       resource->reset (mmap_resource);
 
+      m_n_files_mapped++;
+      m_n_bytes_mapped += mmap_resource->mapping.size ();
+
       return gdb::array_view<const gdb_byte>
 	  ((const gdb_byte *) mmap_resource->mapping.get (),
 	   mmap_resource->mapping.size ());
@@ -244,10 +243,38 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
   return {};
 }
 
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup (build_id, INDEX4_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_cooked_index
+  (const bfd_build_id *build_id,
+   std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup (build_id, INDEX_CACHE_SUFFIX, resource);
+}
+
 #else /* !HAVE_SYS_MMAN_H */
 
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
+gdb::array_view<const gdb_byte>
+index_cache::lookup (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource)
+{
+  return {};
+}
+
+/* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
+
 gdb::array_view<const gdb_byte>
 index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 			       std::unique_ptr<index_cache_resource> *resource)
@@ -255,6 +282,16 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
   return {};
 }
 
+/* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_cooked_index
+  (const bfd_build_id *build_id,
+   std::unique_ptr<index_cache_resource> *resource)
+{
+  return {};
+}
+
 #endif
 
 /* See dwarf-index-cache.h.  */
@@ -349,6 +386,25 @@ show_index_cache_stats_command (const char *arg, int from_tty)
 	      indent, global_index_cache.n_misses ());
 }
 
+/* "maintenance info index-cache" handler.  */
+
+static void
+maintenance_info_index_cache_command (const char *arg, int from_tty)
+{
+  gdb_printf (_("Index cache directory: %s\n"),
+	      index_cache_directory.c_str ());
+  gdb_printf (_("Index cache enabled: %s\n"),
+	      global_index_cache.enabled () ? "yes" : "no");
+  gdb_printf (_("Cache hits (this session): %u\n"),
+	      global_index_cache.n_hits ());
+  gdb_printf (_("Cache misses (this session): %u\n"),
+	      global_index_cache.n_misses ());
+  gdb_printf (_("Files mapped (this session): %u\n"),
+	      global_index_cache.n_files_mapped ());
+  gdb_printf (_("Bytes mapped (this session): %s\n"),
+	      pulongest (global_index_cache.n_bytes_mapped ()));
+}
+
 void _initialize_index_cache ();
 void
 _initialize_index_cache ()
@@ -414,6 +470,16 @@ _initialize_index_cache ()
 	   _("Show some stats about the index cache."),
 	   &show_index_cache_prefix_list);
 
+  /* maintenance info index-cache */
+  add_cmd ("index-cache", class_maintenance,
+	   maintenance_info_index_cache_command,
+	   _("\
+Show statistics about the index cache.\n\
+This prints the number of cache hits and misses, as well as the number\n\
+and total size of the index files mapped from the cache during this\n\
+session."),
+	   &maintenanceinfolist);
+
   /* set debug index-cache */
   add_setshow_boolean_cmd ("index-cache", class_maintenance,
 			   &debug_index_cache,
@@ -27,6 +27,133 @@
 class dwarf2_per_bfd;
 class index_cache;
 
+/* When set to true, show debug messages about the index cache.  */
+extern bool debug_index_cache;
+
+#define index_cache_debug(FMT, ...)					       \
+  debug_prefixed_printf_cond_nofunc (debug_index_cache, "index-cache", \
+				     FMT, ## __VA_ARGS__)
+
+/* The suffix of index cache files holding a cooked index in GDB's
+   native format.  */
+#define INDEX_CACHE_SUFFIX ".gdb-cooked-index"
+
+/* The native index cache format.
+
+   A file in this format holds a serialized cooked_index: all the
+   entries of all the shards, including their canonical names and
+   parent links, the address maps, and a table describing the units
+   the entries refer to.  The file starts with an
+   index_cache_file_header, followed by the tables it describes.  All
+   the tables are arrays of fixed-size records stored in host byte
+   order and 8-byte aligned, so that a mapped file can be used in
+   place, without any decoding.  The file is only ever read back by
+   the same host that wrote it; the magic, the version and the
+   byte-order marker are checked before anything else is used.
+
+   Strings (names, canonical names and build IDs) are stored in a
+   single table of NUL-terminated strings, and referenced by their
+   offset in that table.  */
+
+#define INDEX_CACHE_MAGIC "GDBCIDX"
+
+/* The version of the native format.  Bump this whenever the layout of
+   any of the records below, or the meaning of a field, changes.  */
+#define INDEX_CACHE_VERSION 1
+
+/* The value stored in index_cache_file_header::byte_order.  */
+#define INDEX_CACHE_BYTE_ORDER 0x01020304
+
+/* A value denoting "no string" or "no entry".  */
+#define INDEX_CACHE_NONE ((uint64_t) -1)
+
+struct index_cache_file_header
+{
+  /* INDEX_CACHE_MAGIC, including the terminating NUL.  */
+  char magic[8];
+  /* INDEX_CACHE_VERSION.  */
+  uint32_t version;
+  /* INDEX_CACHE_BYTE_ORDER, as stored by the writer.  */
+  uint32_t byte_order;
+  /* Offsets in the string table of the build ID of the objfile and of
+     its dwz file, both in hex.  The latter is INDEX_CACHE_NONE if
+     there is no dwz file.  */
+  uint64_t build_id;
+  uint64_t dwz_build_id;
+  /* The table of index_cache_unit records.  */
+  uint64_t units_offset;
+  uint64_t n_units;
+  /* The table of index_cache_shard records.  */
+  uint64_t shards_offset;
+  uint64_t n_shards;
+  /* The table of index_cache_entry records.  */
+  uint64_t entries_offset;
+  uint64_t n_entries;
+  /* The table of index_cache_addrmap records.  */
+  uint64_t addrmap_offset;
+  uint64_t n_addrmap;
+  /* The string table.  */
+  uint64_t strings_offset;
+  uint64_t strings_size;
+};
+
+/* A unit, as found in dwarf2_per_bfd::all_units.  This is used to
+   verify that the units created when reading the objfile match the
+   ones the entries were created for.  */
+
+struct index_cache_unit
+{
+  uint64_t sect_off;
+  uint32_t length;
+  uint8_t is_dwz;
+  uint8_t is_debug_types;
+  uint16_t padding;
+};
+
+/* A shard of the index.  Each shard owns a range of entries, in the
+   sorted order used for lookups, and a range of address map
+   records.  */
+
+struct index_cache_shard
+{
+  uint64_t first_entry;
+  uint64_t n_entries;
+  uint64_t first_addrmap;
+  uint64_t n_addrmap;
+  /* The index of the shard's "main" entry, or INDEX_CACHE_NONE.  */
+  uint64_t main_entry;
+};
+
+/* A single cooked_index_entry.  The entries owned by the shards come
+   first; any entries after those are only referenced as parents (for
+   instance the synthesized Ada package entries).  */
+
+struct index_cache_entry
+{
+  /* Offsets in the string table.  */
+  uint64_t name;
+  uint64_t canonical;
+  uint64_t die_offset;
+  /* The index of the parent entry, or INDEX_CACHE_NONE.  */
+  uint64_t parent;
+  /* The index of the unit in dwarf2_per_bfd::all_units.  */
+  uint32_t unit;
+  uint16_t tag;
+  uint8_t flags;
+  uint8_t lang;
+};
+
+/* A transition in a shard's address map: all the addresses starting
+   at START, up to the start of the next record, map to UNIT, an index
+   in dwarf2_per_bfd::all_units, or to nothing if UNIT is
+   INDEX_CACHE_NONE.  */
+
+struct index_cache_addrmap
+{
+  uint64_t start;
+  uint64_t unit;
+};
+
 /* Base of the classes used to hold the resources of the indices loaded from
    the cache (e.g. mmapped files).  */
 
@@ -93,6 +220,12 @@ class index_cache
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Same as lookup_gdb_index, but look for a file holding a cooked
+     index in the native format (see index_cache_file_header).  */
+  gdb::array_view<const gdb_byte>
+  lookup_cooked_index (const bfd_build_id *build_id,
+		       std::unique_ptr<index_cache_resource> *resource);
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -115,8 +248,23 @@ class index_cache
       m_n_misses++;
   }
 
+  /* Return the number of index files mapped from the cache.  */
+  unsigned int n_files_mapped () const
+  { return m_n_files_mapped; }
+
+  /* Return the total size of the index files mapped from the
+     cache.  */
+  ULONGEST n_bytes_mapped () const
+  { return m_n_bytes_mapped; }
+
 private:
 
+  /* Worker for the lookup methods.  Look for the index file of
+     BUILD_ID with the given SUFFIX.  */
+  gdb::array_view<const gdb_byte>
+  lookup (const bfd_build_id *build_id, const char *suffix,
+	  std::unique_ptr<index_cache_resource> *resource);
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
@@ -132,6 +280,11 @@ class index_cache
   /* Number of cache hits and misses during this GDB session.  */
   unsigned int m_n_hits = 0;
   unsigned int m_n_misses = 0;
+
+  /* Number and total size of the files mapped during this GDB
+     session.  */
+  unsigned int m_n_files_mapped = 0;
+  ULONGEST m_n_bytes_mapped = 0;
 };
 
 /* The global instance of the index cache.  */
@@ -29,6 +29,7 @@
 #include "gdbsupport/scoped_fd.h"
 #include "complaints.h"
 #include "dwarf2/index-common.h"
+#include "dwarf2/index-cache.h"
 #include "dwarf2/cooked-index.h"
 #include "dwarf2.h"
 #include "dwarf2/read.h"
@@ -1582,6 +1583,158 @@ write_dwarf_index (dwarf2_per_bfd *per_bfd, const char *dir,
     dwz_index_wip->finalize ();
 }
 
+/* See dwarf-index-write.h.  */
+
+void
+write_cooked_index_cache (dwarf2_per_bfd *per_bfd, const char *dir,
+			  const char *basename, const char *dwz_basename)
+{
+  if (per_bfd->index_table == nullptr)
+    error (_("No debugging symbols"));
+  cooked_index *table = per_bfd->index_table->index_for_writing ();
+  if (table == nullptr)
+    error (_("Cannot use an index to create the index"));
+
+  static_assert (sizeof (index_cache_file_header) % 8 == 0);
+  static_assert (sizeof (index_cache_unit) % 8 == 0);
+  static_assert (sizeof (index_cache_shard) % 8 == 0);
+  static_assert (sizeof (index_cache_entry) % 8 == 0);
+  static_assert (sizeof (index_cache_addrmap) % 8 == 0);
+
+  /* The string table.  Names usually point into .debug_str and are
+     shared by many entries, so each distinct pointer is only written
+     once.  */
+  data_buf strings;
+  std::unordered_map<const char *, uint64_t> string_offsets;
+  auto add_string = [&] (const char *str) -> uint64_t
+    {
+      auto [iter, inserted] = string_offsets.emplace (str, strings.size ());
+      if (inserted)
+	strings.append_cstr0 (str);
+      return iter->second;
+    };
+
+  index_cache_file_header header {};
+  memcpy (header.magic, INDEX_CACHE_MAGIC, sizeof (header.magic));
+  header.version = INDEX_CACHE_VERSION;
+  header.byte_order = INDEX_CACHE_BYTE_ORDER;
+  header.build_id = add_string (basename);
+  header.dwz_build_id = (dwz_basename == nullptr
+			 ? INDEX_CACHE_NONE
+			 : add_string (dwz_basename));
+
+  std::vector<index_cache_unit> units;
+  units.reserve (per_bfd->all_units.size ());
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      index_cache_unit unit {};
+      unit.sect_off = to_underlying (per_cu->sect_off);
+      unit.length = per_cu->length ();
+      unit.is_dwz = per_cu->is_dwz;
+      unit.is_debug_types = per_cu->is_debug_types;
+      units.push_back (unit);
+    }
+
+  /* Assign an index to each entry.  The entries held by the shards
+     come first, in their sorted order.  Parents that are not held by
+     any shard are appended afterward.  */
+  std::vector<const cooked_index_entry *> all_entries;
+  std::unordered_map<const cooked_index_entry *, uint64_t> entry_indices;
+  std::vector<index_cache_shard> shards;
+  std::vector<index_cache_addrmap> addrmap;
+  for (const auto &shard : table->get_shards ())
+    {
+      index_cache_shard shard_rec {};
+      shard_rec.first_entry = all_entries.size ();
+      shard_rec.main_entry = INDEX_CACHE_NONE;
+      for (const cooked_index_entry *entry : shard->all_entries ())
+	{
+	  if (entry == shard->get_main ())
+	    shard_rec.main_entry = all_entries.size ();
+	  entry_indices.emplace (entry, all_entries.size ());
+	  all_entries.push_back (entry);
+	}
+      shard_rec.n_entries = all_entries.size () - shard_rec.first_entry;
+
+      shard_rec.first_addrmap = addrmap.size ();
+      if (shard->get_addrmap () != nullptr)
+	shard->get_addrmap ()->foreach ([&] (CORE_ADDR start,
+					     const void *obj)
+	  {
+	    const dwarf2_per_cu_data *per_cu
+	      = static_cast<const dwarf2_per_cu_data *> (obj);
+	    addrmap.push_back ({ start, (per_cu == nullptr
+					 ? INDEX_CACHE_NONE
+					 : per_cu->index) });
+	    return 0;
+	  });
+      shard_rec.n_addrmap = addrmap.size () - shard_rec.first_addrmap;
+
+      shards.push_back (shard_rec);
+    }
+
+  std::vector<index_cache_entry> entries;
+  entries.reserve (all_entries.size ());
+  /* ALL_ENTRIES may grow while iterating, so use an index here.  */
+  for (size_t i = 0; i < all_entries.size (); ++i)
+    {
+      const cooked_index_entry *entry = all_entries[i];
+      gdb_assert (entry->per_cu->index < per_bfd->all_units.size ());
+
+      index_cache_entry rec {};
+      rec.name = add_string (entry->name);
+      rec.canonical = add_string (entry->canonical);
+      rec.die_offset = to_underlying (entry->die_offset);
+      rec.parent = INDEX_CACHE_NONE;
+      rec.unit = entry->per_cu->index;
+      rec.tag = entry->tag;
+      rec.flags = entry->flags;
+      rec.lang = entry->lang;
+
+      const cooked_index_entry *parent = entry->get_parent ();
+      if (parent != nullptr)
+	{
+	  auto [iter, inserted]
+	    = entry_indices.emplace (parent, all_entries.size ());
+	  if (inserted)
+	    all_entries.push_back (parent);
+	  rec.parent = iter->second;
+	}
+
+      entries.push_back (rec);
+    }
+
+  /* Lay out the tables.  All the records have a size that is a
+     multiple of 8, so every table is suitably aligned.  */
+  uint64_t offset = sizeof (header);
+  header.units_offset = offset;
+  header.n_units = units.size ();
+  offset += units.size () * sizeof (index_cache_unit);
+  header.shards_offset = offset;
+  header.n_shards = shards.size ();
+  offset += shards.size () * sizeof (index_cache_shard);
+  header.entries_offset = offset;
+  header.n_entries = entries.size ();
+  offset += entries.size () * sizeof (index_cache_entry);
+  header.addrmap_offset = offset;
+  header.n_addrmap = addrmap.size ();
+  offset += addrmap.size () * sizeof (index_cache_addrmap);
+  header.strings_offset = offset;
+  header.strings_size = strings.size ();
+
+  index_wip_file wip_file (dir, basename, INDEX_CACHE_SUFFIX);
+  FILE *out_file = wip_file.out_file.get ();
+
+  ::file_write (out_file, &header, sizeof (header));
+  ::file_write (out_file, units);
+  ::file_write (out_file, shards);
+  ::file_write (out_file, entries);
+  ::file_write (out_file, addrmap);
+  strings.file_write (out_file);
+
+  wip_file.finalize ();
+}
+
 /* Options structure for the 'save gdb-index' command.  */
 
 struct save_gdb_index_options
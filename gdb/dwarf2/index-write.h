@@ -36,4 +36,16 @@ extern void write_dwarf_index
   (dwarf2_per_bfd *per_bfd, const char *dir, const char *basename,
    const char *dwz_basename, dw_index_kind index_kind);
 
+/* Write the cooked index of PER_BFD to the directory DIR, in the
+   native format used by the index cache (see index-cache.h).
+
+   BASENAME is the build ID of OBJFILE, in hex, and is used as the base
+   name of the file.  DWZ_BASENAME is the build ID of the dwz file, if
+   there is one, or NULL otherwise.  Both are recorded in the file so
+   that the index can be validated when it is loaded.  */
+
+extern void write_cooked_index_cache
+  (dwarf2_per_bfd *per_bfd, const char *dir, const char *basename,
+   const char *dwz_basename);
+
 #endif /* DWARF_INDEX_WRITE_H */
@@ -27,6 +27,8 @@
 #include "mapped-index.h"
 #include "read.h"
 #include "stringify.h"
+#include "gdbsupport/task-group.h"
+#include "gdbsupport/thread-pool.h"
 
 /* This is just like cooked_index_functions, but overrides a single
    method so the test suite can distinguish the .debug_names case from
@@ -62,12 +64,23 @@ class debug_names_index : public cooked_index
 
 struct mapped_debug_names_reader
 {
-  const gdb_byte *scan_one_entry (const char *name,
+  /* A list of entries whose parent still has to be set, along with
+     the (1-based) index of the name of the parent.  */
+  using needs_parent_list
+    = std::vector<std::pair<cooked_index_entry *, ULONGEST>>;
+
+  const gdb_byte *scan_one_entry (cooked_index_shard *shard,
+				  const char *name,
 				  const gdb_byte *entry,
 				  cooked_index_entry **result,
 				  std::optional<ULONGEST> &parent);
-  void scan_entries (uint32_t index, const char *name, const gdb_byte *entry);
-  void scan_all_names ();
+  void scan_entries (cooked_index_shard *shard,
+		     needs_parent_list &needs_parent,
+		     uint32_t index, const char *name, const gdb_byte *entry);
+  void scan_names (cooked_index_shard *shard,
+		   needs_parent_list &needs_parent,
+		   uint32_t first, uint32_t last);
+  void set_parents (const needs_parent_list &needs_parent);
 
   dwarf2_per_objfile *per_objfile = nullptr;
   bfd *abfd = nullptr;
@@ -104,8 +117,10 @@ struct mapped_debug_names_reader
 
   std::unordered_map<ULONGEST, index_val> abbrev_map;
 
+  /* The shard holding the address map read from .debug_aranges.  The
+     entries of the first part of the name table are added to it.  */
   std::unique_ptr<cooked_index_shard> shard;
-  std::vector<std::pair<cooked_index_entry *, ULONGEST>> needs_parent;
+  /* The entries created for each name of the name table.  */
   std::vector<std::vector<cooked_index_entry *>> all_entries;
 };
 
@@ -114,7 +129,8 @@ struct mapped_debug_names_reader
    nullptr on error, or at the end of the table.  */
 
 const gdb_byte *
-mapped_debug_names_reader::scan_one_entry (const char *name,
+mapped_debug_names_reader::scan_one_entry (cooked_index_shard *shard,
+					   const char *name,
 					   const gdb_byte *entry,
 					   cooked_index_entry **result,
 					   std::optional<ULONGEST> &parent)
@@ -243,20 +259,23 @@ mapped_debug_names_reader::scan_one_entry (const char *name,
   return entry;
 }
 
-/* Scan all the entries for NAME, at name slot INDEX.  */
+/* Scan all the entries for NAME, at name slot INDEX, adding them to
+   SHARD.  Entries that have a parent are added to NEEDS_PARENT.  */
 
 void
-mapped_debug_names_reader::scan_entries (uint32_t index,
+mapped_debug_names_reader::scan_entries (cooked_index_shard *shard,
+					 needs_parent_list &needs_parent,
+					 uint32_t index,
 					 const char *name,
 					 const gdb_byte *entry)
 {
   std::vector<cooked_index_entry *> these_entries;
-  
+
   while (true)
     {
       std::optional<ULONGEST> parent;
       cooked_index_entry *this_entry;
-      entry = scan_one_entry (name, entry, &this_entry, parent);
+      entry = scan_one_entry (shard, name, entry, &this_entry, parent);
 
       if (entry == nullptr)
 	break;
@@ -269,15 +288,16 @@ mapped_debug_names_reader::scan_entries (uint32_t index,
   all_entries[index] = std::move (these_entries);
 }
 
-/* Scan the name table and create all the entries.  */
+/* Scan the names of the name table in the range [FIRST, LAST) and
+   create their entries in SHARD.  This can be called from several
+   worker threads at once, for distinct ranges and shards.  */
 
 void
-mapped_debug_names_reader::scan_all_names ()
+mapped_debug_names_reader::scan_names (cooked_index_shard *shard,
+				       needs_parent_list &needs_parent,
+				       uint32_t first, uint32_t last)
 {
-  all_entries.resize (name_count);
-
-  /* In the first pass, create all the entries.  */
-  for (uint32_t i = 0; i < name_count; ++i)
+  for (uint32_t i = first; i < last; ++i)
     {
       const ULONGEST namei_string_offs
 	= extract_unsigned_integer ((name_table_string_offs_reordered
@@ -292,12 +312,18 @@ mapped_debug_names_reader::scan_all_names ()
 				    offset_size, dwarf5_byte_order);
       const gdb_byte *entry = entry_pool + namei_entry_offs;
 
-      scan_entries (i, name, entry);
+      scan_entries (shard, needs_parent, i, name, entry);
     }
+}
 
-  /* Now update the parent pointers for all entries.  This has to be
-     done in a funny way because DWARF specifies the parent entry to
-     point to a name -- but we don't know which specific one.  */
+/* Update the parent pointers of the entries in NEEDS_PARENT.  This
+   can only be done once all the names were scanned, and has to be
+   done in a funny way because DWARF specifies the parent entry to
+   point to a name -- but we don't know which specific one.  */
+
+void
+mapped_debug_names_reader::set_parents (const needs_parent_list &needs_parent)
+{
   for (auto [entry, parent_idx] : needs_parent)
     {
       /* Name entries are indexed from 1 in DWARF.  */
@@ -311,7 +337,9 @@ mapped_debug_names_reader::scan_all_names ()
     }
 }
 
-/* A reader for .debug_names.  */
+/* A reader for .debug_names.  The name table is split into ranges of
+   names that are scanned in parallel, each into its own index shard,
+   like the units of .debug_info are by cooked_index_debug_info.  */
 
 struct cooked_index_debug_names : public cooked_index_worker
 {
@@ -323,40 +351,132 @@ struct cooked_index_debug_names : public cooked_index_worker
 
   void do_reading () override;
 
+private:
+
+  /* Scan the names in the range [FIRST, LAST) of the name table.
+     This is called in a worker thread.  TASK_NUMBER is the index of
+     the results of this task in M_RESULTS.  */
+  void process_names (size_t task_number, uint32_t first, uint32_t last);
+
+  /* Called when all the names have been scanned.  */
+  void done_reading ();
+
   mapped_debug_names_reader m_map;
+
+  /* The entries that still need a parent, for each task.  */
+  std::vector<mapped_debug_names_reader::needs_parent_list> m_needs_parent;
 };
 
+/* The minimum number of names of the name table scanned by a single
+   task.  Small tables are not worth splitting.  */
+
+static constexpr uint32_t min_names_per_task = 4096;
+
 void
-cooked_index_debug_names::do_reading ()
+cooked_index_debug_names::process_names (size_t task_number,
+					 uint32_t first, uint32_t last)
 {
+  SCOPE_EXIT { bfd_thread_cleanup (); };
+
+  /* Ensure that complaints are handled correctly.  */
   complaint_interceptor complaint_handler;
+
+  std::unique_ptr<cooked_index_shard> shard;
+  if (task_number == 0)
+    shard = std::move (m_map.shard);
+  else
+    {
+      /* Only the first shard maps addresses to units, but all the
+	 shards need an address map.  */
+      addrmap_mutable addrmap;
+      shard = std::make_unique<cooked_index_shard> ();
+      shard->install_addrmap (&addrmap);
+    }
+
   std::vector<gdb_exception> exceptions;
   try
     {
-      m_map.scan_all_names ();
+      m_map.scan_names (shard.get (), m_needs_parent[task_number],
+			first, last);
     }
-  catch (const gdb_exception &exc)
+  catch (gdb_exception &exc)
     {
       exceptions.push_back (std::move (exc));
     }
 
-  dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
-  per_bfd->quick_file_names_table
-    = create_quick_file_names_table (per_bfd->all_units.size ());
-  m_results.emplace_back (nullptr,
-			  complaint_handler.release (),
-			  std::move (exceptions),
-			  parent_map ());
+  m_results[task_number] = result_type (std::move (shard),
+					complaint_handler.release (),
+					std::move (exceptions),
+					parent_map ());
+}
+
+void
+cooked_index_debug_names::done_reading ()
+{
+  /* All the entries exist now, so their parents can be found.  */
+  for (const auto &needs_parent : m_needs_parent)
+    m_map.set_parents (needs_parent);
+
+  /* Complaints and exceptions are only handled on the main thread,
+     take just the shards from the results.  */
   std::vector<std::unique_ptr<cooked_index_shard>> indexes;
-  indexes.push_back (std::move (m_map.shard));
+  for (auto &one_result : m_results)
+    indexes.push_back (std::move (std::get<0> (one_result)));
+
+  dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
   cooked_index *table
     = (gdb::checked_static_cast<cooked_index *>
        (per_bfd->index_table.get ()));
   /* Note that this code never uses IS_PARENT_DEFERRED, so it is safe
      to pass nullptr here.  */
   table->set_contents (std::move (indexes), &m_warnings, nullptr);
+}
+
+void
+cooked_index_debug_names::do_reading ()
+{
+  dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
+  per_bfd->quick_file_names_table
+    = create_quick_file_names_table (per_bfd->all_units.size ());
+
+  m_map.all_entries.resize (m_map.name_count);
+
+  /* How many worker threads we plan to use.  As in
+     cooked_index_debug_info::do_reading, use 1 as the minimum; in the
+     N==0 case the work is done synchronously.  */
+  const size_t n_worker_threads
+    = std::max (gdb::thread_pool::g_thread_pool->thread_count (), (size_t) 1);
+  const size_t n_tasks
+    = std::clamp ((size_t) (m_map.name_count / min_names_per_task),
+		  (size_t) 1, n_worker_threads);
+
+  /* The names are sorted by hash bucket, so each task gets a
+     contiguous range of buckets.  */
+  const uint32_t names_per_task = m_map.name_count / n_tasks;
+
+  m_results.resize (n_tasks);
+  m_needs_parent.resize (n_tasks);
+
+  /* Work is done in a task group.  */
+  gdb::task_group workers ([this] ()
+  {
+    this->done_reading ();
+  });
+
+  for (size_t i = 0; i < n_tasks; ++i)
+    {
+      uint32_t first = i * names_per_task;
+      /* Put all remaining names into the last task.  */
+      uint32_t last = (i == n_tasks - 1
+		       ? m_map.name_count
+		       : first + names_per_task);
+      workers.add_task ([=] ()
+	{
+	  process_names (i, first, last);
+	});
+    }
 
-  bfd_thread_cleanup ();
+  workers.start ();
 }
 
 /* Check the signatured type hash table from .debug_names.  */
@@ -767,6 +887,10 @@ do_dwarf2_read_debug_names (dwarf2_per_objfile *per_objfile)
   map.shard = std::make_unique<cooked_index_shard> ();
   map.shard->install_addrmap (&addrmap);
 
+  /* The names are read from .debug_str by several worker threads at
+     once, so it has to be read in before.  */
+  per_bfd->str.read (objfile);
+
   cooked_index *idx
     = new debug_names_index (per_objfile,
 			     (std::make_unique<cooked_index_debug_names>
@@ -0,0 +1,397 @@
+/* Reading code for the native index cache format
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "dwarf2/read-index-cache.h"
+#include "dwarf2/cooked-index.h"
+#include "dwarf2/dwz.h"
+#include "dwarf2/index-cache.h"
+#include "dwarf2/read.h"
+
+#include "build-id.h"
+#include "complaints.h"
+#include "objfiles.h"
+
+/* A view of a mapped index cache file in the native format.  The
+   tables point directly into the mapping.  */
+
+struct mapped_index_cache
+{
+  /* Check the contents of BUFFER and set up the views on its tables.
+     Return false if the file is not usable by PER_OBJFILE.  This must
+     be called on the main thread.  */
+  bool read (dwarf2_per_objfile *per_objfile,
+	     gdb::array_view<const gdb_byte> buffer);
+
+  /* Return the string at OFFSET in the string table.  */
+  const char *string_at (uint64_t offset) const
+  {
+    return strings + offset;
+  }
+
+  const index_cache_file_header *header = nullptr;
+  gdb::array_view<const index_cache_unit> units;
+  gdb::array_view<const index_cache_shard> shards;
+  gdb::array_view<const index_cache_entry> entries;
+  gdb::array_view<const index_cache_addrmap> addrmap;
+  const char *strings = nullptr;
+  uint64_t strings_size = 0;
+};
+
+/* Set *RESULT to a view of the COUNT records starting at OFFSET in
+   BUFFER.  Return false if that does not fit in BUFFER or is
+   misaligned.  */
+
+template<typename T>
+static bool
+get_table (gdb::array_view<const gdb_byte> buffer, uint64_t offset,
+	   uint64_t count, gdb::array_view<const T> *result)
+{
+  if (offset > buffer.size ()
+      || offset % alignof (T) != 0
+      || count > (buffer.size () - offset) / sizeof (T))
+    return false;
+
+  *result = gdb::array_view<const T> ((const T *) (buffer.data () + offset),
+				      count);
+  return true;
+}
+
+/* Return true if the build ID at OFFSET in MAP's string table is the
+   build ID of ABFD.  */
+
+static bool
+build_id_matches (const mapped_index_cache &map, uint64_t offset, bfd *abfd)
+{
+  const bfd_build_id *build_id = build_id_bfd_get (abfd);
+  if (build_id == nullptr)
+    return false;
+
+  return build_id_to_string (build_id) == map.string_at (offset);
+}
+
+/* See the declaration.  */
+
+bool
+mapped_index_cache::read (dwarf2_per_objfile *per_objfile,
+			  gdb::array_view<const gdb_byte> buffer)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  const char *filename = objfile_name (per_objfile->objfile);
+
+  if (buffer.size () < sizeof (index_cache_file_header))
+    {
+      index_cache_debug ("index for %s is too small", filename);
+      return false;
+    }
+
+  header = (const index_cache_file_header *) buffer.data ();
+  if (memcmp (header->magic, INDEX_CACHE_MAGIC, sizeof (header->magic)) != 0
+      || header->version != INDEX_CACHE_VERSION
+      || header->byte_order != INDEX_CACHE_BYTE_ORDER)
+    {
+      index_cache_debug ("index for %s has an unsupported format",
+			 filename);
+      return false;
+    }
+
+  if (!get_table (buffer, header->units_offset, header->n_units, &units)
+      || !get_table (buffer, header->shards_offset, header->n_shards,
+		     &shards)
+      || !get_table (buffer, header->entries_offset, header->n_entries,
+		     &entries)
+      || !get_table (buffer, header->addrmap_offset, header->n_addrmap,
+		     &addrmap))
+    {
+      index_cache_debug ("index for %s is truncated", filename);
+      return false;
+    }
+
+  /* Every string must be NUL-terminated, which is guaranteed if the
+     table itself ends with a NUL.  */
+  gdb::array_view<const char> string_table;
+  if (!get_table (buffer, header->strings_offset, header->strings_size,
+		  &string_table)
+      || string_table.empty ()
+      || string_table[string_table.size () - 1] != '\0')
+    {
+      index_cache_debug ("index for %s has an invalid string table",
+			 filename);
+      return false;
+    }
+  strings = string_table.data ();
+  strings_size = string_table.size ();
+
+  /* The file is keyed on the build ID, but make sure that it really
+     was created for this objfile, and for the same dwz file.  */
+  dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+  if (header->build_id >= strings_size
+      || !build_id_matches (*this, header->build_id, per_bfd->obfd)
+      || (header->dwz_build_id == INDEX_CACHE_NONE) != (dwz == nullptr)
+      || (dwz != nullptr
+	  && (header->dwz_build_id >= strings_size
+	      || !build_id_matches (*this, header->dwz_build_id,
+				    dwz->dwz_bfd.get ()))))
+    {
+      index_cache_debug ("index for %s has a mismatched build ID",
+			 filename);
+      return false;
+    }
+
+  /* Check all the references between the tables up front, so that
+     the reader never has to deal with bad data.  */
+  uint64_t n_visible = 0;
+  for (const index_cache_shard &shard : shards)
+    {
+      if (shard.first_entry != n_visible
+	  || shard.n_entries > entries.size () - n_visible
+	  || shard.first_addrmap > addrmap.size ()
+	  || shard.n_addrmap > addrmap.size () - shard.first_addrmap
+	  || (shard.main_entry != INDEX_CACHE_NONE
+	      && (shard.main_entry < shard.first_entry
+		  || shard.main_entry >= shard.first_entry + shard.n_entries)))
+	{
+	  index_cache_debug ("index for %s has an invalid shard", filename);
+	  return false;
+	}
+      n_visible += shard.n_entries;
+    }
+
+  /* Entries that are only parents are allocated in the last
+     shard.  */
+  if (shards.empty () && !entries.empty ())
+    {
+      index_cache_debug ("index for %s has entries but no shard", filename);
+      return false;
+    }
+
+  for (const index_cache_entry &entry : entries)
+    if (entry.name >= strings_size
+	|| entry.canonical >= strings_size
+	|| entry.unit >= units.size ()
+	|| entry.lang >= nr_languages
+	|| (entry.flags & (uint8_t) IS_PARENT_DEFERRED) != 0
+	|| (entry.parent != INDEX_CACHE_NONE
+	    && entry.parent >= entries.size ()))
+      {
+	index_cache_debug ("index for %s has an invalid entry", filename);
+	return false;
+      }
+
+  for (const index_cache_addrmap &item : addrmap)
+    if (item.unit != INDEX_CACHE_NONE && item.unit >= units.size ())
+      {
+	index_cache_debug ("index for %s has an invalid address map",
+			   filename);
+	return false;
+      }
+
+  /* Finally, the units referenced by the index must be exactly those
+     found in the objfile.  */
+  create_all_units (per_objfile);
+  bool units_match = per_bfd->all_units.size () == units.size ();
+  for (size_t i = 0; units_match && i < units.size (); ++i)
+    {
+      const dwarf2_per_cu_data *per_cu = per_bfd->get_cu (i);
+      units_match = (units[i].sect_off == to_underlying (per_cu->sect_off)
+		     && units[i].length == per_cu->length ()
+		     && units[i].is_dwz == per_cu->is_dwz
+		     && units[i].is_debug_types == per_cu->is_debug_types);
+    }
+
+  if (!units_match)
+    {
+      index_cache_debug ("index for %s does not match its units", filename);
+      per_bfd->all_units.clear ();
+      per_bfd->tu_stats.nr_tus = 0;
+      return false;
+    }
+
+  return true;
+}
+
+/* A worker that creates the cooked index from a mapped index cache
+   file.  Since the file holds an already finalized index, this only
+   has to allocate the entries; no DWARF is read, no name is
+   canonicalized and nothing is sorted.  */
+
+class cooked_index_cache_reader : public cooked_index_worker
+{
+public:
+
+  cooked_index_cache_reader (dwarf2_per_objfile *per_objfile,
+			     mapped_index_cache &&map)
+    : cooked_index_worker (per_objfile),
+      m_map (std::move (map))
+  { }
+
+private:
+
+  void do_reading () override;
+
+  /* The index was just read from the cache, so there is no point in
+     writing it back.  */
+  void write_to_cache (const cooked_index *idx,
+		       deferred_warnings *warn) const override
+  { }
+
+  /* Create the shards described by the mapped file.  */
+  cooked_index::vec_type create_shards ();
+
+  mapped_index_cache m_map;
+};
+
+cooked_index::vec_type
+cooked_index_cache_reader::create_shards ()
+{
+  dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
+  cooked_index::vec_type result;
+  std::vector<cooked_index_entry *> all_entries (m_map.entries.size ());
+
+  auto create_entry = [&] (cooked_index_shard *shard, size_t index,
+			   bool visible)
+    {
+      const index_cache_entry &rec = m_map.entries[index];
+      all_entries[index]
+	= shard->add_finalized (sect_offset (rec.die_offset),
+				(dwarf_tag) rec.tag,
+				(cooked_index_flag_enum) rec.flags,
+				(enum language) rec.lang,
+				m_map.string_at (rec.name),
+				m_map.string_at (rec.canonical),
+				per_bfd->get_cu (rec.unit),
+				visible);
+    };
+
+  size_t n_visible = 0;
+  for (const index_cache_shard &shard_rec : m_map.shards)
+    {
+      auto shard = std::make_unique<cooked_index_shard> ();
+
+      for (uint64_t i = 0; i < shard_rec.n_entries; ++i)
+	create_entry (shard.get (), shard_rec.first_entry + i, true);
+      n_visible += shard_rec.n_entries;
+
+      addrmap_mutable addrmap;
+      auto items = m_map.addrmap.slice (shard_rec.first_addrmap,
+					shard_rec.n_addrmap);
+      for (size_t i = 0; i < items.size (); ++i)
+	{
+	  if (items[i].unit == INDEX_CACHE_NONE)
+	    continue;
+
+	  CORE_ADDR end = (i + 1 < items.size ()
+			   ? items[i + 1].start - 1
+			   : (CORE_ADDR) -1);
+	  addrmap.set_empty (items[i].start, end,
+			     per_bfd->get_cu (items[i].unit));
+	}
+      shard->install_addrmap (&addrmap);
+
+      result.push_back (std::move (shard));
+    }
+
+  for (size_t i = n_visible; i < all_entries.size (); ++i)
+    create_entry (result.back ().get (), i, false);
+
+  for (size_t i = 0; i < all_entries.size (); ++i)
+    {
+      uint64_t parent = m_map.entries[i].parent;
+      if (parent != INDEX_CACHE_NONE)
+	all_entries[i]->set_parent (all_entries[parent]);
+    }
+
+  for (size_t i = 0; i < result.size (); ++i)
+    {
+      uint64_t main_entry = m_map.shards[i].main_entry;
+      result[i]->set_finalized (main_entry == INDEX_CACHE_NONE
+				? nullptr
+				: all_entries[main_entry]);
+    }
+
+  return result;
+}
+
+void
+cooked_index_cache_reader::do_reading ()
+{
+  complaint_interceptor complaint_handler;
+  std::vector<gdb_exception> exceptions;
+  cooked_index::vec_type shards;
+  try
+    {
+      shards = create_shards ();
+    }
+  catch (const gdb_exception &exc)
+    {
+      exceptions.push_back (std::move (exc));
+    }
+
+  dwarf2_per_bfd *per_bfd = m_per_objfile->per_bfd;
+  per_bfd->quick_file_names_table
+    = create_quick_file_names_table (per_bfd->all_units.size ());
+  m_results.emplace_back (nullptr,
+			  complaint_handler.release (),
+			  std::move (exceptions),
+			  parent_map ());
+
+  cooked_index *table
+    = (gdb::checked_static_cast<cooked_index *>
+       (per_bfd->index_table.get ()));
+  /* The parents were all resolved before the index was written, so
+     it is safe to pass nullptr here.  */
+  table->set_contents (std::move (shards), &m_warnings, nullptr);
+
+  bfd_thread_cleanup ();
+}
+
+/* See read-index-cache.h.  */
+
+bool
+dwarf2_read_index_cache (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  const bfd_build_id *build_id = build_id_bfd_get (per_bfd->obfd);
+  if (build_id == nullptr)
+    return false;
+
+  std::unique_ptr<index_cache_resource> resource;
+  gdb::array_view<const gdb_byte> buffer
+    = global_index_cache.lookup_cooked_index (build_id, &resource);
+  if (buffer.empty ())
+    return false;
+
+  mapped_index_cache map;
+  if (!map.read (per_objfile, buffer))
+    return false;
+
+  /* The entries point into the mapping, so it must live as long as
+     PER_BFD.  */
+  per_bfd->index_cache_res = std::move (resource);
+
+  cooked_index *idx
+    = new cooked_index (per_objfile,
+			(std::make_unique<cooked_index_cache_reader>
+			 (per_objfile, std::move (map))));
+  per_bfd->index_table.reset (idx);
+
+  idx->start_reading ();
+
+  return true;
+}
@@ -0,0 +1,32 @@
+/* Reading code for the native index cache format
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DWARF2_READ_INDEX_CACHE_H
+#define DWARF2_READ_INDEX_CACHE_H
+
+struct dwarf2_per_objfile;
+
+/* Look in the index cache for a cooked index of PER_OBJFILE stored in
+   the native format.  If one was found and it matches the objfile,
+   install it as the index of PER_OBJFILE and return true.  Otherwise,
+   return false.  */
+
+extern bool dwarf2_read_index_cache (dwarf2_per_objfile *per_objfile);
+
+#endif /* DWARF2_READ_INDEX_CACHE_H */
@@ -42,6 +42,7 @@
 #include "dwarf2/die.h"
 #include "dwarf2/read-debug-names.h"
 #include "dwarf2/read-gdb-index.h"
+#include "dwarf2/read-index-cache.h"
 #include "dwarf2/sect-names.h"
 #include "dwarf2/stringify.h"
 #include "dwarf2/public.h"
@@ -94,6 +95,7 @@
 #include "cooked-index.h"
 #include "split-name.h"
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/parallel-for.h"
 #include "run-on-main-thread.h"
 #include "dwarf2/parent-map.h"
 
@@ -607,6 +609,15 @@ class cutu_reader : public die_reader_specs
      for dummy CUs.  */
   void keep ();
 
+  /* Release the new CU, transferring ownership to the caller instead
+     of putting it on the chain.  This cannot be done for dummy
+     CUs.  */
+  std::unique_ptr<dwarf2_cu> release_cu ()
+  {
+    gdb_assert (!dummy_p);
+    return std::move (m_new_cu);
+  }
+
   /* Release the abbrev table, transferring ownership to the
      caller.  */
   abbrev_table_up release_abbrev_table ()
@@ -750,6 +761,20 @@ show_dwarf_synchronous (struct ui_file *file, int from_tty,
 	      value);
 }
 
+/* When true, the DIEs of the units to expand are read in worker
+   threads before their symtabs are expanded.  */
+static bool dwarf_parallel_expansion = true;
+
+/* "Show" callback for "maint set dwarf parallel-expansion".  */
+static void
+show_dwarf_parallel_expansion (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Whether DWARF units are read in parallel "
+		      "before expansion is %s.\n"),
+	      value);
+}
+
 /* local function prototypes */
 
 static void dwarf2_find_base_address (struct die_info *die,
@@ -1067,6 +1092,12 @@ static void load_full_comp_unit (dwarf2_per_cu_data *per_cu,
 				 bool skip_partial,
 				 enum language pretend_language);
 
+static void read_full_comp_unit_dies (cutu_reader *reader,
+				      enum language pretend_language);
+
+static struct dwarf2_section_info *get_abbrev_section_for_cu
+  (struct dwarf2_per_cu_data *this_cu);
+
 static void process_full_comp_unit (dwarf2_cu *cu,
 				    enum language pretend_language);
 
@@ -1630,6 +1661,12 @@ struct quick_file_names
   /* The file names from the line table after being run through
      gdb_realpath.  These are computed lazily.  */
   const char **real_names;
+
+  /* For each file, the largest line number given to a row of the line
+     program, or 0 if there is none.  This is an upper bound, UINT_MAX
+     meaning that the line program could not be scanned.  These are
+     computed lazily, see dw2_compute_max_lines.  */
+  unsigned int *max_lines;
 };
 
 /* With OBJF_READNOW, the DWARF reader expands all CUs immediately.
@@ -1654,6 +1691,14 @@ struct readnow_functions : public dwarf2_base_index_functions
   {
     return true;
   }
+
+  bool map_symbol_names
+    (struct objfile *objfile,
+     gdb::function_view<void (const char *)> callback) override
+  {
+    /* All the symbols are in the expanded symtabs.  */
+    return true;
+  }
 };
 
 /* Utility hash function for a stmt_list_hash.  */
@@ -1727,8 +1772,15 @@ load_cu (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
   if (per_cu->is_debug_types)
     load_full_type_unit (per_cu, per_objfile);
   else
-    load_full_comp_unit (per_cu, per_objfile, per_objfile->get_cu (per_cu),
-			 skip_partial, language_minimal);
+    {
+      dwarf2_cu *existing_cu = per_objfile->get_cu (per_cu);
+
+      /* The DIEs may already have been read by
+	 read_comp_units_in_parallel.  */
+      if (existing_cu == nullptr || existing_cu->dies == nullptr)
+	load_full_comp_unit (per_cu, per_objfile, existing_cu,
+			     skip_partial, language_minimal);
+    }
 
   dwarf2_cu *cu = per_objfile->get_cu (per_cu);
   if (cu == nullptr)
@@ -1798,6 +1850,159 @@ dw2_instantiate_symtab (dwarf2_per_cu_data *per_cu,
   return per_objfile->get_symtab (per_cu);
 }
 
+/* Read the DIEs of the compilation units in PER_CUS using the thread
+   pool.  Each unit is read into its own dwarf2_cu, and so into its own
+   obstack.  Return a vector parallel to PER_CUS holding the new
+   dwarf2_cu objects; an element is null if its unit was skipped, is a
+   dummy, or could not be read.  In the latter case, reading the unit
+   again on the main thread will report the error.  */
+
+static std::vector<std::unique_ptr<dwarf2_cu>>
+read_comp_units_in_parallel (dwarf2_per_objfile *per_objfile,
+			     gdb::array_view<dwarf2_per_cu_data *> per_cus,
+			     bool skip_partial)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  std::vector<std::unique_ptr<dwarf2_cu>> result (per_cus.size ());
+
+  /* Only units that would otherwise be read from scratch by load_cu
+     are read here.  Type units are left to the main thread.  */
+  std::vector<size_t> to_read;
+  for (size_t i = 0; i < per_cus.size (); ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_cus[i];
+      if (per_cu->is_debug_types
+	  || per_objfile->symtab_set_p (per_cu)
+	  || per_objfile->get_cu (per_cu) != nullptr)
+	continue;
+
+      /* Reading a section is not thread-safe, so make sure the ones
+	 the workers need are already read.  */
+      per_cu->section->read (objfile);
+      get_abbrev_section_for_cu (per_cu)->read (objfile);
+      to_read.push_back (i);
+    }
+
+  if (to_read.empty ())
+    return result;
+
+  per_objfile->per_bfd->map_info_sections (objfile);
+  dwz_file *dwz = dwarf2_get_dwz_file (per_objfile->per_bfd);
+  if (dwz != nullptr)
+    dwz->str.read (objfile);
+
+#if CXX_STD_THREAD
+  std::mutex complaints_lock;
+#endif
+  complaint_collection all_complaints;
+
+  gdb::parallel_for_each (1, to_read.begin (), to_read.end (),
+			  [&] (std::vector<size_t>::iterator first,
+			       std::vector<size_t>::iterator last)
+    {
+      complaint_interceptor complaint_handler;
+      abbrev_cache cache;
+
+      for (auto iter = first; iter != last; ++iter)
+	{
+	  try
+	    {
+	      cutu_reader reader (per_cus[*iter], per_objfile, nullptr,
+				  nullptr, skip_partial, &cache);
+	      if (reader.dummy_p)
+		continue;
+
+	      read_full_comp_unit_dies (&reader, language_minimal);
+	      result[*iter] = reader.release_cu ();
+	      cache.add (reader.release_abbrev_table ());
+	    }
+	  catch (const gdb_exception &)
+	    {
+	      /* Leave this unit to the main thread.  */
+	    }
+	}
+
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (complaints_lock);
+#endif
+      complaint_collection complaints = complaint_handler.release ();
+      all_complaints.insert (complaints.begin (), complaints.end ());
+    });
+
+  re_emit_complaints (all_complaints);
+
+  return result;
+}
+
+/* Call EXPAND on each unit of PER_CUS, in order, stopping early if it
+   returns false.  Return false if EXPAND did.
+
+   EXPAND is expected to expand the symtab of the unit, as
+   dw2_instantiate_symtab does with SKIP_PARTIAL.  When "maint set
+   dwarf parallel-expansion" is on, the DIEs of the units are read
+   ahead in worker threads, a batch at a time.  The symtabs themselves
+   are still built on the main thread, in the order of PER_CUS, so the
+   result is the same as expanding the units one by one.  */
+
+static bool
+dw2_expand_units (dwarf2_per_objfile *per_objfile,
+		  gdb::array_view<dwarf2_per_cu_data *> per_cus,
+		  bool skip_partial,
+		  gdb::function_view<bool (dwarf2_per_cu_data *)> expand)
+{
+  if (!dwarf_parallel_expansion
+      || gdb::thread_pool::g_thread_pool->thread_count () == 0
+      || per_cus.size () < 2)
+    {
+      for (dwarf2_per_cu_data *per_cu : per_cus)
+	{
+	  QUIT;
+
+	  if (!expand (per_cu))
+	    return false;
+	}
+      return true;
+    }
+
+  /* Bound the amount of DIEs that are read ahead, as the dwarf2_cu
+     objects are only freed once their unit has been expanded.  */
+  const size_t max_batch_size
+    = (gdb::thread_pool::g_thread_pool->thread_count () * 4 * 1024 * 1024);
+
+  for (size_t start = 0; start < per_cus.size (); )
+    {
+      size_t end = start;
+      size_t batch_size = 0;
+      while (end < per_cus.size () && batch_size < max_batch_size)
+	batch_size += per_cus[end++]->length ();
+
+      gdb::array_view<dwarf2_per_cu_data *> batch
+	= per_cus.slice (start, end - start);
+      std::vector<std::unique_ptr<dwarf2_cu>> cus
+	= read_comp_units_in_parallel (per_objfile, batch, skip_partial);
+
+      for (size_t i = 0; i < batch.size (); ++i)
+	{
+	  QUIT;
+
+	  /* Expanding an earlier unit may have read this one already,
+	     in which case the DIEs read ahead are simply dropped.  */
+	  if (cus[i] != nullptr
+	      && !per_objfile->symtab_set_p (batch[i])
+	      && per_objfile->get_cu (batch[i]) == nullptr)
+	    per_objfile->set_cu (batch[i], std::move (cus[i]));
+	  cus[i].reset ();
+
+	  if (!expand (batch[i]))
+	    return false;
+	}
+
+      start = end;
+    }
+
+  return true;
+}
+
 /* See read.h.  */
 
 dwarf2_per_cu_data_up
@@ -1932,6 +2137,7 @@ dw2_get_file_names_reader (const struct die_reader_specs *reader,
 	    include_names.size () * sizeof (const char *));
 
   qfn->real_names = NULL;
+  qfn->max_lines = NULL;
 
   lh_cu->file_names = qfn;
 }
@@ -2055,19 +2261,22 @@ void
 dwarf2_base_index_functions::expand_all_symtabs (struct objfile *objfile)
 {
   dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
-  int total_units = per_objfile->per_bfd->all_units.size ();
+  std::vector<dwarf2_per_cu_data *> per_cus;
 
-  for (int i = 0; i < total_units; ++i)
-    {
-      dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->get_cu (i);
+  for (dwarf2_per_cu_data *per_cu : all_units_range (per_objfile->per_bfd))
+    per_cus.push_back (per_cu);
 
-      /* We don't want to directly expand a partial CU, because if we
-	 read it with the wrong language, then assertion failures can
-	 be triggered later on.  See PR symtab/23010.  So, tell
-	 dw2_instantiate_symtab to skip partial CUs -- any important
-	 partial CU will be read via DW_TAG_imported_unit anyway.  */
+  /* We don't want to directly expand a partial CU, because if we
+     read it with the wrong language, then assertion failures can
+     be triggered later on.  See PR symtab/23010.  So, tell
+     dw2_instantiate_symtab to skip partial CUs -- any important
+     partial CU will be read via DW_TAG_imported_unit anyway.  */
+  dw2_expand_units (per_objfile, per_cus, true,
+		    [&] (dwarf2_per_cu_data *per_cu)
+    {
       dw2_instantiate_symtab (per_cu, per_objfile, true);
-    }
+      return true;
+    });
 }
 
 
@@ -2872,6 +3081,27 @@ dw2_expand_symtabs_matching_one
   return true;
 }
 
+/* Return true if the file at index J of FILE_DATA matches
+   FILE_MATCHER.  */
+
+static bool
+dw2_file_matches_p
+  (dwarf2_per_objfile *per_objfile, quick_file_names *file_data, int j,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher)
+{
+  if (file_matcher (file_data->file_names[j], false))
+    return true;
+
+  /* Before we invoke realpath, which can get expensive when many
+     files are involved, do a quick comparison of the basenames.  */
+  if (!basenames_may_differ
+      && !file_matcher (lbasename (file_data->file_names[j]), true))
+    return false;
+
+  const char *this_real_name = dw2_get_real_path (per_objfile, file_data, j);
+  return file_matcher (this_real_name, false);
+}
+
 /* See read.h.  */
 
 void
@@ -2939,36 +3169,340 @@ dw_expand_symtabs_matching_file_matcher
 	}
 
       for (int j = 0; j < file_data->num_file_names; ++j)
+	if (dw2_file_matches_p (per_objfile, file_data, j, file_matcher))
+	  {
+	    per_cu->mark = 1;
+	    break;
+	  }
+
+      void **slot = htab_find_slot (per_cu->mark
+				    ? visited_found.get ()
+				    : visited_not_found.get (),
+				    file_data, INSERT);
+      *slot = file_data;
+    }
+}
+
+/* Scan the line number program of LH, and store in MAX_LINES, for
+   each file of LH, the largest line number of its rows, or 0 if it has
+   none.  Unlike dwarf_decode_lines, this only follows the file and
+   line registers, and does not need a CU, so it can be run from a
+   worker thread.  Return false if the program could not be scanned,
+   in which case MAX_LINES must not be used.  */
+
+static bool
+dw2_scan_max_lines (const line_header *lh, bfd *abfd,
+		    std::vector<unsigned int> &max_lines)
+{
+  const std::vector<file_entry> &files = lh->file_names ();
+  max_lines.assign (files.size (), 0);
+
+  if (lh->line_range == 0)
+    return false;
+
+  const gdb_byte *line_ptr = lh->statement_program_start;
+  const gdb_byte *line_end = lh->statement_program_end;
+  unsigned int bytes_read;
+  file_name_index file = 1;
+  unsigned int line = 1;
+
+  auto record_line = [&] ()
+    {
+      /* A bad file index is complained about when the line table is
+	 actually decoded, ignore it here.  */
+      const file_entry *fe = lh->file_name_at (file);
+      if (fe != nullptr)
 	{
-	  const char *this_real_name;
+	  size_t index = fe - files.data ();
+	  max_lines[index] = std::max (max_lines[index], line);
+	}
+    };
+
+  while (line_ptr < line_end)
+    {
+      unsigned char op_code = read_1_byte (abfd, line_ptr);
+      line_ptr += 1;
 
-	  if (file_matcher (file_data->file_names[j], false))
+      if (op_code >= lh->opcode_base)
+	{
+	  /* Special opcode.  */
+	  unsigned char adj_opcode = op_code - lh->opcode_base;
+	  line += lh->line_base + (adj_opcode % lh->line_range);
+	  record_line ();
+	  continue;
+	}
+
+      switch (op_code)
+	{
+	case DW_LNS_extended_op:
+	  {
+	    ULONGEST len = read_unsigned_leb128 (abfd, line_ptr, &bytes_read);
+	    line_ptr += bytes_read;
+	    if (len == 0 || len > (ULONGEST) (line_end - line_ptr))
+	      return false;
+
+	    const gdb_byte *extended_end = line_ptr + len;
+	    unsigned char extended_op = read_1_byte (abfd, line_ptr);
+	    if (extended_op == DW_LNE_end_sequence)
+	      {
+		file = 1;
+		line = 1;
+	      }
+	    else if (extended_op == DW_LNE_define_file)
+	      {
+		/* The file would be missing from the quick file names
+		   anyway; be conservative.  */
+		return false;
+	      }
+	    line_ptr = extended_end;
+	  }
+	  break;
+	case DW_LNS_copy:
+	  record_line ();
+	  break;
+	case DW_LNS_advance_line:
+	  line += read_signed_leb128 (abfd, line_ptr, &bytes_read);
+	  line_ptr += bytes_read;
+	  break;
+	case DW_LNS_set_file:
+	  file = (file_name_index) read_unsigned_leb128 (abfd, line_ptr,
+							  &bytes_read);
+	  line_ptr += bytes_read;
+	  break;
+	case DW_LNS_fixed_advance_pc:
+	  line_ptr += 2;
+	  break;
+	case DW_LNS_advance_pc:
+	case DW_LNS_set_column:
+	case DW_LNS_negate_stmt:
+	case DW_LNS_set_basic_block:
+	case DW_LNS_const_add_pc:
+	default:
+	  /* Skip the operands, if any.  */
+	  for (int i = 0; i < lh->standard_opcode_lengths[op_code]; i++)
 	    {
-	      per_cu->mark = 1;
-	      break;
+	      (void) read_unsigned_leb128 (abfd, line_ptr, &bytes_read);
+	      line_ptr += bytes_read;
 	    }
+	  break;
+	}
+    }
 
-	  /* Before we invoke realpath, which can get expensive when many
-	     files are involved, do a quick comparison of the basenames.  */
-	  if (!basenames_may_differ
-	      && !file_matcher (lbasename (file_data->file_names[j]),
-				true))
+  return true;
+}
+
+/* A unit whose line program is to be scanned by
+   dw2_compute_max_lines.  */
+
+struct max_lines_work
+{
+  /* The file names the result is for.  */
+  quick_file_names *file_data;
+
+  /* The line header of the unit.  */
+  line_header_up lh;
+
+  /* For each file of LH, the index of the same file in FILE_DATA, or
+     -1 if there is none.  */
+  std::vector<int> file_map;
+
+  /* The result, parallel to FILE_DATA->file_names.  Empty if the line
+     program could not be scanned.  */
+  std::vector<unsigned int> max_lines;
+};
+
+/* Set up WORK for PER_CU, whose file names are FILE_DATA.  Return
+   false if the line header can't be read, or doesn't map onto
+   FILE_DATA.  This mirrors dw2_get_file_names_reader.  */
+
+static bool
+dw2_prepare_max_lines (dwarf2_per_cu_data *per_cu,
+		       dwarf2_per_objfile *per_objfile,
+		       quick_file_names *file_data,
+		       max_lines_work &work)
+{
+  cutu_reader reader (per_cu, per_objfile);
+  if (reader.dummy_p)
+    return false;
+
+  dwarf2_cu *cu = reader.cu;
+  attribute *attr = dwarf2_attr (reader.comp_unit_die, DW_AT_stmt_list, cu);
+  if (attr == nullptr || !attr->form_is_unsigned ())
+    return false;
+
+  file_and_directory &fnd = find_file_and_directory (reader.comp_unit_die,
+						     cu);
+  work.lh = dwarf_decode_line_header ((sect_offset) attr->as_unsigned (),
+				      cu, fnd.get_comp_dir ());
+  if (work.lh == nullptr)
+    return false;
+
+  /* The first entry of FILE_DATA is the CU itself when its name is
+     known.  Files of the line header with the same name as the CU
+     map onto it.  */
+  int offset = fnd.is_unknown () ? 0 : 1;
+  int next = offset;
+  for (const file_entry &entry : work.lh->file_names ())
+    {
+      std::string name_holder;
+      const char *include_name
+	= compute_include_file_name (work.lh.get (), entry, fnd, name_holder);
+      if (include_name != nullptr)
+	work.file_map.push_back (next++);
+      else
+	work.file_map.push_back (offset != 0 ? 0 : -1);
+    }
+
+  return next == file_data->num_file_names;
+}
+
+/* Fill in the max_lines field of FILE_DATA for the file names of the
+   CUs in PER_CUS.  The line programs are scanned using the thread
+   pool.  */
+
+static void
+dw2_compute_max_lines (dwarf2_per_objfile *per_objfile,
+		       const std::vector<dwarf2_per_cu_data *> &per_cus)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  std::vector<max_lines_work> work (per_cus.size ());
+
+  /* Reading the line headers goes through the CU, so is done here on
+     the main thread.  This is cheap compared to the line programs.  */
+  for (size_t i = 0; i < per_cus.size (); ++i)
+    {
+      QUIT;
+
+      quick_file_names *file_data = per_cus[i]->file_names;
+      if (!dw2_prepare_max_lines (per_cus[i], per_objfile, file_data,
+				  work[i]))
+	work[i].lh.reset ();
+      work[i].file_data = file_data;
+    }
+
+  bfd *abfd = objfile->obfd.get ();
+  gdb::parallel_for_each (1, work.begin (), work.end (),
+			  [=] (std::vector<max_lines_work>::iterator first,
+			       std::vector<max_lines_work>::iterator last)
+    {
+      std::vector<unsigned int> lh_max_lines;
+
+      for (auto iter = first; iter != last; ++iter)
+	{
+	  if (iter->lh == nullptr
+	      || !dw2_scan_max_lines (iter->lh.get (), abfd, lh_max_lines))
 	    continue;
 
-	  this_real_name = dw2_get_real_path (per_objfile, file_data, j);
-	  if (file_matcher (this_real_name, false))
-	    {
-	      per_cu->mark = 1;
-	      break;
-	    }
+	  iter->max_lines.assign (iter->file_data->num_file_names, 0);
+	  for (size_t i = 0; i < lh_max_lines.size (); ++i)
+	    if (iter->file_map[i] >= 0)
+	      {
+		unsigned int &max_line = iter->max_lines[iter->file_map[i]];
+		max_line = std::max (max_line, lh_max_lines[i]);
+	      }
 	}
+    });
 
-      void **slot = htab_find_slot (per_cu->mark
-				    ? visited_found.get ()
-				    : visited_not_found.get (),
-				    file_data, INSERT);
-      *slot = file_data;
+  for (max_lines_work &item : work)
+    {
+      quick_file_names *file_data = item.file_data;
+      file_data->max_lines = XOBNEWVEC (&per_bfd->obstack, unsigned int,
+					file_data->num_file_names);
+      if (item.max_lines.empty ())
+	std::fill_n (file_data->max_lines, file_data->num_file_names,
+		     UINT_MAX);
+      else
+	std::copy (item.max_lines.begin (), item.max_lines.end (),
+		   file_data->max_lines);
+    }
+}
+
+/* Return true if PER_CU, which was marked by
+   dw_expand_symtabs_matching_file_matcher, may have code for LINE in
+   a file matching FILE_MATCHER.  */
+
+static bool
+dw2_may_have_line_p
+  (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   int line)
+{
+  quick_file_names *file_data = per_cu->file_names;
+  if (file_data == nullptr || file_data->max_lines == nullptr)
+    return true;
+
+  for (int j = 0; j < file_data->num_file_names; ++j)
+    if (file_data->max_lines[j] >= (unsigned int) line
+	&& dw2_file_matches_p (per_objfile, file_data, j, file_matcher))
+      return true;
+
+  return false;
+}
+
+/* See quick-symbol.h.  */
+
+bool
+dwarf2_base_index_functions::expand_symtabs_for_source_line
+  (struct objfile *objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   int line,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
+
+  /* Find the units matching FILE_MATCHER whose line programs have not
+     been scanned yet.  Units sharing their file names are only
+     scanned once.  */
+  std::vector<dwarf2_per_cu_data *> candidates;
+  std::vector<dwarf2_per_cu_data *> to_scan;
+  std::unordered_set<quick_file_names *> seen;
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      if (per_cu->is_debug_types || !per_cu->mark)
+	continue;
+      candidates.push_back (per_cu.get ());
+
+      /* A unit matched by its name alone may not have read its file
+	 names yet.  */
+      quick_file_names *file_data = dw2_get_file_names (per_cu.get (),
+							per_objfile);
+      if (file_data != nullptr
+	  && file_data->max_lines == nullptr
+	  && seen.insert (file_data).second)
+	to_scan.push_back (per_cu.get ());
+    }
+
+  if (!to_scan.empty ())
+    {
+      dwarf_read_debug_printf ("scanning %zu line programs for line %d",
+			       to_scan.size (), line);
+
+      /* Reading a section is not thread-safe, and the line programs
+	 point into these.  */
+      per_bfd->map_info_sections (objfile);
+      dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+      if (dwz != nullptr)
+	dwz->line.read (objfile);
+
+      dw2_compute_max_lines (per_objfile, to_scan);
     }
+
+  std::vector<dwarf2_per_cu_data *> to_expand;
+  for (dwarf2_per_cu_data *per_cu : candidates)
+    if (dw2_may_have_line_p (per_cu, per_objfile, file_matcher, line))
+      to_expand.push_back (per_cu);
+
+  return dw2_expand_units (per_objfile, to_expand, false,
+			   [&] (dwarf2_per_cu_data *per_cu)
+    {
+      return dw2_expand_symtabs_matching_one (per_cu, per_objfile,
+					      file_matcher,
+					      expansion_notify);
+    });
 }
 
 
@@ -3241,6 +3775,13 @@ dwarf2_initialize_objfile (struct objfile *objfile,
 				  get_gdb_index_contents_from_section<dwz_file>))
     dwarf_read_debug_printf ("found gdb index from file");
   /* ... otherwise, try to find the index in the index cache.  */
+  else if (dwarf2_read_index_cache (per_objfile))
+    {
+      dwarf_read_debug_printf ("found cooked index from cache");
+      global_index_cache.hit ();
+    }
+  /* ... or an index in the .gdb_index format, as written to the cache
+     by older versions of GDB.  */
   else if (dwarf2_read_gdb_index (per_objfile,
 			     get_gdb_index_contents_from_cache,
 			     get_gdb_index_contents_from_cache_dwz))
@@ -5478,28 +6019,15 @@ process_queue (dwarf2_per_objfile *per_objfile)
 			   objfile_name (per_objfile->objfile));
 }
 
-/* Load the DIEs associated with PER_CU into memory.
-
-   In some cases, the caller, while reading partial symbols, will need to load
-   the full symbols for the CU for some reason.  It will already have a
-   dwarf2_cu object for THIS_CU and pass it as EXISTING_CU, so it can be re-used
-   rather than creating a new one.  */
+/* Read all the DIEs of the unit being read by READER, and prepare its
+   dwarf2_cu for expansion.  READER must not be a dummy.  */
 
 static void
-load_full_comp_unit (dwarf2_per_cu_data *this_cu,
-		     dwarf2_per_objfile *per_objfile,
-		     dwarf2_cu *existing_cu,
-		     bool skip_partial,
-		     enum language pretend_language)
+read_full_comp_unit_dies (cutu_reader *reader,
+			  enum language pretend_language)
 {
-  gdb_assert (! this_cu->is_debug_types);
-
-  cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
-  if (reader.dummy_p)
-    return;
-
-  struct dwarf2_cu *cu = reader.cu;
-  const gdb_byte *info_ptr = reader.info_ptr;
+  struct dwarf2_cu *cu = reader->cu;
+  const gdb_byte *info_ptr = reader->info_ptr;
 
   gdb_assert (cu->die_hash == NULL);
   cu->die_hash =
@@ -5511,11 +6039,11 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
 			  hashtab_obstack_allocate,
 			  dummy_obstack_deallocate);
 
-  if (reader.comp_unit_die->has_children)
-    reader.comp_unit_die->child
-      = read_die_and_siblings (&reader, reader.info_ptr,
-			       &info_ptr, reader.comp_unit_die);
-  cu->dies = reader.comp_unit_die;
+  if (reader->comp_unit_die->has_children)
+    reader->comp_unit_die->child
+      = read_die_and_siblings (reader, reader->info_ptr,
+			       &info_ptr, reader->comp_unit_die);
+  cu->dies = reader->comp_unit_die;
   /* comp_unit_die is not stored in die_hash, no need.  */
 
   /* We try not to read any attributes in this function, because not
@@ -5525,6 +6053,29 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
      Similarly, if we do not read the producer, we can not apply
      producer-specific interpretation.  */
   prepare_one_comp_unit (cu, cu->dies, pretend_language);
+}
+
+/* Load the DIEs associated with PER_CU into memory.
+
+   In some cases, the caller, while reading partial symbols, will need to load
+   the full symbols for the CU for some reason.  It will already have a
+   dwarf2_cu object for THIS_CU and pass it as EXISTING_CU, so it can be re-used
+   rather than creating a new one.  */
+
+static void
+load_full_comp_unit (dwarf2_per_cu_data *this_cu,
+		     dwarf2_per_objfile *per_objfile,
+		     dwarf2_cu *existing_cu,
+		     bool skip_partial,
+		     enum language pretend_language)
+{
+  gdb_assert (! this_cu->is_debug_types);
+
+  cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
+  if (reader.dummy_p)
+    return;
+
+  read_full_comp_unit_dies (&reader, pretend_language);
 
   reader.keep ();
 }
@@ -16782,6 +17333,37 @@ cooked_index_functions::expand_symtabs_matching
 
   dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
 
+  auto expand_one = [&] (dwarf2_per_cu_data *per_cu)
+    {
+      return dw2_expand_symtabs_matching_one (per_cu, per_objfile,
+					      file_matcher,
+					      expansion_notify);
+    };
+
+  /* Without EXPANSION_NOTIFY, nothing can stop the search early, so
+     the units to expand are collected first, and then expanded all at
+     once by dw2_expand_units.  Otherwise, each unit is expanded as
+     soon as it is found.  */
+  const bool defer_expansion = expansion_notify == nullptr;
+  std::vector<dwarf2_per_cu_data *> deferred;
+  std::vector<bool> deferred_p;
+  if (defer_expansion)
+    deferred_p.resize (per_objfile->per_bfd->all_units.size ());
+
+  auto maybe_expand = [&] (dwarf2_per_cu_data *per_cu)
+    {
+      if (!defer_expansion)
+	return expand_one (per_cu);
+
+      if ((file_matcher == nullptr || per_cu->mark)
+	  && !deferred_p[per_cu->index])
+	{
+	  deferred_p[per_cu->index] = true;
+	  deferred.push_back (per_cu);
+	}
+      return true;
+    };
+
   /* This invariant is documented in quick-functions.h.  */
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
   if (lookup_name == nullptr)
@@ -16791,12 +17373,10 @@ cooked_index_functions::expand_symtabs_matching
 	{
 	  QUIT;
 
-	  if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
+	  if (!maybe_expand (per_cu))
 	    return false;
 	}
-      return true;
+      return dw2_expand_units (per_objfile, deferred, false, expand_one);
     }
 
   lookup_name_info lookup_name_without_params
@@ -16836,8 +17416,10 @@ cooked_index_functions::expand_symtabs_matching
 	{
 	  QUIT;
 
-	  /* No need to consider symbols from expanded CUs.  */
-	  if (per_objfile->symtab_set_p (entry->per_cu))
+	  /* No need to consider symbols from expanded CUs, or from
+	     CUs that will be expanded anyway.  */
+	  if (per_objfile->symtab_set_p (entry->per_cu)
+	      || (defer_expansion && deferred_p[entry->per_cu->index]))
 	    continue;
 
 	  /* If file-matching was done, we don't need to consider
@@ -16916,14 +17498,12 @@ cooked_index_functions::expand_symtabs_matching
 		continue;
 	    }
 
-	  if (!dw2_expand_symtabs_matching_one (entry->per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
+	  if (!maybe_expand (entry->per_cu))
 	    return false;
 	}
     }
 
-  return true;
+  return dw2_expand_units (per_objfile, deferred, false, expand_one);
 }
 
 /* Start reading .debug_info using the indexer.  */
@@ -22179,6 +22759,19 @@ for debug info processing to be finished before gdb can proceed."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("parallel-expansion", class_obscure,
+			   &dwarf_parallel_expansion, _("\
+Set whether DWARF units are read in parallel before expansion."), _("\
+Show whether DWARF units are read in parallel before expansion."), _("\
+When enabled, expanding the symbol tables of many compilation units\n\
+at once, for example for \"info functions REGEXP\", first reads the\n\
+DWARF of those units in worker threads.  The symbol tables are then\n\
+built in the usual order."),
+			   nullptr,
+			   show_dwarf_parallel_expansion,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
   add_setshow_zuinteger_cmd ("dwarf-read", no_class, &dwarf_read_debug, _("\
 Set debugging of the DWARF reader."), _("\
 Show debugging of the DWARF reader."), _("\
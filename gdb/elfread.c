@@ -1055,43 +1055,41 @@ elf_gnu_ifunc_resolver_return_stop (code_breakpoint *b)
 			       {});
 }
 
-/* A helper function for elf_symfile_read that reads the minimal
-   symbols.  */
+/* The BFD symbol tables of an ELF file that elf_read_minimal_symbols
+   needs.  */
 
-static void
-elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
-			  const struct elfinfo *ei)
+struct elf_symbol_tables
 {
-  bfd *synth_abfd, *abfd = objfile->obfd.get ();
-  long symcount = 0, dynsymcount = 0, synthcount, storage_needed;
-  asymbol **symbol_table = NULL, **dyn_symbol_table = NULL;
-  asymbol *synthsyms;
+  /* The regular symbol table.  The array is allocated with bfd_alloc,
+     as BFD keeps referencing it.  */
+  long symcount = 0;
+  asymbol **symbol_table = nullptr;
+
+  /* The dynamic symbol table, allocated the same way.  */
+  long dynsymcount = 0;
+  asymbol **dyn_symbol_table = nullptr;
+
+  /* The synthetic symbols, and the BFD they were computed from.  */
+  bfd *synth_abfd = nullptr;
+  long synthcount = 0;
+  gdb::unique_xmalloc_ptr<asymbol> synthsyms;
+};
 
-  symtab_create_debug_printf ("reading minimal symbols of objfile %s",
-			      objfile_name (objfile));
+/* Per-BFD symbol tables read ahead by elf_symfile_prefetch, and not
+   used by elf_read_minimal_symbols yet.  */
 
-  /* If we already have minsyms, then we can skip some work here.
-     However, if there were stabs or mdebug sections, we go ahead and
-     redo all the work anyway, because the psym readers for those
-     kinds of debuginfo need extra information found here.  This can
-     go away once all types of symbols are in the per-BFD object.  */
-  if (objfile->per_bfd->minsyms_read
-      && ei->stabsect == NULL
-      && ei->mdebugsect == NULL
-      && ei->ctfsect == NULL)
-    {
-      symtab_create_debug_printf ("minimal symbols were previously read");
-      return;
-    }
+static const registry<bfd>::key<elf_symbol_tables> symbol_tables_key;
 
-  minimal_symbol_reader reader (objfile);
-
-  /* Process the normal ELF symbol table first.  */
+/* Read the regular and dynamic symbol tables of ABFD into TABLES.
+   This only uses ABFD, so may be called from a worker thread.  */
 
-  storage_needed = bfd_get_symtab_upper_bound (objfile->obfd.get ());
+static void
+elf_read_symbol_tables (bfd *abfd, elf_symbol_tables *tables)
+{
+  long storage_needed = bfd_get_symtab_upper_bound (abfd);
   if (storage_needed < 0)
     error (_("Can't read symbols from %s: %s"),
-	   bfd_get_filename (objfile->obfd.get ()),
+	   bfd_get_filename (abfd),
 	   bfd_errmsg (bfd_get_error ()));
 
   if (storage_needed > 0)
@@ -1099,21 +1097,16 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
       /* Memory gets permanently referenced from ABFD after
 	 bfd_canonicalize_symtab so it must not get freed before ABFD gets.  */
 
-      symbol_table = (asymbol **) bfd_alloc (abfd, storage_needed);
-      symcount = bfd_canonicalize_symtab (objfile->obfd.get (), symbol_table);
+      tables->symbol_table = (asymbol **) bfd_alloc (abfd, storage_needed);
+      tables->symcount = bfd_canonicalize_symtab (abfd, tables->symbol_table);
 
-      if (symcount < 0)
+      if (tables->symcount < 0)
 	error (_("Can't read symbols from %s: %s"),
-	       bfd_get_filename (objfile->obfd.get ()),
+	       bfd_get_filename (abfd),
 	       bfd_errmsg (bfd_get_error ()));
-
-      elf_symtab_read (reader, objfile, ST_REGULAR, symcount, symbol_table,
-		       false);
     }
 
-  /* Add the dynamic symbols.  */
-
-  storage_needed = bfd_get_dynamic_symtab_upper_bound (objfile->obfd.get ());
+  storage_needed = bfd_get_dynamic_symtab_upper_bound (abfd);
 
   if (storage_needed > 0)
     {
@@ -1124,19 +1117,134 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
 	 done by _bfd_elf_get_synthetic_symtab which is all a bfd
 	 implementation detail, though.  */
 
-      dyn_symbol_table = (asymbol **) bfd_alloc (abfd, storage_needed);
-      dynsymcount = bfd_canonicalize_dynamic_symtab (objfile->obfd.get (),
-						     dyn_symbol_table);
+      tables->dyn_symbol_table = (asymbol **) bfd_alloc (abfd, storage_needed);
+      tables->dynsymcount
+	= bfd_canonicalize_dynamic_symtab (abfd, tables->dyn_symbol_table);
 
-      if (dynsymcount < 0)
+      if (tables->dynsymcount < 0)
 	error (_("Can't read symbols from %s: %s"),
-	       bfd_get_filename (objfile->obfd.get ()),
+	       bfd_get_filename (abfd),
 	       bfd_errmsg (bfd_get_error ()));
+    }
+}
+
+/* Compute the synthetic symbols of SYNTH_ABFD, for instance the names
+   of PLT entries, from the symbol tables in TABLES, and store them in
+   TABLES.  */
+
+static void
+elf_read_synthetic_symbols (bfd *synth_abfd, elf_symbol_tables *tables)
+{
+  asymbol *synthsyms = nullptr;
+
+  tables->synth_abfd = synth_abfd;
+  tables->synthcount
+    = bfd_get_synthetic_symtab (synth_abfd, tables->symcount,
+				tables->symbol_table, tables->dynsymcount,
+				tables->dyn_symbol_table, &synthsyms);
+  if (tables->synthcount > 0)
+    tables->synthsyms.reset (synthsyms);
+}
 
-      elf_symtab_read (reader, objfile, ST_DYNAMIC, dynsymcount,
-		       dyn_symbol_table, false);
+/* The sym_prefetch function for ELF.  Read the symbol tables of ABFD
+   ahead of elf_read_minimal_symbols.  */
 
-      elf_rel_plt_read (reader, objfile, dyn_symbol_table);
+static void
+elf_symfile_prefetch (bfd *abfd)
+{
+  if (symbol_tables_key.get (abfd) != nullptr)
+    return;
+
+  elf_symbol_tables tables;
+  try
+    {
+      elf_read_symbol_tables (abfd, &tables);
+
+      /* This assumes ABFD is not a separate debug file, which is
+	 checked by elf_read_minimal_symbols.  */
+      elf_read_synthetic_symbols (abfd, &tables);
+    }
+  catch (const gdb_exception_error &)
+    {
+      /* elf_read_minimal_symbols will try again, and report the
+	 error.  */
+      return;
+    }
+
+  symbol_tables_key.emplace (abfd, std::move (tables));
+}
+
+/* The sym_prefetch_release function for ELF.  Discard the symbol
+   tables read ahead for ABFD, if elf_read_minimal_symbols did not take
+   them.  The tables themselves live on ABFD's obstack, but the
+   synthetic symbols do not.  */
+
+static void
+elf_symfile_prefetch_release (bfd *abfd)
+{
+  if (symbol_tables_key.get (abfd) == nullptr)
+    return;
+
+  symtab_create_debug_printf ("discarding the symbols read ahead for %s",
+			      bfd_get_filename (abfd));
+  symbol_tables_key.clear (abfd);
+}
+
+/* A helper function for elf_symfile_read that reads the minimal
+   symbols.  */
+
+static void
+elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
+			  const struct elfinfo *ei)
+{
+  bfd *synth_abfd, *abfd = objfile->obfd.get ();
+
+  symtab_create_debug_printf ("reading minimal symbols of objfile %s",
+			      objfile_name (objfile));
+
+  /* Take the symbol tables read by elf_symfile_prefetch, if any.  */
+  elf_symbol_tables tables;
+  bool prefetched = false;
+  if (elf_symbol_tables *prefetched_tables = symbol_tables_key.get (abfd))
+    {
+      tables = std::move (*prefetched_tables);
+      symbol_tables_key.clear (abfd);
+      prefetched = true;
+    }
+
+  /* If we already have minsyms, then we can skip some work here.
+     However, if there were stabs or mdebug sections, we go ahead and
+     redo all the work anyway, because the psym readers for those
+     kinds of debuginfo need extra information found here.  This can
+     go away once all types of symbols are in the per-BFD object.  */
+  if (objfile->per_bfd->minsyms_read
+      && ei->stabsect == NULL
+      && ei->mdebugsect == NULL
+      && ei->ctfsect == NULL)
+    {
+      symtab_create_debug_printf ("minimal symbols were previously read");
+      return;
+    }
+
+  minimal_symbol_reader reader (objfile);
+
+  if (!prefetched)
+    elf_read_symbol_tables (abfd, &tables);
+
+  /* Process the normal ELF symbol table first.  */
+
+  if (tables.symcount > 0)
+    elf_symtab_read (reader, objfile, ST_REGULAR, tables.symcount,
+		     tables.symbol_table, false);
+
+  /* Add the dynamic symbols.  */
+
+  if (tables.dynsymcount > 0)
+    {
+      elf_symtab_read (reader, objfile, ST_DYNAMIC, tables.dynsymcount,
+		       tables.dyn_symbol_table, false);
+
+      elf_rel_plt_read (reader, objfile, tables.dyn_symbol_table);
     }
 
   /* Contrary to binutils --strip-debug/--only-keep-debug the strip command from
@@ -1158,22 +1266,18 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
 
   /* Add synthetic symbols - for instance, names for any PLT entries.  */
 
-  synthcount = bfd_get_synthetic_symtab (synth_abfd, symcount, symbol_table,
-					 dynsymcount, dyn_symbol_table,
-					 &synthsyms);
-  if (synthcount > 0)
+  if (tables.synth_abfd != synth_abfd)
+    elf_read_synthetic_symbols (synth_abfd, &tables);
+  if (tables.synthcount > 0)
     {
       long i;
 
       std::unique_ptr<asymbol *[]>
-	synth_symbol_table (new asymbol *[synthcount]);
-      for (i = 0; i < synthcount; i++)
-	synth_symbol_table[i] = synthsyms + i;
-      elf_symtab_read (reader, objfile, ST_SYNTHETIC, synthcount,
+	synth_symbol_table (new asymbol *[tables.synthcount]);
+      for (i = 0; i < tables.synthcount; i++)
+	synth_symbol_table[i] = tables.synthsyms.get () + i;
+      elf_symtab_read (reader, objfile, ST_SYNTHETIC, tables.synthcount,
 		       synth_symbol_table.get (), true);
-
-      xfree (synthsyms);
-      synthsyms = NULL;
     }
 
   /* Install any minimal symbols that have been collected as the current
@@ -1389,6 +1493,8 @@ static const struct sym_fns elf_sym_fns =
   NULL,
   default_symfile_relocate,	/* Relocate a debug section.  */
   &elf_probe_fns,		/* sym_probe_fns */
+  elf_symfile_prefetch,		/* sym_prefetch */
+  elf_symfile_prefetch_release,	/* sym_prefetch_release */
 };
 
 /* STT_GNU_IFUNC resolver vector to be installed to gnu_ifunc_fns_p.  */
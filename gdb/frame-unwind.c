@@ -205,9 +205,29 @@ frame_unwind_find_by_frame (const frame_info_ptr &this_frame, void **this_cache)
 				   unwinder_from_target))
     return;
 
+  /* What a previous stop computed for THIS_FRAME is only reused if
+     the unwinder that computed it is still the first one to claim the
+     frame.  The unwinders before it, like the dummy, inline, JIT,
+     extension language or sigtramp ones, get to sniff first.  */
+  persistent_frame *persistent = nullptr;
+  const frame_unwind *persistent_unwind
+    = frame_unwind_find_persistent (this_frame, &persistent);
+
   for (entry = table->list; entry != NULL; entry = entry->next)
-    if (frame_unwind_try_unwinder (this_frame, this_cache, entry->unwinder))
-      return;
+    {
+      if (entry->unwinder == persistent_unwind)
+	{
+	  frame_unwind_use_persistent (this_frame, this_cache, persistent);
+	  return;
+	}
+
+      if (frame_unwind_try_unwinder (this_frame, this_cache,
+				     entry->unwinder))
+	{
+	  frame_unwind_make_persistent (this_frame, this_cache);
+	  return;
+	}
+    }
 
   internal_error (_("frame_unwind_find_by_frame failed"));
 }
@@ -45,6 +45,8 @@
 #include "valprint.h"
 #include "cli/cli-option.h"
 #include "dwarf2/loc.h"
+#include <map>
+#include <unordered_map>
 
 /* The sentinel frame terminates the innermost end of the frame chain.
    If unwound, it returns the information needed to construct an
@@ -75,6 +77,24 @@ set_backtrace_options user_set_backtrace_options;
 static frame_info_ptr get_prev_frame_raw (const frame_info_ptr &this_frame);
 static const char *frame_stop_reason_symbol_string (enum unwind_stop_reason reason);
 static frame_info_ptr create_new_frame (frame_id id);
+static void persistent_frame_note_register (const frame_info_ptr &next_frame,
+					    int regnum, value *v);
+static void commit_persistent_frames ();
+static void invalidate_persistent_frames ();
+
+
+/* A frame whose real unwinder is running for the persistent unwind
+   cache, and its record.  See persistent_frame_note_register.  */
+
+struct persistent_frame;
+
+struct persistent_recording
+{
+  frame_info *frame;
+  persistent_frame *entry;
+};
+
+static std::vector<persistent_recording> persistent_recordings;
 
 /* Status of some values cached in the frame_info object.  */
 
@@ -1336,6 +1356,9 @@ frame_unwind_register_value (const frame_info_ptr &next_frame, int regnum)
       frame_debug_printf ("%s", debug_file.c_str ());
     }
 
+  if (!persistent_recordings.empty ())
+    persistent_frame_note_register (next_frame, regnum, value);
+
   return value;
 }
 
@@ -1664,6 +1687,14 @@ frame_obstack_zalloc (unsigned long size)
   return data;
 }
 
+/* See frame.h.  */
+
+size_t
+frame_cache_memory_used ()
+{
+  return obstack_memory_used (&frame_cache_obstack);
+}
+
 static frame_info_ptr get_prev_frame_always_1 (const frame_info_ptr &this_frame);
 
 frame_info_ptr
@@ -2101,6 +2132,9 @@ get_next_frame_sentinel_okay (const frame_info_ptr &this_frame)
 static void
 frame_observer_target_changed (struct target_ops *target)
 {
+  /* The user changed registers or memory, which the persistent frames
+     may not notice.  */
+  invalidate_persistent_frames ();
   reinit_frame_cache ();
 }
 
@@ -2139,9 +2173,584 @@ reinit_frame_cache (void)
   for (frame_info_ptr &iter : frame_info_ptr::frame_list)
     iter.invalidate ();
 
+  commit_persistent_frames ();
+
   frame_debug_printf ("generation=%d", frame_cache_generation);
 }
 
+/* The persistent unwind cache.
+
+   The low-level unwinder of each frame (sniffing, reading CFI,
+   analyzing prologues) runs again at every stop, even for the outer
+   frames of a deep stack that did not change.  When "maint set
+   persistent-unwind-cache" is on, what the unwinder of a normal frame
+   computed is kept across stops: the frame's ID and unwind stop
+   reason, and where the caller's registers are saved.  It is reused
+   for a frame with the same PC and stack pointer, if the registers
+   the unwinder read and the frame's stack memory are unchanged.
+
+   Frames reusing it have the persistent_frame_unwind unwinder, which
+   falls back to the real unwinder for whatever was not computed at a
+   previous stop.  */
+
+static bool persistent_unwind_cache = false;
+
+/* What the unwinder of a frame computed at a previous stop.  */
+
+struct persistent_frame
+{
+  /* What a frame must match to reuse this.  */
+  program_space *pspace;
+  gdbarch *arch;
+  CORE_ADDR pc;
+  CORE_ADDR sp;
+  frame_type next_type;
+  int inlined_callees;
+
+  /* The registers of the frame read by its unwinder, and their
+     contents.  */
+  std::vector<std::pair<int, gdb::byte_vector>> regs;
+
+  /* The contents of the frame's stack, from its stack pointer up to
+     the stack address of its ID.  */
+  gdb::byte_vector stack;
+
+  /* The real unwinder of the frame.  */
+  const frame_unwind *unwind;
+
+  /* The frame's ID and unwind stop reason, if computed.  */
+  bool id_p = false;
+  frame_id id;
+  bool stop_reason_p = false;
+  unwind_stop_reason stop_reason = UNWIND_NO_REASON;
+
+  /* Where a register of the previous frame was found.  */
+  struct saved_reg
+  {
+    /* lval_memory or lval_register for a register saved at ADDR or in
+       register REALNUM of the frame, not_lval for a register whose
+       value is VALUE, or nullptr if there was no value.  */
+    lval_type lval;
+    CORE_ADDR addr = 0;
+    int realnum = 0;
+    value_ref_ptr value;
+  };
+
+  /* The registers of the previous frame, by register number.  */
+  std::unordered_map<int, saved_reg> saved_regs;
+
+  /* Whether the previous frame was found.  Unwinders like the DWARF
+     one find tail call frames for the previous frame, which would be
+     missed if this was reused.  */
+  bool prev_known = false;
+
+  /* Set if this can't be reused.  */
+  bool invalid = false;
+};
+
+/* The largest frame whose stack is saved.  */
+
+static const size_t max_persistent_frame_stack = 64 * 1024;
+
+/* The most frames kept at the same PC and stack pointer, and in
+   total.  */
+
+static const size_t max_persistent_frames_per_key = 4;
+static const size_t max_persistent_frames = 64 * 1024;
+
+/* The frames that may be reused, by PC and stack pointer.  */
+
+static std::map<std::pair<CORE_ADDR, CORE_ADDR>,
+		std::vector<std::unique_ptr<persistent_frame>>>
+  persistent_frames;
+static size_t n_persistent_frames;
+
+/* The frames recorded since the last flush of the frame cache.  They
+   are added to PERSISTENT_FRAMES once the frames using them are
+   gone.  */
+
+static std::vector<std::unique_ptr<persistent_frame>>
+  pending_persistent_frames;
+
+/* Set when the persistent frames may no longer be right, because the
+   symbols changed.  They are discarded at the next flush of the frame
+   cache.  */
+
+static bool persistent_frames_stale;
+
+/* Record the registers of FRAME that its unwinder reads in ENTRY,
+   while this is in scope.  */
+
+class scoped_persistent_recording
+{
+public:
+  scoped_persistent_recording (const frame_info_ptr &frame,
+			       persistent_frame *entry)
+  {
+    persistent_recordings.push_back ({ frame.get (), entry });
+  }
+
+  ~scoped_persistent_recording ()
+  {
+    persistent_recordings.pop_back ();
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_persistent_recording);
+};
+
+/* The prologue cache of a frame with the persistent_frame_unwind
+   unwinder.  */
+
+struct persistent_frame_cache
+{
+  persistent_frame *entry;
+
+  /* Whether the real unwinder was sniffed, and its prologue
+     cache.  */
+  bool sniffed;
+  void *real_cache;
+};
+
+/* Called by frame_unwind_register_value after reading the value V of
+   register REGNUM of the frame above NEXT_FRAME.  */
+
+static void
+persistent_frame_note_register (const frame_info_ptr &next_frame,
+				int regnum, value *v)
+{
+  for (const persistent_recording &rec : persistent_recordings)
+    if (rec.frame->next == next_frame.get ())
+      {
+	persistent_frame *entry = rec.entry;
+
+	if (regnum >= gdbarch_num_regs (entry->arch))
+	  return;
+	for (const auto &reg : entry->regs)
+	  if (reg.first == regnum)
+	    return;
+
+	try
+	  {
+	    if (v->optimized_out () || !v->entirely_available ())
+	      entry->invalid = true;
+	    else
+	      {
+		gdb::array_view<const gdb_byte> contents = v->contents ();
+		entry->regs.emplace_back (regnum,
+					  gdb::byte_vector (contents.begin (),
+							    contents.end ()));
+	      }
+	  }
+	catch (const gdb_exception_error &ex)
+	  {
+	    entry->invalid = true;
+	  }
+	return;
+      }
+}
+
+/* Save the stack of the frame of ENTRY, whose ID was just
+   computed.  */
+
+static void
+persistent_frame_save_stack (persistent_frame *entry)
+{
+  if (entry->id.stack_status != FID_STACK_VALID
+      || entry->id.stack_addr < entry->sp
+      || entry->id.stack_addr - entry->sp > max_persistent_frame_stack)
+    {
+      entry->invalid = true;
+      return;
+    }
+
+  entry->stack.resize (entry->id.stack_addr - entry->sp);
+  if (target_read_stack (entry->sp, entry->stack.data (),
+			 entry->stack.size ()) != 0)
+    entry->invalid = true;
+}
+
+/* Return the real unwinder of THIS_FRAME, whose prologue cache is
+   CACHE, sniffing it first if needed.  */
+
+static const frame_unwind *
+persistent_frame_real_unwinder (const frame_info_ptr &this_frame,
+				persistent_frame_cache *cache)
+{
+  const frame_unwind *unwind = cache->entry->unwind;
+
+  if (!cache->sniffed)
+    {
+      scoped_persistent_recording recording (this_frame, cache->entry);
+
+      if (!unwind->sniffer (unwind, this_frame, &cache->real_cache))
+	{
+	  cache->entry->invalid = true;
+	  error (_("Unwinder \"%s\" no longer claims frame %d"),
+		 unwind->name, this_frame->level);
+	}
+      cache->sniffed = true;
+    }
+
+  return unwind;
+}
+
+static enum unwind_stop_reason
+persistent_frame_stop_reason (const frame_info_ptr &this_frame,
+			      void **this_cache)
+{
+  auto *cache = (persistent_frame_cache *) *this_cache;
+  persistent_frame *entry = cache->entry;
+
+  if (!entry->stop_reason_p)
+    {
+      const frame_unwind *unwind
+	= persistent_frame_real_unwinder (this_frame, cache);
+      scoped_persistent_recording recording (this_frame, entry);
+
+      entry->stop_reason = unwind->stop_reason (this_frame,
+						&cache->real_cache);
+      entry->stop_reason_p = true;
+    }
+
+  return entry->stop_reason;
+}
+
+static void
+persistent_frame_this_id (const frame_info_ptr &this_frame,
+			  void **this_cache, struct frame_id *this_id)
+{
+  auto *cache = (persistent_frame_cache *) *this_cache;
+  persistent_frame *entry = cache->entry;
+
+  if (!entry->id_p)
+    {
+      const frame_unwind *unwind
+	= persistent_frame_real_unwinder (this_frame, cache);
+
+      {
+	scoped_persistent_recording recording (this_frame, entry);
+	unwind->this_id (this_frame, &cache->real_cache, this_id);
+      }
+
+      entry->id = *this_id;
+      entry->id_p = true;
+      persistent_frame_save_stack (entry);
+    }
+
+  *this_id = entry->id;
+}
+
+static struct value *
+persistent_frame_prev_register (const frame_info_ptr &this_frame,
+				void **this_cache, int regnum)
+{
+  auto *cache = (persistent_frame_cache *) *this_cache;
+  persistent_frame *entry = cache->entry;
+
+  auto iter = entry->saved_regs.find (regnum);
+  if (iter != entry->saved_regs.end ())
+    {
+      const persistent_frame::saved_reg &saved = iter->second;
+
+      switch (saved.lval)
+	{
+	case lval_memory:
+	  return frame_unwind_got_memory (this_frame, regnum, saved.addr);
+	case lval_register:
+	  return frame_unwind_got_register (this_frame, regnum,
+					    saved.realnum);
+	default:
+	  return saved.value != nullptr ? saved.value->copy () : nullptr;
+	}
+    }
+
+  const frame_unwind *unwind
+    = persistent_frame_real_unwinder (this_frame, cache);
+  value *v;
+  {
+    scoped_persistent_recording recording (this_frame, entry);
+    v = unwind->prev_register (this_frame, &cache->real_cache, regnum);
+  }
+
+  /* Remember where the register was found, if that can be
+     described without the unwinder.  */
+  type *reg_type = register_type (entry->arch, regnum);
+  persistent_frame::saved_reg saved;
+  if (v == nullptr)
+    saved.lval = not_lval;
+  else if (v->lval () == lval_memory
+	   && v->offset () == 0
+	   && v->type () == reg_type)
+    {
+      saved.lval = lval_memory;
+      saved.addr = v->address ();
+    }
+  else if (v->lval () == lval_register
+	   && v->offset () == 0
+	   && v->type () == reg_type
+	   && (v->next_frame_id ()
+	       == get_frame_id (get_next_frame_sentinel_okay (this_frame))))
+    {
+      saved.lval = lval_register;
+      saved.realnum = v->regnum ();
+    }
+  else if (v->lval () == not_lval && !v->lazy ())
+    {
+      saved.lval = not_lval;
+      saved.value = release_value (v->copy ());
+    }
+  else
+    return v;
+
+  entry->saved_regs.emplace (regnum, std::move (saved));
+  return v;
+}
+
+static int
+persistent_frame_sniffer (const struct frame_unwind *self,
+			  const frame_info_ptr &this_frame,
+			  void **this_cache)
+{
+  /* Only installed by frame_unwind_find_persistent.  */
+  return 0;
+}
+
+static void
+persistent_frame_dealloc_cache (frame_info *self, void *this_cache)
+{
+  auto *cache = (persistent_frame_cache *) this_cache;
+  const frame_unwind *unwind = cache->entry->unwind;
+
+  if (cache->sniffed && unwind->dealloc_cache != nullptr)
+    unwind->dealloc_cache (self, cache->real_cache);
+}
+
+static const struct frame_unwind persistent_frame_unwind =
+{
+  "persistent",
+  NORMAL_FRAME,
+  persistent_frame_stop_reason,
+  persistent_frame_this_id,
+  persistent_frame_prev_register,
+  nullptr,
+  persistent_frame_sniffer,
+  persistent_frame_dealloc_cache,
+};
+
+/* Note that the unwinder of THIS_FRAME was found, for the record of
+   the next frame, if any.  */
+
+static void
+persistent_frame_note_prev (const frame_info_ptr &this_frame)
+{
+  frame_info *next = this_frame->next;
+
+  if (next == nullptr || next->unwind != &persistent_frame_unwind)
+    return;
+
+  auto *cache = (persistent_frame_cache *) next->prologue_cache;
+  if (this_frame->unwind->type == TAILCALL_FRAME)
+    cache->entry->invalid = true;
+  else
+    cache->entry->prev_known = true;
+}
+
+/* Return true if THIS_FRAME, whose next frame is of type NEXT_TYPE
+   and has INLINED_CALLEES inline frames below it, can reuse
+   ENTRY.  */
+
+static bool
+persistent_frame_matches (const frame_info_ptr &this_frame,
+			  const persistent_frame &entry,
+			  frame_type next_type, int inlined_callees)
+{
+  if (entry.invalid
+      || entry.pspace != this_frame->pspace
+      || entry.arch != get_frame_arch (this_frame)
+      || entry.next_type != next_type
+      || entry.inlined_callees != inlined_callees)
+    return false;
+
+  try
+    {
+      frame_info_ptr next_frame (this_frame->next);
+
+      for (const auto &[regnum, contents] : entry.regs)
+	{
+	  value *v = frame_unwind_register_value (next_frame, regnum);
+
+	  if (v->optimized_out () || !v->entirely_available ())
+	    return false;
+
+	  gdb::array_view<const gdb_byte> now = v->contents ();
+	  if (now.size () != contents.size ()
+	      || memcmp (now.data (), contents.data (), now.size ()) != 0)
+	    return false;
+	}
+
+      gdb::byte_vector stack (entry.stack.size ());
+      if (target_read_stack (entry.sp, stack.data (), stack.size ()) != 0
+	  || stack != entry.stack)
+	return false;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/* See frame.h.  */
+
+const frame_unwind *
+frame_unwind_find_persistent (const frame_info_ptr &this_frame,
+			      persistent_frame **entryp)
+{
+  if (!persistent_unwind_cache
+      || persistent_frames_stale
+      || persistent_frames.empty ()
+      || this_frame->level <= 0)
+    return nullptr;
+
+  CORE_ADDR pc, sp;
+  frame_type next_type;
+  int inlined_callees;
+  try
+    {
+      pc = get_frame_pc (this_frame);
+      sp = get_frame_sp (this_frame);
+      next_type = get_frame_type (frame_info_ptr (this_frame->next));
+      inlined_callees = frame_inlined_callees (this_frame);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return nullptr;
+    }
+
+  auto iter = persistent_frames.find (std::make_pair (pc, sp));
+  if (iter == persistent_frames.end ())
+    return nullptr;
+
+  for (const std::unique_ptr<persistent_frame> &entry : iter->second)
+    if (persistent_frame_matches (this_frame, *entry, next_type,
+				  inlined_callees))
+      {
+	*entryp = entry.get ();
+	return entry->unwind;
+      }
+
+  return nullptr;
+}
+
+/* See frame.h.  */
+
+void
+frame_unwind_use_persistent (const frame_info_ptr &this_frame,
+			     void **this_cache, persistent_frame *entry)
+{
+  frame_debug_printf ("frame %d reuses unwind of %s",
+		      this_frame->level, entry->id.to_string ().c_str ());
+
+  auto *cache = FRAME_OBSTACK_ZALLOC (persistent_frame_cache);
+  cache->entry = entry;
+  frame_prepare_for_sniffer (this_frame, &persistent_frame_unwind);
+  *this_cache = cache;
+  persistent_frame_note_prev (this_frame);
+}
+
+/* See frame.h.  */
+
+void
+frame_unwind_make_persistent (const frame_info_ptr &this_frame,
+			      void **this_cache)
+{
+  if (!persistent_unwind_cache || persistent_frames_stale)
+    return;
+
+  const frame_unwind *unwind = this_frame->unwind;
+
+  persistent_frame_note_prev (this_frame);
+
+  if (this_frame->level <= 0
+      || unwind->type != NORMAL_FRAME
+      || unwind->prev_arch != nullptr)
+    return;
+
+  auto entry = std::make_unique<persistent_frame> ();
+  try
+    {
+      entry->pc = get_frame_pc (this_frame);
+      entry->sp = get_frame_sp (this_frame);
+      entry->next_type = get_frame_type (frame_info_ptr (this_frame->next));
+      entry->inlined_callees = frame_inlined_callees (this_frame);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return;
+    }
+  entry->pspace = this_frame->pspace;
+  entry->arch = get_frame_arch (this_frame);
+  entry->unwind = unwind;
+
+  auto *cache = FRAME_OBSTACK_ZALLOC (persistent_frame_cache);
+  cache->entry = entry.get ();
+  cache->sniffed = true;
+  cache->real_cache = *this_cache;
+  this_frame->unwind = &persistent_frame_unwind;
+  *this_cache = cache;
+
+  pending_persistent_frames.push_back (std::move (entry));
+}
+
+/* Called by reinit_frame_cache once the frames are gone.  Keep the
+   frames recorded meanwhile for reuse.  */
+
+static void
+commit_persistent_frames ()
+{
+  if (persistent_frames_stale || !persistent_unwind_cache)
+    {
+      persistent_frames.clear ();
+      n_persistent_frames = 0;
+      pending_persistent_frames.clear ();
+      persistent_frames_stale = false;
+      return;
+    }
+
+  if (n_persistent_frames + pending_persistent_frames.size ()
+      > max_persistent_frames)
+    {
+      persistent_frames.clear ();
+      n_persistent_frames = 0;
+    }
+
+  for (std::unique_ptr<persistent_frame> &entry : pending_persistent_frames)
+    if (!entry->invalid && entry->id_p && entry->prev_known)
+      {
+	auto &slot = persistent_frames[std::make_pair (entry->pc, entry->sp)];
+
+	if (slot.size () >= max_persistent_frames_per_key)
+	  {
+	    slot.erase (slot.begin ());
+	    n_persistent_frames--;
+	  }
+	slot.push_back (std::move (entry));
+	n_persistent_frames++;
+      }
+
+  pending_persistent_frames.clear ();
+}
+
+/* Discard the persistent frames at the next flush of the frame
+   cache.  */
+
+static void
+invalidate_persistent_frames ()
+{
+  persistent_frames_stale = true;
+}
+
 /* Find where a register is saved (in memory or another register).
    The result of frame_register_unwind is just where it is saved
    relative to this particular frame.  */
@@ -2969,6 +3578,12 @@ frame_unwinder_is (const frame_info_ptr &fi, const frame_unwind *unwinder)
   if (fi->unwind == nullptr)
     frame_unwind_find_by_frame (fi, &fi->prologue_cache);
 
+  if (fi->unwind == &persistent_frame_unwind)
+    {
+      auto *cache = (persistent_frame_cache *) fi->prologue_cache;
+      return cache->entry->unwind == unwinder;
+    }
+
   return fi->unwind == unwinder;
 }
 
@@ -3422,6 +4037,12 @@ _initialize_frame ()
 
   gdb::observers::target_changed.attach (frame_observer_target_changed,
 					 "frame");
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *) { invalidate_persistent_frames (); }, "frame");
+  gdb::observers::free_objfile.attach
+    ([] (struct objfile *) { invalidate_persistent_frames (); }, "frame");
+  gdb::observers::inferior_exit.attach
+    ([] (struct inferior *) { invalidate_persistent_frames (); }, "frame");
 
   add_setshow_prefix_cmd ("backtrace", class_maintenance,
 			  _("\
@@ -3457,6 +4078,21 @@ When non-zero, frame specific internal debugging is enabled."),
 			   show_frame_debug,
 			   &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("persistent-unwind-cache", class_maintenance,
+			   &persistent_unwind_cache, _("\
+Set whether frame unwinding results are kept across stops."), _("\
+Show whether frame unwinding results are kept across stops."), _("\
+When on, what the unwinder of a frame computed is reused at later stops\n\
+for a frame at the same code and stack addresses, if the registers and\n\
+the stack memory the unwinder depends on are unchanged."),
+			   [] (const char *, int, cmd_list_element *)
+			     {
+			       invalidate_persistent_frames ();
+			     },
+			   nullptr,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_cmd ("frame-id", class_maintenance, maintenance_print_frame_id,
 	   _("Print the current frame-id."),
 	   &maintenanceprintlist);
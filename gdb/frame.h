@@ -822,6 +822,10 @@ enum print_what
    allocate memory using this method.  */
 
 extern void *frame_obstack_zalloc (unsigned long size);
+
+/* Return the number of bytes of memory used by the frame cache.  */
+
+extern size_t frame_cache_memory_used ();
 #define FRAME_OBSTACK_ZALLOC(TYPE) \
   ((TYPE *) frame_obstack_zalloc (sizeof (TYPE)))
 #define FRAME_OBSTACK_CALLOC(NUMBER,TYPE) \
@@ -984,6 +988,29 @@ extern void frame_prepare_for_sniffer (const frame_info_ptr &frame,
 
 extern void frame_cleanup_after_sniffer (const frame_info_ptr &frame);
 
+struct persistent_frame;
+
+/* If FRAME can reuse what its unwinder computed at a previous stop,
+   return that unwinder and set *ENTRY to what it computed.  Otherwise
+   return NULL.  See "maint set persistent-unwind-cache".  */
+
+extern const frame_unwind *
+  frame_unwind_find_persistent (const frame_info_ptr &frame,
+				persistent_frame **entry);
+
+/* Set the unwinder of FRAME and its prologue cache *THIS_CACHE for
+   reusing ENTRY, as found by frame_unwind_find_persistent.  */
+
+extern void frame_unwind_use_persistent (const frame_info_ptr &frame,
+					 void **this_cache,
+					 persistent_frame *entry);
+
+/* Record what the unwinder just found for FRAME computes, for reuse at
+   later stops.  */
+
+extern void frame_unwind_make_persistent (const frame_info_ptr &frame,
+					  void **this_cache);
+
 /* Notes (cagney/2002-11-27, drow/2003-09-06):
 
    You might think that calls to this function can simply be replaced by a
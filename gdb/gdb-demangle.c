@@ -29,6 +29,11 @@
 #include "demangle.h"
 #include "gdb-demangle.h"
 #include "language.h"
+#include <atomic>
+#include <unordered_map>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 /* Select the default C++ demangling style to use.  The default is "auto",
    which allows gdb to attempt to pick an appropriate demangling style for
@@ -86,6 +91,168 @@ show_demangling_style_names(struct ui_file *file, int from_tty,
 	      value);
 }
 
+/* The demangled name cache.  Demangling and canonicalizing names are
+   pure functions of the name, its language and the demangling style,
+   and the same names, such as those of template instances from common
+   headers, are often found in many objfiles.  So the results are
+   cached for all the objfiles, and kept when objfiles are unloaded.
+
+   The cache is split into shards, each with its own lock, so that the
+   worker threads that read symbols rarely wait for each other.  */
+
+/* The maximum number of entries in the demangled name cache, set by
+   "maint set demangle-cache-size".  Once the cache is full, new results
+   are not added to it.  */
+
+static unsigned int demangle_cache_size = 1 << 18;
+
+/* A cached result.  */
+
+struct demangle_cache_entry
+{
+  enum language lang;
+  gdb::unique_xmalloc_ptr<char> result;
+};
+
+/* A shard of the demangled name cache.  The key is the kind of result,
+   the language of the name and the name, concatenated.  */
+
+struct demangle_cache_shard
+{
+#if CXX_STD_THREAD
+  std::mutex lock;
+#endif
+  std::unordered_map<std::string, demangle_cache_entry> entries;
+};
+
+/* The number of shards.  A power of 2.  */
+
+static constexpr size_t demangle_cache_n_shards = 64;
+
+static demangle_cache_shard demangle_cache[demangle_cache_n_shards];
+
+/* The number of entries in all the shards.  */
+
+static std::atomic<size_t> demangle_cache_count;
+
+/* Return a copy of NAME, which may be NULL.  */
+
+static gdb::unique_xmalloc_ptr<char>
+copy_demangled_name (const char *name)
+{
+  if (name == nullptr)
+    return nullptr;
+  return make_unique_xstrdup (name);
+}
+
+/* Remove all the entries of the demangled name cache.  */
+
+static void
+demangle_cache_clear ()
+{
+  for (demangle_cache_shard &shard : demangle_cache)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (shard.lock);
+#endif
+      shard.entries.clear ();
+    }
+  demangle_cache_count = 0;
+}
+
+/* See gdb-demangle.h.  */
+
+gdb::unique_xmalloc_ptr<char>
+demangle_cache_lookup (demangle_cache_kind kind, enum language *lang,
+		       const char *name, demangle_cache_compute_ftype compute)
+{
+  if (demangle_cache_size == 0)
+    return compute (lang);
+
+  std::string key;
+  key.reserve (strlen (name) + 2);
+  key += (char) kind;
+  key += (char) *lang;
+  key += name;
+
+  demangle_cache_shard &shard
+    = demangle_cache[(std::hash<std::string> () (key)
+		      & (demangle_cache_n_shards - 1))];
+
+  {
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (shard.lock);
+#endif
+    auto it = shard.entries.find (key);
+    if (it != shard.entries.end ())
+      {
+	*lang = it->second.lang;
+	return copy_demangled_name (it->second.result.get ());
+      }
+  }
+
+  /* Compute the result without holding the lock, so that other
+     threads can use the shard meanwhile.  */
+  gdb::unique_xmalloc_ptr<char> result = compute (lang);
+
+  if (demangle_cache_count < demangle_cache_size)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (shard.lock);
+#endif
+      auto inserted
+	= shard.entries.emplace (std::move (key),
+				 demangle_cache_entry
+				   { *lang,
+				     copy_demangled_name
+				       (result.get ()) });
+      if (inserted.second)
+	++demangle_cache_count;
+    }
+
+  return result;
+}
+
+/* See gdb-demangle.h.  */
+
+size_t
+demangle_cache_memory_used ()
+{
+  size_t result = 0;
+  for (demangle_cache_shard &shard : demangle_cache)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (shard.lock);
+#endif
+      result += shard.entries.bucket_count () * sizeof (void *);
+      for (const auto &iter : shard.entries)
+	{
+	  result += sizeof (iter) + iter.first.capacity ();
+	  if (iter.second.result != nullptr)
+	    result += strlen (iter.second.result.get ()) + 1;
+	}
+    }
+  return result;
+}
+
+/* Implement "maint set demangle-cache-size".  */
+
+static void
+set_demangle_cache_size (const char *args, int from_tty,
+			 struct cmd_list_element *c)
+{
+  demangle_cache_clear ();
+}
+
+/* Implement "maint show demangle-cache-size".  */
+
+static void
+show_demangle_cache_size (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("The demangled name cache size is %s.\n"), value);
+}
+
 /* Set current demangling style.  Called by the "set demangle-style"
    command after it has updated the current_demangling_style_string to
    match what the user has entered.
@@ -131,6 +298,9 @@ set_demangling_command (const char *ignore,
   /* We should have found a match, given we only add known styles to
      the enumeration list.  */
   gdb_assert (dem->demangling_style != unknown_demangling);
+
+  /* The cached names may have been demangled with another style.  */
+  demangle_cache_clear ();
 }
 
 /* G++ uses a special character to indicate certain internal names.  Which
@@ -257,6 +427,19 @@ Use `set demangle-style' without arguments for a list of demangling styles."),
 			show_demangling_style_names,
 			&setlist, &showlist);
 
+  add_setshow_zuinteger_cmd ("demangle-cache-size", class_maintenance,
+			     &demangle_cache_size, _("\
+Set the size of the demangled name cache."), _("\
+Show the size of the demangled name cache."), _("\
+The demangled name cache holds the results of demangling and\n\
+canonicalizing symbol names, for all the object files.  This is the\n\
+maximum number of names it holds.  Zero disables the cache.\n\
+Changing the size empties the cache."),
+			     set_demangle_cache_size,
+			     show_demangle_cache_size,
+			     &maintenance_set_cmdlist,
+			     &maintenance_show_cmdlist);
+
   add_cmd ("demangle", class_support, demangle_command, _("\
 Demangle a mangled name.\n\
 Usage: demangle [-l LANGUAGE] [--] NAME\n\
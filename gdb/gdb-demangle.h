@@ -19,6 +19,8 @@
 #ifndef GDB_DEMANGLE_H
 #define GDB_DEMANGLE_H
 
+#include "gdbsupport/function-view.h"
+
 /* True means that encoded C++/ObjC names should be printed out in their
    C++/ObjC form rather than raw.  */
 extern bool demangle;
@@ -31,4 +33,39 @@ extern bool asm_demangle;
 /* Check if a character is one of the commonly used C++ marker characters.  */
 extern bool is_cplus_marker (int);
 
+/* The kinds of results held in the demangled name cache.  */
+
+enum class demangle_cache_kind : unsigned char
+{
+  /* The demangled name of a symbol, as computed by
+     symbol_find_demangled_name.  */
+  SYMBOL,
+
+  /* The canonical form of a C++ name, as computed by
+     cp_canonicalize_string.  */
+  CPLUS_CANONICAL,
+};
+
+/* The function called by demangle_cache_lookup to compute a result
+   missing from the cache.  It may update *LANG, see below.  */
+
+using demangle_cache_compute_ftype
+  = gdb::function_view<gdb::unique_xmalloc_ptr<char> (enum language *lang)>;
+
+/* Return the result of the kind KIND for NAME, from the cache shared by
+   all the objfiles if it is there, or else from COMPUTE, in which case
+   it is added to the cache.  On entry, *LANG is the language of NAME,
+   which is part of the key.  On return, it is the language COMPUTE
+   found.  The result, which may be NULL, is a copy owned by the
+   caller.  This may be called from worker threads.  */
+
+extern gdb::unique_xmalloc_ptr<char> demangle_cache_lookup
+  (demangle_cache_kind kind, enum language *lang, const char *name,
+   demangle_cache_compute_ftype compute);
+
+/* Return the number of bytes of memory used by the demangled name
+   cache.  */
+
+extern size_t demangle_cache_memory_used ();
+
 #endif /* GDB_DEMANGLE_H */
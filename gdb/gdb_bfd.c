@@ -23,6 +23,12 @@
 #include "cli/cli-cmds.h"
 #include "hashtab.h"
 #include "gdbsupport/filestuff.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/scoped_fd.h"
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #ifdef HAVE_MMAP
 #include <sys/mman.h>
 #ifndef MAP_FAILED
@@ -32,6 +38,7 @@
 #include "target.h"
 #include "gdbsupport/fileio.h"
 #include "inferior.h"
+#include "target-file-cache.h"
 #include "cli/cli-style.h"
 #include <unordered_map>
 
@@ -168,6 +175,20 @@ show_bfd_sharing  (struct ui_file *file, int from_tty,
   gdb_printf (file, _("BFD sharing is %s.\n"), value);
 }
 
+/* When true, large compressed sections are decompressed into a
+   temporary file which is then mapped into memory, rather than into
+   memory directly.  */
+
+static bool bfd_decompress_to_file = true;
+
+static void
+show_bfd_decompress_to_file (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Decompressing large BFD sections to a temporary "
+		      "file is %s.\n"), value);
+}
+
 /* When true debugging of the bfd caches is enabled.  */
 
 static bool debug_bfd_cache;
@@ -516,13 +537,31 @@ gdb_bfd_open (const char *name, const char *target, int fd,
 	{
 	  gdb_assert (fd == -1);
 
+	  gdb_bfd_ref_ptr result = target_file_cache_take_prefetched (name,
+								      target);
+	  if (result != nullptr)
+	    return result;
+
 	  auto open = [&] (bfd *nbfd) -> gdb_bfd_iovec_base *
 	  {
 	    return gdb_bfd_iovec_fileio_open (nbfd, current_inferior (),
 					      warn_if_slow);
 	  };
 
-	  return gdb_bfd_openr_iovec (name, target, open);
+	  result = gdb_bfd_openr_iovec (name, target, open);
+
+	  /* Read a local copy of the file instead, if the target file
+	     cache is enabled.  Identifying the file only takes a few
+	     reads through RESULT.  */
+	  if (result != nullptr)
+	    {
+	      gdb_bfd_ref_ptr cached
+		= target_file_cache_open (result.get (), target);
+	      if (cached != nullptr)
+		return cached;
+	    }
+
+	  return result;
 	}
 
       name += strlen (TARGET_SYSROOT_PREFIX);
@@ -762,6 +801,200 @@ get_section_descriptor (asection *section)
   return result;
 }
 
+#ifdef HAVE_MMAP
+
+/* Compressed sections whose uncompressed size is smaller than this are
+   always decompressed in memory.  */
+
+static constexpr bfd_size_type decompress_to_file_min_size = 16 * 1024 * 1024;
+
+/* The size of the buffers holding compressed and uncompressed data
+   while decompressing a section to a file.  */
+
+static constexpr size_t decompress_chunk_size = 1024 * 1024;
+
+/* Decompress the compressed section SECTP a chunk at a time, and call
+   WRITE with each chunk of uncompressed data.  WRITE returns false on
+   error.  Return true on success.  */
+
+static bool
+decompress_section_chunks
+  (asection *sectp,
+   gdb::function_view<bool (const gdb_byte *data, size_t size)> write)
+{
+  bfd *abfd = sectp->owner;
+  bool is_zstd = sectp->compress_status == DECOMPRESS_SECTION_ZSTD;
+
+  /* Skip the compression header, as BFD does.  */
+  bfd_size_type offset = bfd_get_compression_header_size (abfd, sectp);
+  if (offset == 0)
+    offset = 12;
+  if (offset > sectp->compressed_size)
+    return false;
+
+  std::vector<gdb_byte> in (decompress_chunk_size);
+  std::vector<gdb_byte> out (decompress_chunk_size);
+
+  /* Read the next chunk of compressed data into IN.  Return its size,
+     0 at the end of the section, or -1 on error.  */
+  auto read_chunk = [&] () -> ssize_t
+    {
+      bfd_size_type n = std::min<bfd_size_type> (in.size (),
+						 (sectp->compressed_size
+						  - offset));
+      if (n == 0)
+	return 0;
+      if (bfd_seek (abfd, sectp->filepos + offset, SEEK_SET) != 0
+	  || bfd_read (in.data (), n, abfd) != n)
+	return -1;
+      offset += n;
+      return n;
+    };
+
+  if (is_zstd)
+    {
+#ifdef HAVE_ZSTD
+      ZSTD_DStream *zds = ZSTD_createDStream ();
+      if (zds == nullptr)
+	return false;
+      SCOPE_EXIT { ZSTD_freeDStream (zds); };
+
+      /* The streaming interface handles sections made of several
+	 frames.  */
+      ssize_t n;
+      while ((n = read_chunk ()) > 0)
+	{
+	  ZSTD_inBuffer input = { in.data (), (size_t) n, 0 };
+	  while (input.pos < input.size)
+	    {
+	      ZSTD_outBuffer output = { out.data (), out.size (), 0 };
+	      size_t ret = ZSTD_decompressStream (zds, &output, &input);
+	      if (ZSTD_isError (ret) || !write (out.data (), output.pos))
+		return false;
+	    }
+	}
+      return n == 0;
+#else
+      return false;
+#endif
+    }
+
+  z_stream strm;
+  memset (&strm, 0, sizeof strm);
+  if (inflateInit (&strm) != Z_OK)
+    return false;
+  SCOPE_EXIT { inflateEnd (&strm); };
+
+  /* The section may consist of several compressed streams concatenated
+     together.  */
+  bool at_stream_end = false;
+  while (true)
+    {
+      if (strm.avail_in == 0)
+	{
+	  ssize_t n = read_chunk ();
+	  if (n < 0)
+	    return false;
+	  if (n == 0)
+	    return at_stream_end;
+	  strm.next_in = (Bytef *) in.data ();
+	  strm.avail_in = n;
+	}
+
+      if (at_stream_end)
+	{
+	  if (inflateReset (&strm) != Z_OK)
+	    return false;
+	  at_stream_end = false;
+	}
+
+      strm.next_out = (Bytef *) out.data ();
+      strm.avail_out = out.size ();
+      int rc = inflate (&strm, Z_NO_FLUSH);
+      if (rc != Z_OK && rc != Z_STREAM_END)
+	return false;
+      if (!write (out.data (), out.size () - strm.avail_out))
+	return false;
+      at_stream_end = rc == Z_STREAM_END;
+    }
+}
+
+/* Try to decompress the compressed section SECTP into an unlinked
+   temporary file, and map that file into memory.  Unlike data
+   decompressed into memory, the pages of the map are only read when
+   they are used, and the kernel can drop them again when memory is
+   short, so memory use stays proportional to the part of the section
+   that is actually used.  The data is decompressed a chunk at a time,
+   so the whole compressed section isn't held in memory either.
+
+   On success, fill in DESCRIPTOR and return true.  */
+
+static bool
+decompress_section_to_file (asection *sectp,
+			    struct gdb_bfd_section_data *descriptor)
+{
+  if (!bfd_decompress_to_file
+      || (sectp->compress_status != DECOMPRESS_SECTION_ZLIB
+	  && sectp->compress_status != DECOMPRESS_SECTION_ZSTD)
+      || bfd_section_size (sectp) < decompress_to_file_min_size)
+    return false;
+
+  bfd *abfd = sectp->owner;
+  size_t size = bfd_section_size (sectp);
+
+  std::string name;
+  try
+    {
+      name = get_standard_temp_dir () + "/gdb-section-XXXXXX";
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return false;
+    }
+
+  scoped_fd fd = gdb_mkostemp_cloexec (&name[0]);
+  if (fd.get () < 0)
+    return false;
+  unlink (name.c_str ());
+
+  size_t written = 0;
+  auto write_chunk = [&] (const gdb_byte *data, size_t n)
+    {
+      if (n > size - written)
+	return false;
+      while (n > 0)
+	{
+	  ssize_t ret = write (fd.get (), data, n);
+	  if (ret < 0 && errno == EINTR)
+	    continue;
+	  if (ret <= 0)
+	    return false;
+	  data += ret;
+	  n -= ret;
+	  written += ret;
+	}
+      return true;
+    };
+
+  if (!decompress_section_chunks (sectp, write_chunk) || written != size)
+    return false;
+
+  void *data = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd.get (), 0);
+  if (data == MAP_FAILED)
+    return false;
+
+  bfd_cache_debug_printf ("Decompressed section %s of %s to a file",
+			  bfd_section_name (sectp), bfd_get_filename (abfd));
+
+  descriptor->size = size;
+  descriptor->data = data;
+  descriptor->map_addr = data;
+  descriptor->map_len = size;
+  return true;
+}
+
+#endif /* HAVE_MMAP */
+
 /* See gdb_bfd.h.  */
 
 const gdb_byte *
@@ -815,6 +1048,8 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 	  memset (descriptor, 0, sizeof (*descriptor));
 	}
     }
+  else if (decompress_section_to_file (sectp, descriptor))
+    goto done;
 #endif /* HAVE_MMAP */
 
   /* Handle compressed sections, or ordinary uncompressed sections in
@@ -1291,6 +1526,20 @@ filename, file size, file modification time, and file inode."),
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
 
+  add_setshow_boolean_cmd ("bfd-decompress-to-file", class_maintenance,
+			   &bfd_decompress_to_file, _("\
+Set whether large compressed sections are decompressed to a file."), _("\
+Show whether large compressed sections are decompressed to a file."), _("\
+When enabled, gdb decompresses large compressed sections, such as\n\
+compressed DWARF sections, a chunk at a time into a temporary file,\n\
+and maps that file into memory.  Only the parts of the section that\n\
+are used are then brought into memory.  When disabled, such sections\n\
+are decompressed into memory as a whole."),
+			   NULL,
+			   &show_bfd_decompress_to_file,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_setshow_boolean_cmd ("bfd-cache", class_maintenance,
 			   &debug_bfd_cache,
 			   _("Set bfd cache debugging."),
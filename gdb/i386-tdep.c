@@ -23,6 +23,7 @@
 #include "command.h"
 #include "dummy-frame.h"
 #include "dwarf2/frame.h"
+#include "sframe-frame.h"
 #include "frame.h"
 #include "frame-base.h"
 #include "frame-unwind.h"
@@ -8772,6 +8773,12 @@ i386_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
   if (info.bfd_arch_info->bits_per_word == 32)
     frame_unwind_append_unwinder (gdbarch, &i386_epilogue_override_frame_unwind);
 
+  /* Hook in the SFrame unwinder, which is cheaper than the DWARF CFI
+     unwinder when an objfile has a .sframe section.  SFrame only
+     describes 64-bit code.  */
+  if (info.bfd_arch_info->bits_per_word == 64)
+    sframe_append_unwinders (gdbarch);
+
   /* Hook in the DWARF CFI frame unwinder.  This unwinder is appended
      to the list before the prologue-based unwinders, so that DWARF
      CFI info will be used if it is available.  */
@@ -364,7 +364,7 @@ static std::vector<symtab_and_line> decode_objc (struct linespec_state *self,
 						 const char *arg);
 
 static std::vector<symtab *> symtabs_from_filename
-  (const char *, struct program_space *pspace);
+  (const char *, struct program_space *pspace, int line = 0);
 
 static std::vector<block_symbol> find_label_symbols
   (struct linespec_state *self,
@@ -398,7 +398,8 @@ static void add_all_symbol_names_from_pspace
 
 static std::vector<symtab *>
   collect_symtabs_from_filename (const char *file,
-				 struct program_space *pspace);
+				 struct program_space *pspace,
+				 int line = 0);
 
 using symtab_best_entry_map = std::map<symtab *, const linetable_entry *>;
 static std::vector<symtab_and_line> decode_digits_ordinary
@@ -1047,6 +1048,47 @@ linespec_lexer_peek_token (linespec_parser *parser)
   return next;
 }
 
+/* The current token of PARSER being a file name followed by a colon,
+   return the line number that follows the colon if that is all the
+   linespec specifies (apart from keywords), or 0 otherwise.  This
+   does not change the state of PARSER.  */
+
+static int
+linespec_lexer_peek_file_line (linespec_parser *parser)
+{
+  const char *saved_stream = PARSER_STREAM (parser);
+  linespec_token saved_token = parser->lexer.current;
+  int saved_completion_quote_char = parser->completion_quote_char;
+  const char *saved_completion_quote_end = parser->completion_quote_end;
+  const char *saved_completion_word = parser->completion_word;
+  int line = 0;
+
+  linespec_token colon = linespec_lexer_consume_token (parser);
+  if (colon.type == LSTOKEN_COLON)
+    {
+      linespec_token number = linespec_lexer_consume_token (parser);
+      if (number.type == LSTOKEN_NUMBER
+	  && isdigit (*LS_TOKEN_STOKEN (number).ptr))
+	{
+	  linespec_token next = linespec_lexer_consume_token (parser);
+	  if (next.type == LSTOKEN_EOI || next.type == LSTOKEN_KEYWORD)
+	    {
+	      gdb::unique_xmalloc_ptr<char> str = copy_token_string (number);
+	      long l = atol (str.get ());
+	      if (l <= INT_MAX)
+		line = l;
+	    }
+	}
+    }
+
+  PARSER_STREAM (parser) = saved_stream;
+  parser->lexer.current = saved_token;
+  parser->completion_quote_char = saved_completion_quote_char;
+  parser->completion_quote_end = saved_completion_quote_end;
+  parser->completion_word = saved_completion_word;
+  return line;
+}
+
 /* Helper functions.  */
 
 /* Add SAL to SALS, and also update SELF->CANONICAL_NAMES to reflect
@@ -2477,10 +2519,20 @@ convert_explicit_location_spec_to_linespec
 
   if (source_filename != NULL)
     {
+      /* When only a line is given, the symtabs that do not have code
+	 for it need not be expanded.  */
+      int line = 0;
+      if (function_name == nullptr
+	  && label_name == nullptr
+	  && line_offset.sign == LINE_OFFSET_NONE
+	  && !self->list_mode)
+	line = line_offset.offset;
+
       try
 	{
 	  result->file_symtabs
-	    = symtabs_from_filename (source_filename, self->search_pspace);
+	    = symtabs_from_filename (source_filename, self->search_pspace,
+				     line);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -2704,12 +2756,20 @@ parse_linespec (linespec_parser *parser, const char *arg,
       token = linespec_lexer_lex_one (parser);
       gdb::unique_xmalloc_ptr<char> user_filename = copy_token_string (token);
 
+      /* When only a line is given, the symtabs that do not have code
+	 for it need not be expanded.  */
+      int line = 0;
+      if (parser->completion_tracker == NULL
+	  && !PARSER_STATE (parser)->list_mode)
+	line = linespec_lexer_peek_file_line (parser);
+
       /* Check if the input is a filename.  */
       try
 	{
 	  PARSER_RESULT (parser)->file_symtabs
 	    = symtabs_from_filename (user_filename.get (),
-				     PARSER_STATE (parser)->search_pspace);
+				     PARSER_STATE (parser)->search_pspace,
+				     line);
 	}
       catch (gdb_exception_error &ex)
 	{
@@ -3854,11 +3914,14 @@ symtab_collector::operator () (struct symtab *symtab)
 
 /* Given a file name, return a list of all matching symtabs.  If
    SEARCH_PSPACE is not NULL, the search is restricted to just that
-   program space.  */
+   program space.  If LINE is positive, symtabs that are known to have
+   no code for LINE or a later line are not expanded, see
+   iterate_over_symtabs.  */
 
 static std::vector<symtab *>
 collect_symtabs_from_filename (const char *file,
-			       struct program_space *search_pspace)
+			       struct program_space *search_pspace,
+			       int line)
 {
   symtab_collector collector;
 
@@ -3871,27 +3934,35 @@ collect_symtabs_from_filename (const char *file,
 	    continue;
 
 	  set_current_program_space (pspace);
-	  iterate_over_symtabs (file, collector);
+	  iterate_over_symtabs (file, collector, line);
 	}
     }
   else
     {
       set_current_program_space (search_pspace);
-      iterate_over_symtabs (file, collector);
+      iterate_over_symtabs (file, collector, line);
     }
 
   return collector.release_symtabs ();
 }
 
 /* Return all the symtabs associated to the FILENAME.  If SEARCH_PSPACE is
-   not NULL, the search is restricted to just that program space.  */
+   not NULL, the search is restricted to just that program space.  If
+   LINE is positive, only the symtabs that may have code for LINE or a
+   later line are required.  */
 
 static std::vector<symtab *>
 symtabs_from_filename (const char *filename,
-		       struct program_space *search_pspace)
+		       struct program_space *search_pspace,
+		       int line)
 {
   std::vector<symtab *> result
-    = collect_symtabs_from_filename (filename, search_pspace);
+    = collect_symtabs_from_filename (filename, search_pspace, line);
+
+  /* If no symtab has code for LINE, look at all of them again, so that
+     the error reported is about the line, not about the file.  */
+  if (result.empty () && line > 0)
+    result = collect_symtabs_from_filename (filename, search_pspace);
 
   if (result.empty ())
     {
@@ -44,6 +44,7 @@
 #include "gdbcore.h"
 #include <ctype.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include "inf-loop.h"
 #include "gdbsupport/event-loop.h"
@@ -58,6 +59,8 @@
 #include "linux-tdep.h"
 #include "symfile.h"
 #include "gdbsupport/agent.h"
+#include "ax.h"
+#include "breakpoint.h"
 #include "tracepoint.h"
 #include "target-descriptions.h"
 #include "gdbsupport/filestuff.h"
@@ -68,7 +71,9 @@
 #include "gdbsupport/scope-exit.h"
 #include "gdbsupport/gdb-sigmask.h"
 #include "gdbsupport/common-debug.h"
+#include <map>
 #include <unordered_map>
+#include <unordered_set>
 
 /* This comment documents high-level logic of this file.
 
@@ -293,6 +298,7 @@ static struct lwp_info *add_lwp (ptid_t ptid);
 static void purge_lwp_list (int pid);
 static void delete_lwp (ptid_t ptid);
 static struct lwp_info *find_lwp_pid (ptid_t ptid);
+static struct lwp_info *find_stopped_lwp (int pid);
 
 static int lwp_status_pending_p (struct lwp_info *lp);
 
@@ -303,6 +309,38 @@ static void save_stop_reason (struct lwp_info *lp);
 static bool proc_mem_file_is_writable ();
 static void close_proc_mem_file (pid_t pid);
 static void open_proc_mem_file (ptid_t ptid);
+static enum target_xfer_status
+linux_proc_xfer_memory_partial (int pid, gdb_byte *readbuf,
+				const gdb_byte *writebuf, ULONGEST offset,
+				LONGEST len, ULONGEST *xfered_len);
+
+/* A page write-protected for page-protection watchpoints.  */
+
+struct protected_page
+{
+  /* The number of watched regions in the page.  The page may stay
+     protected with no region while no LWP of its process is stopped,
+     see release_unwatched_pages.  */
+  int refs;
+
+  /* The original protection of the page, as PROT_* flags.  */
+  int prot;
+};
+
+/* The page-protection watchpoints of a process.  */
+
+struct page_watch_state
+{
+  /* The watched regions, as address and length.  */
+  std::vector<std::pair<CORE_ADDR, int>> regions;
+
+  /* The pages covering the regions, keyed by their address.  */
+  std::map<CORE_ADDR, protected_page> pages;
+};
+
+/* The page-protection watchpoints of each process, keyed by PID.  */
+
+static std::unordered_map<int, page_watch_state> page_watch_states;
 
 /* Return TRUE if LWP is the leader thread of the process.  */
 
@@ -798,7 +836,7 @@ linux_nat_target::pass_signals
 
 
 /* Prototypes for local functions.  */
-static int stop_wait_callback (struct lwp_info *lp);
+static void stop_and_wait_lwps (ptid_t filter);
 static int resume_stopped_resumed_lwps (struct lwp_info *lp, const ptid_t wait_ptid);
 static int check_ptrace_stopped_lwp_gone (struct lwp_info *lp);
 
@@ -1304,7 +1342,7 @@ get_detach_signal (struct lwp_info *lp)
   enum gdb_signal signo = GDB_SIGNAL_0;
 
   /* If we paused threads momentarily, we may have stored pending
-     events in lp->status or lp->waitstatus (see stop_wait_callback),
+     events in lp->status or lp->waitstatus (see stop_wait_handle_status),
      and GDB core hasn't seen any signal for those threads.
      Otherwise, the last signal reported to the core is found in the
      thread object's stop_signal.
@@ -1540,10 +1578,7 @@ linux_nat_target::detach (inferior *inf, int from_tty)
 
   /* Stop all threads before detaching.  ptrace requires that the
      thread is stopped to successfully detach.  */
-  iterate_over_lwps (ptid_t (pid), stop_callback);
-  /* ... and wait until all of them have reported back that
-     they're no longer running.  */
-  iterate_over_lwps (ptid_t (pid), stop_wait_callback);
+  stop_and_wait_lwps (ptid_t (pid));
 
   /* We can now safely remove breakpoints.  We don't this in earlier
      in common code because this target doesn't currently support
@@ -1621,6 +1656,7 @@ linux_resume_one_lwp_throw (struct lwp_info *lp, int step,
      status.  Note that we must not throw after this is cleared,
      otherwise handle_zombie_lwp_error would get confused.  */
   lp->stopped = 0;
+  lp->name.reset ();
   lp->core = -1;
   lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
   registers_changed_ptid (linux_target, lp->ptid);
@@ -1872,7 +1908,7 @@ linux_handle_syscall_trap (struct lwp_info *lp, int stopping)
       /* If we're stopping threads, there's a SIGSTOP pending, which
 	 makes it so that the LWP reports an immediate syscall return,
 	 followed by the SIGSTOP.  Skip seeing that "return" using
-	 PTRACE_CONT directly, and let stop_wait_callback collect the
+	 PTRACE_CONT directly, and let stop_wait_lwps collect the
 	 SIGSTOP.  Later when the thread is resumed, a new syscall
 	 entry event.  If we didn't do this (and returned 0), we'd
 	 leave a syscall entry pending, and our caller, by using
@@ -1880,7 +1916,7 @@ linux_handle_syscall_trap (struct lwp_info *lp, int stopping)
 	 itself.  Later, when the user re-resumes this LWP, we'd see
 	 another syscall entry event and we'd mistake it for a return.
 
-	 If stop_wait_callback didn't force the SIGSTOP out of the LWP
+	 If stop_wait_lwps didn't force the SIGSTOP out of the LWP
 	 (leaving immediately with LWP->signalled set, without issuing
 	 a PTRACE_CONT), it would still be problematic to leave this
 	 syscall enter pending, as later when the thread is resumed,
@@ -1896,6 +1932,7 @@ linux_handle_syscall_trap (struct lwp_info *lp, int stopping)
       lp->syscall_state = TARGET_WAITKIND_IGNORE;
       ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
       lp->stopped = 0;
+      lp->name.reset ();
       return 1;
     }
 
@@ -2065,6 +2102,13 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
 	     forks even if those end up never mapped to an
 	     inferior.  */
 	  linux_target->low_new_fork (lp, new_pid);
+
+	  /* The child of a fork inherits the protected pages, which
+	     the core removes with the watchpoints when detaching
+	     them.  */
+	  auto iter = page_watch_states.find (lp->ptid.pid ());
+	  if (event == PTRACE_EVENT_FORK && iter != page_watch_states.end ())
+	    page_watch_states[new_pid] = iter->second;
 	}
       else if (event == PTRACE_EVENT_CLONE)
 	{
@@ -2122,6 +2166,8 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
 	 Reading/writing from this file would return 0/EOF.  */
       close_proc_mem_file (lp->ptid.pid ());
 
+      page_watch_states.erase (lp->ptid.pid ());
+
       /* Open a new file for the new address space.  */
       open_proc_mem_file (lp->ptid);
 
@@ -2221,39 +2267,35 @@ is_lwp_marked_dead (lwp_info *lp)
   return false;
 }
 
-/* Wait for LP to stop.  Returns the wait status, or 0 if the LWP has
-   exited.  */
+/* Check whether LP, which we are waiting for to stop, has reported a
+   status.  Returns the wait status, 0 if the LWP has exited, or -1 if
+   it has not reported anything yet.  The caller must have blocked
+   SIGCHLD, so that it can wait for the next SIGCHLD with
+   wait_for_signal before polling LP again.  */
 
 static int
-wait_lwp (struct lwp_info *lp)
+poll_lwp (struct lwp_info *lp)
 {
   pid_t pid;
   int status = 0;
   int thread_dead = 0;
-  sigset_t prev_mask;
 
   gdb_assert (!lp->stopped);
   gdb_assert (lp->status == 0);
 
-  /* Make sure SIGCHLD is blocked for sigsuspend avoiding a race below.  */
-  block_child_signals (&prev_mask);
-
-  for (;;)
+  pid = my_waitpid (lp->ptid.lwp (), &status, __WALL | WNOHANG);
+  if (pid == -1 && errno == ECHILD)
+    {
+      /* The thread has previously exited.  We need to delete it
+	 now because if this was a non-leader thread execing, we
+	 won't get an exit event.  See comments on exec events at
+	 the top of the file.  */
+      thread_dead = 1;
+      linux_nat_debug_printf ("%s vanished.",
+			      lp->ptid.to_string ().c_str ());
+    }
+  else if (pid == 0)
     {
-      pid = my_waitpid (lp->ptid.lwp (), &status, __WALL | WNOHANG);
-      if (pid == -1 && errno == ECHILD)
-	{
-	  /* The thread has previously exited.  We need to delete it
-	     now because if this was a non-leader thread execing, we
-	     won't get an exit event.  See comments on exec events at
-	     the top of the file.  */
-	  thread_dead = 1;
-	  linux_nat_debug_printf ("%s vanished.",
-				  lp->ptid.to_string ().c_str ());
-	}
-      if (pid != 0)
-	break;
-
       /* Bugs 10970, 12702.
 	 Thread group leader may have exited in which case we'll lock up in
 	 waitpid if there are other threads, even if they are all zombies too.
@@ -2274,20 +2316,11 @@ wait_lwp (struct lwp_info *lp)
 	  thread_dead = 1;
 	  linux_nat_debug_printf ("Thread group leader %s vanished.",
 				  lp->ptid.to_string ().c_str ());
-	  break;
 	}
-
-      /* Wait for next SIGCHLD and try again.  This may let SIGCHLD handlers
-	 get invoked despite our caller had them intentionally blocked by
-	 block_child_signals.  This is sensitive only to the loop of
-	 linux_nat_wait_1 and there if we get called my_waitpid gets called
-	 again before it gets to sigsuspend so we can safely let the handlers
-	 get executed here.  */
-      wait_for_signal ();
+      else
+	return -1;
     }
 
-  restore_child_signals_mask (&prev_mask);
-
   if (!thread_dead)
     {
       gdb_assert (pid == lp->ptid.lwp ());
@@ -2325,6 +2358,9 @@ wait_lwp (struct lwp_info *lp)
   gdb_assert (WIFSTOPPED (status));
   lp->stopped = 1;
 
+  /* The LWP may have changed its name while running.  */
+  lp->name.reset ();
+
   if (lp->must_set_ptrace_flags)
     {
       inferior *inf = find_inferior_pid (linux_target, lp->ptid.pid ());
@@ -2343,7 +2379,7 @@ wait_lwp (struct lwp_info *lp)
 	 on.  */
       status = W_STOPCODE (SIGTRAP);
       if (linux_handle_syscall_trap (lp, 1))
-	return wait_lwp (lp);
+	return poll_lwp (lp);
     }
   else
     {
@@ -2401,12 +2437,7 @@ linux_stop_lwp (struct lwp_info *lwp)
 void
 linux_stop_and_wait_all_lwps (void)
 {
-  /* Stop all LWP's ...  */
-  iterate_over_lwps (minus_one_ptid, stop_callback);
-
-  /* ... and wait until all of them have reported back that
-     they're no longer running.  */
-  iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+  stop_and_wait_lwps (minus_one_ptid);
 }
 
 /* See linux-nat.h  */
@@ -2536,78 +2567,169 @@ linux_nat_target::low_status_is_event (int status)
   return WIFSTOPPED (status) && WSTOPSIG (status) == SIGTRAP;
 }
 
-/* Wait until LP is stopped.  */
+/* Handle STATUS, the wait status that LP reported while we were
+   waiting for it to stop after stop_callback.  Return true if LP was
+   resumed, and we have to wait for it to stop again.  */
 
-static int
-stop_wait_callback (struct lwp_info *lp)
+static bool
+stop_wait_handle_status (struct lwp_info *lp, int status)
 {
-  inferior *inf = find_inferior_ptid (linux_target, lp->ptid);
+  if (lp->ignore_sigint && WIFSTOPPED (status)
+      && WSTOPSIG (status) == SIGINT)
+    {
+      lp->ignore_sigint = 0;
 
-  /* If this is a vfork parent, bail out, it is not going to report
-     any SIGSTOP until the vfork is done with.  */
-  if (inf->vfork_child != NULL)
-    return 0;
+      errno = 0;
+      ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
+      lp->stopped = 0;
+      lp->name.reset ();
+      linux_nat_debug_printf
+	("PTRACE_CONT %s, 0, 0 (%s) (discarding SIGINT)",
+	 lp->ptid.to_string ().c_str (),
+	 errno ? safe_strerror (errno) : "OK");
 
-  if (!lp->stopped)
+      return true;
+    }
+
+  maybe_clear_ignore_sigint (lp);
+
+  if (WSTOPSIG (status) != SIGSTOP)
     {
-      int status;
+      /* The thread was stopped with a signal other than SIGSTOP.  */
 
-      status = wait_lwp (lp);
-      if (status == 0)
-	return 0;
+      linux_nat_debug_printf ("Pending event %s in %s",
+			      status_to_str ((int) status).c_str (),
+			      lp->ptid.to_string ().c_str ());
 
-      if (lp->ignore_sigint && WIFSTOPPED (status)
-	  && WSTOPSIG (status) == SIGINT)
-	{
-	  lp->ignore_sigint = 0;
+      /* Save the sigtrap event.  */
+      lp->status = status;
+      gdb_assert (lp->signalled);
+      save_stop_reason (lp);
+    }
+  else
+    {
+      /* We caught the SIGSTOP that we intended to catch.  */
 
-	  errno = 0;
-	  ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
-	  lp->stopped = 0;
-	  linux_nat_debug_printf
-	    ("PTRACE_CONT %s, 0, 0 (%s) (discarding SIGINT)",
-	     lp->ptid.to_string ().c_str (),
-	     errno ? safe_strerror (errno) : "OK");
+      linux_nat_debug_printf ("Expected SIGSTOP caught for %s.",
+			      lp->ptid.to_string ().c_str ());
+
+      lp->signalled = 0;
 
-	  return stop_wait_callback (lp);
+      /* If we are waiting for this stop so we can report the thread
+	 stopped then we need to record this status.  Otherwise, we can
+	 now discard this stop event.  */
+      if (lp->last_resume_kind == resume_stop)
+	{
+	  lp->status = status;
+	  save_stop_reason (lp);
 	}
+    }
+
+  return false;
+}
+
+/* Wait until all the LWPs matching FILTER have reported back that
+   they're no longer running, after stop_callback.
+
+   With many LWPs, waiting for each of them in turn would cost a
+   sigsuspend for each LWP that hasn't stopped yet, and changing the
+   signal mask twice per LWP.  Instead, block SIGCHLD once, poll all
+   the LWPs that are still running, and only wait for the next SIGCHLD
+   when none of them reported anything.  */
 
-      maybe_clear_ignore_sigint (lp);
+static void
+stop_wait_lwps (ptid_t filter)
+{
+  sigset_t prev_mask;
 
-      if (WSTOPSIG (status) != SIGSTOP)
+  /* Make sure SIGCHLD is blocked for sigsuspend avoiding a race in
+     poll_lwp.  */
+  block_child_signals (&prev_mask);
+  SCOPE_EXIT { restore_child_signals_mask (&prev_mask); };
+
+  /* The LWPs that were already considered.  Each LWP is waited for at
+     most once, including LWPs that are added while we wait, as when
+     iterating over the LWPs with a callback.  */
+  std::unordered_set<ptid_t> seen;
+  std::vector<ptid_t> pending;
+
+  while (true)
+    {
+      iterate_over_lwps (filter, [&] (struct lwp_info *lp)
 	{
-	  /* The thread was stopped with a signal other than SIGSTOP.  */
+	  if (!seen.insert (lp->ptid).second)
+	    return 0;
+
+	  /* If this is a vfork parent, don't wait for it, it is not
+	     going to report any SIGSTOP until the vfork is done
+	     with.  */
+	  inferior *inf = find_inferior_ptid (linux_target, lp->ptid);
+	  if (!lp->stopped && inf->vfork_child == nullptr)
+	    pending.push_back (lp->ptid);
+	  return 0;
+	});
 
-	  linux_nat_debug_printf ("Pending event %s in %s",
-				  status_to_str ((int) status).c_str (),
-				  lp->ptid.to_string ().c_str ());
+      if (pending.empty ())
+	break;
 
-	  /* Save the sigtrap event.  */
-	  lp->status = status;
-	  gdb_assert (lp->signalled);
-	  save_stop_reason (lp);
-	}
-      else
+      while (!pending.empty ())
 	{
-	  /* We caught the SIGSTOP that we intended to catch.  */
+	  bool progress = false;
 
-	  linux_nat_debug_printf ("Expected SIGSTOP caught for %s.",
-				  lp->ptid.to_string ().c_str ());
+	  for (size_t i = 0; i < pending.size (); )
+	    {
+	      /* Handling the status of another LWP may have deleted
+		 this one.  */
+	      struct lwp_info *lp = find_lwp_pid (pending[i]);
+	      int status = -1;
 
-	  lp->signalled = 0;
+	      if (lp != nullptr && !lp->stopped)
+		{
+		  status = poll_lwp (lp);
+		  if (status == -1)
+		    {
+		      ++i;
+		      continue;
+		    }
+		  progress = true;
+		}
+
+	      /* POLL_LWP may have deleted LP, so don't use it if the
+		 LWP has exited.  */
+	      if (status > 0 && stop_wait_handle_status (lp, status))
+		{
+		  ++i;
+		  continue;
+		}
 
-	  /* If we are waiting for this stop so we can report the thread
-	     stopped then we need to record this status.  Otherwise, we can
-	     now discard this stop event.  */
-	  if (lp->last_resume_kind == resume_stop)
+	      pending[i] = pending.back ();
+	      pending.pop_back ();
+	    }
+
+	  if (!progress && !pending.empty ())
 	    {
-	      lp->status = status;
-	      save_stop_reason (lp);
+	      /* Wait for next SIGCHLD and try again.  This may let
+		 SIGCHLD handlers get invoked despite our caller had them
+		 intentionally blocked by block_child_signals.  This is
+		 sensitive only to the loop of linux_nat_wait_1 and there
+		 if we get called my_waitpid gets called again before it
+		 gets to sigsuspend so we can safely let the handlers get
+		 executed here.  */
+	      wait_for_signal ();
 	    }
 	}
     }
+}
 
-  return 0;
+/* Stop all the LWPs matching FILTER, and wait until all of them have
+   reported back that they're no longer running.  All the SIGSTOPs are
+   sent before waiting for any LWP.  */
+
+static void
+stop_and_wait_lwps (ptid_t filter)
+{
+  iterate_over_lwps (filter, stop_callback);
+  stop_wait_lwps (filter);
 }
 
 /* Get the inferior associated to LWP.  Must be called with an LWP that has
@@ -2821,6 +2943,506 @@ save_stop_reason (struct lwp_info *lp)
   lp->stop_pc = pc;
 }
 
+/* A software breakpoint inserted with conditions.  linux_nat_target
+   evaluates them itself when an LWP hits the breakpoint, and only
+   reports the hit to the core if one of them is true.  */
+
+struct cond_breakpoint
+{
+  /* The architecture of the breakpoint.  */
+  struct gdbarch *gdbarch;
+
+  /* The breakpoint instruction, and the contents of memory it
+     replaced.  */
+  gdb::byte_vector insn;
+  gdb::byte_vector shadow;
+
+  /* The conditions of all the breakpoint locations at the breakpoint's
+     address.  */
+  std::vector<agent_expr> conditions;
+};
+
+/* The software breakpoints inserted with conditions, keyed by their
+   address space and placed address.  */
+
+static std::map<std::pair<const address_space *, CORE_ADDR>,
+		cond_breakpoint> cond_breakpoints;
+
+/* Implement the insert_breakpoint target method.  Record the
+   conditions of the breakpoint, if any.  */
+
+int
+linux_nat_target::insert_breakpoint (struct gdbarch *gdbarch,
+				     struct bp_target_info *bp_tgt)
+{
+  int ret = inf_ptrace_target::insert_breakpoint (gdbarch, bp_tgt);
+  auto key = std::make_pair (bp_tgt->placed_address_space,
+			     bp_tgt->placed_address);
+  int len;
+  const gdb_byte *insn
+    = gdbarch_sw_breakpoint_from_kind (gdbarch, bp_tgt->kind, &len);
+
+  /* The core re-inserts breakpoints whose conditions changed without
+     removing them first, so this may replace the conditions of a
+     breakpoint we already know.  */
+  if (ret != 0
+      || bp_tgt->conditions.empty ()
+      || insn == nullptr
+      || bp_tgt->shadow_len != len)
+    {
+      cond_breakpoints.erase (key);
+      return ret;
+    }
+
+  cond_breakpoint &cond_bp = cond_breakpoints[key];
+  cond_bp.gdbarch = gdbarch;
+  cond_bp.insn.assign (insn, insn + len);
+  cond_bp.shadow.assign (bp_tgt->shadow_contents,
+			 bp_tgt->shadow_contents + len);
+  cond_bp.conditions.clear ();
+  for (agent_expr *aexpr : bp_tgt->conditions)
+    cond_bp.conditions.push_back (*aexpr);
+
+  return ret;
+}
+
+/* Implement the remove_breakpoint target method.  */
+
+int
+linux_nat_target::remove_breakpoint (struct gdbarch *gdbarch,
+				     struct bp_target_info *bp_tgt,
+				     enum remove_bp_reason reason)
+{
+  /* Breakpoints detached from a fork child stay inserted in the
+     parent.  */
+  if (reason == REMOVE_BREAKPOINT)
+    cond_breakpoints.erase (std::make_pair (bp_tgt->placed_address_space,
+					    bp_tgt->placed_address));
+
+  return inf_ptrace_target::remove_breakpoint (gdbarch, bp_tgt, reason);
+}
+
+/* Implement the supports_evaluation_of_breakpoint_conditions target
+   method.  Stepping over a breakpoint whose conditions are false
+   needs hardware single-step, see step_over_cond_breakpoint.  */
+
+bool
+linux_nat_target::supports_evaluation_of_breakpoint_conditions ()
+{
+  return !gdbarch_software_single_step_p (current_inferior ()->arch ());
+}
+
+/* Whether "set page-watchpoints" is on.  */
+
+static bool page_watchpoints = false;
+
+/* See linux-nat.h.  */
+
+bool
+linux_nat_page_watchpoints_p ()
+{
+  return page_watchpoints;
+}
+
+/* Return the size of the pages of the inferiors.  */
+
+static CORE_ADDR
+inferior_page_size ()
+{
+  static CORE_ADDR page_size = sysconf (_SC_PAGESIZE);
+
+  return page_size;
+}
+
+/* Return the contents of /proc/PID/maps.  */
+
+static std::optional<std::string>
+read_process_maps (int pid)
+{
+  return read_text_file_to_string (string_printf ("/proc/%d/maps",
+						  pid).c_str ());
+}
+
+/* Return the protection, as PROT_* flags, of the page at ADDR in the
+   process whose mappings, as read from /proc/PID/maps, are MAPS.
+   Return -1 if ADDR is not mapped.  If STACK is not NULL, set it to
+   whether the page is in the stack mapping of the main thread.  */
+
+static int
+page_protection (const std::string &maps, CORE_ADDR addr,
+		 bool *stack = nullptr)
+{
+  for (const char *line = maps.c_str (); *line != '\0'; )
+    {
+      const char *p = line;
+      CORE_ADDR start = strtoulst (p, &p, 16);
+      CORE_ADDR end = *p == '-' ? strtoulst (p + 1, &p, 16) : 0;
+
+      if (addr >= start && addr < end)
+	{
+	  int prot = PROT_NONE;
+
+	  p = skip_spaces (p);
+	  if (p[0] == 'r')
+	    prot |= PROT_READ;
+	  if (p[0] != '\0' && p[1] == 'w')
+	    prot |= PROT_WRITE;
+	  if (p[0] != '\0' && p[1] != '\0' && p[2] == 'x')
+	    prot |= PROT_EXEC;
+
+	  if (stack != nullptr)
+	    {
+	      const char *eol = strchrnul (p, '\n');
+	      *stack = (eol - p >= 7 && strncmp (eol - 7, "[stack]", 7) == 0);
+	    }
+	  return prot;
+	}
+
+      line = strchrnul (line, '\n');
+      if (*line == '\n')
+	line++;
+    }
+
+  return -1;
+}
+
+/* Change the protection of PAGES, address and original protection
+   pairs sorted by address, in process PID through its ptrace-stopped
+   LWP TID: remove write access if PROTECT is true, and restore the
+   original protection otherwise.  Pages that were not writable are
+   left alone, and so are, when restoring, the pages whose protection
+   the program changed itself since GDB removed write access.  Return
+   false if that failed.  */
+
+static bool
+set_pages_protection (int pid, pid_t tid,
+		      const std::vector<std::pair<CORE_ADDR, int>> &pages_in,
+		      bool protect)
+{
+  CORE_ADDR page_size = inferior_page_size ();
+  std::vector<std::pair<CORE_ADDR, int>> restored;
+
+  if (!protect && !pages_in.empty ())
+    {
+      std::optional<std::string> maps = read_process_maps (pid);
+      if (!maps.has_value ())
+	return false;
+
+      for (const auto &[page, prot] : pages_in)
+	if (page_protection (*maps, page) == (prot & ~PROT_WRITE))
+	  restored.emplace_back (page, prot);
+	else
+	  linux_nat_debug_printf ("not restoring the protection of page %s, "
+				  "changed by the program",
+				  core_addr_to_string_nz (page));
+    }
+  const std::vector<std::pair<CORE_ADDR, int>> &pages
+    = protect ? pages_in : restored;
+
+  /* Change runs of contiguous pages with the same protection at
+     once.  */
+  for (size_t i = 0, j; i < pages.size (); i = j)
+    {
+      for (j = i + 1; j < pages.size (); j++)
+	if (pages[j].first != pages[j - 1].first + page_size
+	    || pages[j].second != pages[i].second)
+	  break;
+
+      int prot = pages[i].second;
+      if ((prot & PROT_WRITE) == 0)
+	continue;
+
+      if (!linux_target->low_inferior_mprotect (tid, pages[i].first,
+						(j - i) * page_size,
+						protect
+						? prot & ~PROT_WRITE : prot))
+	return false;
+    }
+
+  return true;
+}
+
+/* Restore the protection of the pages of STATE that no longer hold a
+   watched region, in process PID through its ptrace-stopped LWP
+   TID.  */
+
+static void
+release_unwatched_pages (page_watch_state &state, int pid, pid_t tid)
+{
+  std::vector<std::pair<CORE_ADDR, int>> released;
+
+  for (auto iter = state.pages.begin (); iter != state.pages.end ();)
+    {
+      if (iter->second.refs == 0)
+	{
+	  released.emplace_back (iter->first, iter->second.prot);
+	  iter = state.pages.erase (iter);
+	}
+      else
+	++iter;
+    }
+
+  /* If this fails, the process is gone.  */
+  set_pages_protection (pid, tid, released, false);
+}
+
+/* Stop all the LWPs of a process for the lifetime of the object.
+   Changing the protection of pages makes an LWP of the process
+   execute a system call instruction written at its PC, which the
+   other LWPs must not run meanwhile.  */
+
+class scoped_stop_process_lwps
+{
+public:
+  explicit scoped_stop_process_lwps (int pid)
+    : m_pid (pid)
+  {
+    stop_and_wait_lwps (ptid_t (pid));
+  }
+
+  ~scoped_stop_process_lwps ()
+  {
+    /* Set the LWPs that the core considers running going again.
+       Those that got an event meanwhile keep it pending.  */
+    bool pending = false;
+    iterate_over_lwps (ptid_t (m_pid), [&] (struct lwp_info *lp)
+      {
+	if (lp->resumed && lwp_status_pending_p (lp))
+	  pending = true;
+	return resume_stopped_resumed_lwps (lp, minus_one_ptid);
+      });
+
+    /* Tell the event loop about the pending events.  */
+    if (pending)
+      linux_nat_target::async_file_mark_if_open ();
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_stop_process_lwps);
+
+private:
+  int m_pid;
+};
+
+/* Return the pages around the stack pointers of the LWPs of process
+   PID, which must all be stopped.  */
+
+static std::vector<CORE_ADDR>
+lwp_stack_pages (int pid)
+{
+  CORE_ADDR page_size = inferior_page_size ();
+  std::vector<CORE_ADDR> pages;
+
+  for (lwp_info *lp : all_lwps ())
+    {
+      if (lp->ptid.pid () != pid || !lp->stopped || is_lwp_marked_dead (lp))
+	continue;
+
+      thread_info *thr = linux_target->find_thread (lp->ptid);
+      if (thr == nullptr)
+	continue;
+
+      try
+	{
+	  struct regcache *regcache = get_thread_regcache (thr);
+	  ULONGEST sp;
+
+	  regcache_cooked_read_unsigned (regcache,
+					 gdbarch_sp_regnum (regcache->arch ()),
+					 &sp);
+
+	  /* Pushes and the red zone may reach the page below.  */
+	  pages.push_back (align_down (sp, page_size));
+	  pages.push_back (align_down (sp, page_size) - page_size);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  linux_nat_debug_printf ("can't read the SP of %s: %s",
+				  lp->ptid.to_string ().c_str (), ex.what ());
+	}
+    }
+
+  return pages;
+}
+
+/* Return the protection of PAGE in the process whose mappings are
+   MAPS, like page_protection, or -1 if PAGE can't be write-protected
+   for a page-protection watchpoint.  The kernel writes to the stacks,
+   e.g. to deliver signals, and kills the process if it can't, so the
+   stack of the main thread and STACK_PAGES, as returned by
+   lwp_stack_pages, are left to other kinds of watchpoints.  */
+
+static int
+watchable_page_protection (const std::string &maps,
+			   const std::vector<CORE_ADDR> &stack_pages,
+			   CORE_ADDR page)
+{
+  bool stack;
+  int prot = page_protection (maps, page, &stack);
+
+  if (stack
+      || std::find (stack_pages.begin (), stack_pages.end (), page)
+	 != stack_pages.end ())
+    return -1;
+
+  return prot;
+}
+
+/* See linux-nat.h.  */
+
+bool
+linux_nat_page_watchpoint_ok_p (CORE_ADDR addr, int len)
+{
+  if (!page_watchpoints || len <= 0)
+    return false;
+
+  /* Without a process yet, let insertion decide.  */
+  if (inferior_ptid == null_ptid)
+    return true;
+
+  int pid = inferior_ptid.pid ();
+  std::optional<std::string> maps = read_process_maps (pid);
+  if (!maps.has_value ())
+    return false;
+
+  std::vector<CORE_ADDR> stack_pages = lwp_stack_pages (pid);
+  CORE_ADDR page_size = inferior_page_size ();
+  CORE_ADDR first = align_down (addr, page_size);
+  CORE_ADDR last = align_down (addr + len - 1, page_size);
+  for (CORE_ADDR page = first; page <= last && page >= first;
+       page += page_size)
+    if (watchable_page_protection (*maps, stack_pages, page) == -1)
+      return false;
+
+  return true;
+}
+
+/* See linux-nat.h.  */
+
+int
+linux_nat_insert_page_watchpoint (CORE_ADDR addr, int len)
+{
+  int pid = inferior_ptid.pid ();
+
+  if (len <= 0)
+    return 1;
+
+  scoped_stop_process_lwps stop_lwps (pid);
+
+  /* Changing the protection of the pages needs a stopped LWP to
+     make the system call.  */
+  struct lwp_info *lp = find_stopped_lwp (pid);
+  if (lp == nullptr)
+    return 1;
+
+  CORE_ADDR page_size = inferior_page_size ();
+  CORE_ADDR first = align_down (addr, page_size);
+  CORE_ADDR last = align_down (addr + len - 1, page_size);
+  page_watch_state &state = page_watch_states[pid];
+  std::vector<std::pair<CORE_ADDR, int>> new_pages;
+  std::optional<std::string> maps;
+  std::vector<CORE_ADDR> stack_pages;
+
+  for (CORE_ADDR page = first; page <= last && page >= first;
+       page += page_size)
+    {
+      if (state.pages.find (page) != state.pages.end ())
+	continue;
+
+      if (!maps.has_value ())
+	{
+	  maps = read_process_maps (pid);
+	  if (!maps.has_value ())
+	    return 1;
+	  stack_pages = lwp_stack_pages (pid);
+	}
+
+      int prot = watchable_page_protection (*maps, stack_pages, page);
+      if (prot == -1)
+	return 1;
+      new_pages.emplace_back (page, prot);
+    }
+
+  if (!set_pages_protection (pid, lp->ptid.lwp (), new_pages, true))
+    {
+      set_pages_protection (pid, lp->ptid.lwp (), new_pages, false);
+      return 1;
+    }
+
+  for (const auto &[page, prot] : new_pages)
+    state.pages[page] = { 0, prot };
+  for (CORE_ADDR page = first; page <= last && page >= first;
+       page += page_size)
+    state.pages[page].refs++;
+  state.regions.emplace_back (addr, len);
+
+  linux_nat_debug_printf ("watching %d bytes at %s with %zu new pages",
+			  len, core_addr_to_string_nz (addr),
+			  new_pages.size ());
+
+  return 0;
+}
+
+/* See linux-nat.h.  */
+
+bool
+linux_nat_page_watchpoint_p (CORE_ADDR addr, int len)
+{
+  auto iter = page_watch_states.find (inferior_ptid.pid ());
+
+  if (iter == page_watch_states.end ())
+    return false;
+
+  const auto &regions = iter->second.regions;
+  return (std::find (regions.begin (), regions.end (),
+		     std::make_pair (addr, len))
+	  != regions.end ());
+}
+
+/* See linux-nat.h.  */
+
+int
+linux_nat_remove_page_watchpoint (CORE_ADDR addr, int len)
+{
+  int pid = inferior_ptid.pid ();
+  auto iter = page_watch_states.find (pid);
+
+  if (iter == page_watch_states.end ())
+    return 1;
+
+  page_watch_state &state = iter->second;
+  auto region = std::find (state.regions.begin (), state.regions.end (),
+			   std::make_pair (addr, len));
+  if (region == state.regions.end ())
+    return 1;
+  state.regions.erase (region);
+
+  CORE_ADDR page_size = inferior_page_size ();
+  CORE_ADDR first = align_down (addr, page_size);
+  CORE_ADDR last = align_down (addr + len - 1, page_size);
+  for (CORE_ADDR page = first; page <= last && page >= first;
+       page += page_size)
+    state.pages[page].refs--;
+
+  /* A fork child being detached is not in the LWP list, but it is
+     stopped.  */
+  if (find_lwp_pid (ptid_t (pid)) == nullptr)
+    release_unwatched_pages (state, pid, pid);
+  else
+    {
+      scoped_stop_process_lwps stop_lwps (pid);
+
+      /* If no LWP could be stopped, the pages are released on the
+	 next fault in them, see skip_page_watchpoint_fault.  */
+      struct lwp_info *lp = find_stopped_lwp (pid);
+      if (lp != nullptr)
+	release_unwatched_pages (state, pid, lp->ptid.lwp ());
+    }
+
+  if (state.pages.empty ())
+    page_watch_states.erase (iter);
+
+  return 0;
+}
 
 /* Returns true if the LWP had stopped for a software breakpoint.  */
 
@@ -3021,6 +3643,9 @@ linux_nat_filter_event (int lwpid, int status)
      ever being continued.)  */
   lp->stopped = 1;
 
+  /* The LWP may have changed its name while running.  */
+  lp->name.reset ();
+
   if (WIFSTOPPED (status) && lp->must_set_ptrace_flags)
     {
       inferior *inf = find_inferior_pid (linux_target, lp->ptid.pid ());
@@ -3305,6 +3930,307 @@ filter_exit_event (struct lwp_info *event_child,
   return ptid;
 }
 
+/* Transfer LEN bytes of memory at ADDR of process PID, reading them
+   into READBUF or writing them from WRITEBUF.  Return true on
+   success.  */
+
+static bool
+linux_proc_xfer_memory (int pid, gdb_byte *readbuf, const gdb_byte *writebuf,
+			CORE_ADDR addr, LONGEST len)
+{
+  while (len > 0)
+    {
+      ULONGEST xfered;
+
+      if (linux_proc_xfer_memory_partial (pid, readbuf, writebuf, addr, len,
+					  &xfered) != TARGET_XFER_OK)
+	return false;
+
+      if (readbuf != nullptr)
+	readbuf += xfered;
+      if (writebuf != nullptr)
+	writebuf += xfered;
+      addr += xfered;
+      len -= xfered;
+    }
+
+  return true;
+}
+
+/* Return true if all the conditions of COND_BP, the breakpoint LP
+   stopped at, are false.  Return false if one is true, or can't be
+   evaluated here.  */
+
+static bool
+cond_breakpoint_false_p (struct lwp_info *lp, const cond_breakpoint &cond_bp)
+{
+  int pid = lp->ptid.pid ();
+
+  try
+    {
+      struct regcache *regcache = get_thread_regcache (linux_target,
+						       lp->ptid);
+      struct gdbarch *gdbarch = regcache->arch ();
+
+      auto read_reg = [&] (int regnum, ULONGEST *val)
+	{
+	  /* The bytecode holds the remote numbers of the registers,
+	     which are usually GDB's numbers.  Don't bother mapping the
+	     others back.  */
+	  if (regnum >= gdbarch_num_regs (gdbarch)
+	      || gdbarch_remote_register_number (gdbarch, regnum) != regnum
+	      || register_size (gdbarch, regnum) > sizeof (ULONGEST))
+	    return false;
+
+	  return regcache->raw_read (regnum, val) == REG_VALID;
+	};
+
+      auto read_mem = [&] (CORE_ADDR addr, gdb_byte *buf, int len)
+	{
+	  return linux_proc_xfer_memory (pid, buf, nullptr, addr, len);
+	};
+
+      for (const agent_expr &cond : cond_bp.conditions)
+	{
+	  ULONGEST value;
+
+	  if (!ax_eval (cond, read_reg, read_mem, &value) || value != 0)
+	    return false;
+	}
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/* Single-step LP, which is stopped like all the other LWPs of its
+   process, and wait for the step to finish.  Leave whatever else LP
+   reports meanwhile to linux_nat_filter_event, but discard the
+   SIGTRAP of the step.  Return LP, or nullptr if it is gone.  */
+
+static struct lwp_info *
+step_lwp_alone (struct lwp_info *lp)
+{
+  ptid_t ptid = lp->ptid;
+  int step = lp->step;
+
+  linux_resume_one_lwp (lp, 1, GDB_SIGNAL_0);
+
+  while ((lp = find_lwp_pid (ptid)) != nullptr && !lp->stopped)
+    {
+      int status;
+      int lwpid = my_waitpid (ptid.lwp (), &status, __WALL);
+
+      if (lwpid <= 0)
+	break;
+
+      linux_nat_debug_printf ("waitpid %ld received %s",
+			      (long) lwpid,
+			      status_to_str (status).c_str ());
+
+      linux_nat_filter_event (lwpid, status);
+    }
+
+  if (lp != nullptr)
+    {
+      lp->step = step;
+
+      /* Keep any other event for the core, like a watchpoint
+	 triggered by the stepped instruction.  */
+      if (lp->status != 0
+	  && lp->waitstatus.kind () == TARGET_WAITKIND_IGNORE
+	  && WIFSTOPPED (lp->status)
+	  && WSTOPSIG (lp->status) == SIGTRAP
+	  && lp->stop_reason == TARGET_STOPPED_BY_NO_REASON)
+	lp->status = 0;
+    }
+
+  return lp;
+}
+
+/* Move LP, which stopped at the breakpoint at ADDR whose instruction
+   is INSN and replaced contents SHADOW, past it.  All the other LWPs
+   of its process must be stopped, so that none of them runs past the
+   breakpoint while it is out of memory.  Return false if LP couldn't
+   be moved.  */
+
+static bool
+step_over_cond_breakpoint (struct lwp_info *lp, CORE_ADDR addr,
+			   const gdb::byte_vector &insn,
+			   const gdb::byte_vector &shadow)
+{
+  int pid = lp->ptid.pid ();
+
+  if (!linux_proc_xfer_memory (pid, nullptr, shadow.data (), addr,
+			       shadow.size ()))
+    return false;
+
+  step_lwp_alone (lp);
+
+  /* If the process is gone, so is the breakpoint.  */
+  linux_proc_xfer_memory (pid, nullptr, insn.data (), addr, insn.size ());
+
+  return true;
+}
+
+/* If LP reported STATUS for hitting a software breakpoint whose
+   conditions are all false, move it past the breakpoint and return
+   true.  The event is then not reported to the core, which saves it
+   from stopping all the threads, building frames and evaluating the
+   conditions itself.  Otherwise, return false.  */
+
+static bool
+skip_false_cond_breakpoint (struct lwp_info *lp, int status)
+{
+  if (cond_breakpoints.empty ()
+      || lp->stop_reason != TARGET_STOPPED_BY_SW_BREAKPOINT
+      || lp->step
+      || lp->waitstatus.kind () != TARGET_WAITKIND_IGNORE
+      || !WIFSTOPPED (status)
+      || WSTOPSIG (status) != SIGTRAP)
+    return false;
+
+  const address_space *aspace = lwp_inferior (lp)->aspace.get ();
+  CORE_ADDR pc = lp->stop_pc;
+  auto iter = cond_breakpoints.find (std::make_pair (aspace, pc));
+  if (iter == cond_breakpoints.end ())
+    return false;
+
+  const cond_breakpoint &cond_bp = iter->second;
+  if (gdbarch_software_single_step_p (cond_bp.gdbarch)
+      || !only_target_conditions_breakpoint_here_p (aspace, pc)
+      || !cond_breakpoint_false_p (lp, cond_bp))
+    return false;
+
+  linux_nat_debug_printf ("conditions false at %s for %s, stepping over",
+			  paddress (cond_bp.gdbarch, pc),
+			  lp->ptid.to_string ().c_str ());
+
+  /* Stopping the other LWPs may handle events that change the
+     breakpoints, so don't hold on to COND_BP.  */
+  gdb::byte_vector insn = cond_bp.insn;
+  gdb::byte_vector shadow = cond_bp.shadow;
+
+  stop_and_wait_lwps (ptid_t (lp->ptid.pid ()));
+
+  return step_over_cond_breakpoint (lp, pc, insn, shadow);
+}
+
+/* The largest number of bytes a single instruction writes.  */
+
+static const int max_write_len = 64;
+
+/* If LP reported STATUS for a write to a page write-protected for
+   page-protection watchpoints, step it over the write with the page
+   writable.  If the write may have changed a watched region, or if LP
+   was being stepped, change STATUS to the SIGTRAP to report and
+   return false.  Otherwise, return true: the fault is then not
+   reported to the core.  */
+
+static bool
+skip_page_watchpoint_fault (struct lwp_info *lp, int *status)
+{
+  if (page_watch_states.empty ()
+      || lp->waitstatus.kind () != TARGET_WAITKIND_IGNORE
+      || !WIFSTOPPED (*status)
+      || WSTOPSIG (*status) != SIGSEGV)
+    return false;
+
+  int pid = lp->ptid.pid ();
+  auto iter = page_watch_states.find (pid);
+  siginfo_t siginfo;
+  if (iter == page_watch_states.end ()
+      || !linux_nat_get_siginfo (lp->ptid, &siginfo)
+      || siginfo.si_code != SEGV_ACCERR)
+    return false;
+
+  CORE_ADDR addr = (CORE_ADDR) (uintptr_t) siginfo.si_addr;
+  CORE_ADDR page_size = inferior_page_size ();
+  const page_watch_state &state = iter->second;
+  std::vector<std::pair<CORE_ADDR, int>> pages;
+  std::optional<std::string> maps = read_process_maps (pid);
+  if (!maps.has_value ())
+    return false;
+
+  /* Faults in pages that were not writable, or that the program
+     write-protected itself, are the program's own.  A write may span
+     the next page too.  */
+  for (CORE_ADDR page = align_down (addr, page_size);
+       pages.size () < 2;
+       page += page_size)
+    {
+      auto page_iter = state.pages.find (page);
+      if (page_iter == state.pages.end ()
+	  || (page_iter->second.prot & PROT_WRITE) == 0
+	  || (page_protection (*maps, page)
+	      != (page_iter->second.prot & ~PROT_WRITE)))
+	break;
+      pages.emplace_back (page, page_iter->second.prot);
+    }
+  if (pages.empty ())
+    return false;
+
+  /* The fault only tells where the write starts, so report it if the
+     longest write there would change a watched region.  The core
+     then compares the values of the watchpoints, and resumes if none
+     changed.  */
+  bool hit = false;
+  CORE_ADDR data_addr = addr;
+  for (const auto &[start, len] : state.regions)
+    if (addr < start + len && start < addr + max_write_len)
+      {
+	hit = true;
+	data_addr = std::max (addr, start);
+	break;
+      }
+
+  linux_nat_debug_printf ("write fault at %s for %s, %s",
+			  core_addr_to_string_nz (addr),
+			  lp->ptid.to_string ().c_str (),
+			  hit ? "watched" : "not watched");
+
+  /* Don't let other threads write to the pages while they are
+     writable.  */
+  stop_and_wait_lwps (ptid_t (pid));
+
+  if (!set_pages_protection (pid, lp->ptid.lwp (), pages, false))
+    return false;
+
+  int step = lp->step;
+  lp = step_lwp_alone (lp);
+
+  /* Events handled meanwhile, like an exec, may have changed the
+     state of the process.  */
+  iter = page_watch_states.find (pid);
+  struct lwp_info *stopped = lp != nullptr ? lp : find_stopped_lwp (pid);
+  if (iter != page_watch_states.end () && stopped != nullptr)
+    {
+      set_pages_protection (pid, stopped->ptid.lwp (), pages, true);
+      release_unwatched_pages (iter->second, pid, stopped->ptid.lwp ());
+      if (iter->second.pages.empty ())
+	page_watch_states.erase (iter);
+    }
+
+  /* If LP stopped for something else while stepping, like a signal,
+     that is reported instead.  */
+  if (lp == nullptr || lp->status != 0 || (!hit && !step))
+    return true;
+
+  *status = W_STOPCODE (SIGTRAP);
+  lp->stop_pc = regcache_read_pc (get_thread_regcache (linux_target,
+						       lp->ptid));
+  if (hit)
+    {
+      lp->stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
+      lp->stopped_data_address = data_addr;
+      lp->stopped_data_address_p = 1;
+    }
+  return false;
+}
+
 static ptid_t
 linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 		  target_wait_flags target_options)
@@ -3338,6 +4264,8 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
   /* Make sure SIGCHLD is blocked until the sigsuspend below.  */
   block_child_signals (&prev_mask);
 
+ retry:
+
   /* First check if there is a LWP with a wait status pending.  */
   lp = iterate_over_lwps (ptid, status_callback);
   if (lp != NULL)
@@ -3443,12 +4371,8 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 
   if (!target_is_non_stop_p ())
     {
-      /* Now stop all other LWP's ...  */
-      iterate_over_lwps (minus_one_ptid, stop_callback);
-
-      /* ... and wait until all of them have reported back that
-	 they're no longer running.  */
-      iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+      /* Now stop all other LWP's.  */
+      stop_and_wait_lwps (minus_one_ptid);
     }
 
   /* If we're not waiting for a specific LWP, choose an event LWP from
@@ -3459,6 +4383,13 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 
   gdb_assert (lp != NULL);
 
+  /* Don't bother the core with hits of breakpoints whose conditions
+     are false, nor with writes to unwatched parts of pages protected
+     for watchpoints.  */
+  if (skip_false_cond_breakpoint (lp, status)
+      || skip_page_watchpoint_fault (lp, &status))
+    goto retry;
+
   /* We'll need this to determine whether to report a SIGSTOP as
      GDB_SIGNAL_0.  Need to take a copy because resume_clear_callback
      clears it.  */
@@ -3742,10 +4673,7 @@ linux_nat_target::kill ()
     {
       /* Stop all threads before killing them, since ptrace requires
 	 that the thread is stopped to successfully PTRACE_KILL.  */
-      iterate_over_lwps (pid_ptid, stop_callback);
-      /* ... and wait until all of them have reported back that
-	 they're no longer running.  */
-      iterate_over_lwps (pid_ptid, stop_wait_callback);
+      stop_and_wait_lwps (pid_ptid);
 
       /* Kill all LWP's ...  */
       iterate_over_lwps (pid_ptid, kill_callback);
@@ -3768,6 +4696,18 @@ linux_nat_target::mourn_inferior ()
 
   close_proc_mem_file (pid);
 
+  page_watch_states.erase (pid);
+
+  const address_space *aspace = current_inferior ()->aspace.get ();
+  for (auto iter = cond_breakpoints.begin ();
+       iter != cond_breakpoints.end ();)
+    {
+      if (iter->first.first == aspace)
+	iter = cond_breakpoints.erase (iter);
+      else
+	++iter;
+    }
+
   if (! forks_exist_p ())
     /* Normal case, no other forks available.  */
     inf_ptrace_target::mourn_inferior ();
@@ -3853,11 +4793,6 @@ linux_nat_xfer_osdata (enum target_object object,
 		       const gdb_byte *writebuf, ULONGEST offset, ULONGEST len,
 		       ULONGEST *xfered_len);
 
-static enum target_xfer_status
-linux_proc_xfer_memory_partial (int pid, gdb_byte *readbuf,
-				const gdb_byte *writebuf, ULONGEST offset,
-				LONGEST len, ULONGEST *xfered_len);
-
 /* Look for an LWP of PID that we know is ptrace-stopped.  Returns
    NULL if none is found.  */
 
@@ -3997,7 +4932,34 @@ linux_nat_target::pid_to_str (ptid_t ptid)
 const char *
 linux_nat_target::thread_name (struct thread_info *thr)
 {
-  return linux_proc_tid_get_name (thr->ptid);
+  lwp_info *lp = find_lwp_pid (thr->ptid);
+
+  /* The name of a running thread may change at any time, so always
+     read it anew.  */
+  if (lp == nullptr || !lp->stopped)
+    return linux_proc_tid_get_name (thr->ptid);
+
+  if (!lp->name.has_value ())
+    {
+      /* Reading the names of all threads of a process at once is much
+	 faster than reading them one by one, e.g. for "info threads",
+	 so fill in the names of all the stopped LWPs of the process
+	 whose name is not known yet.  */
+      int pid = thr->ptid.pid ();
+      linux_proc_task_names (pid, [=] (long lwp, const char *name)
+	{
+	  lwp_info *other = find_lwp_pid (ptid_t (pid, lwp));
+
+	  if (other != nullptr && other->stopped && !other->name.has_value ())
+	    other->name.emplace (name);
+	});
+
+      /* The thread may have disappeared from /proc in the meantime.  */
+      if (!lp->name.has_value ())
+	return linux_proc_tid_get_name (thr->ptid);
+    }
+
+  return lp->name->c_str ();
 }
 
 /* Accepts an integer PID; Returns a string representing a file that
@@ -4730,6 +5692,18 @@ When on, print debug messages relating to the GNU/Linux native target."),
 			   show_debug_linux_nat,
 			   &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("page-watchpoints", class_breakpoint,
+			   &page_watchpoints, _("\
+Set whether to watch large regions by write-protecting their pages."), _("\
+Show whether to watch large regions by write-protecting their pages."), _("\
+When on, write watchpoints on regions too large for the debug registers\n\
+are implemented by write-protecting the pages of the regions, instead of\n\
+single-stepping the program.  System calls of the program that write to\n\
+those pages fail with EFAULT."),
+			   nullptr,
+			   nullptr,
+			   &setlist, &showlist);
+
   add_setshow_boolean_cmd ("linux-namespaces", class_maintenance,
 			   &debug_linux_namespaces, _("\
 Set debugging of GNU/Linux namespaces module."), _("\
@@ -73,6 +73,12 @@ class linux_nat_target : public inf_ptrace_target
 
   bool stopped_data_address (CORE_ADDR *) override;
 
+  int insert_breakpoint (struct gdbarch *, struct bp_target_info *) override;
+  int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
+			 enum remove_bp_reason) override;
+
+  bool supports_evaluation_of_breakpoint_conditions () override;
+
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
 
@@ -180,6 +186,14 @@ class linux_nat_target : public inf_ptrace_target
   virtual void low_prepare_to_resume (struct lwp_info *)
   {}
 
+  /* Make the process of the ptrace-stopped LWP TID call mprotect
+     (ADDR, LEN, PROT), leaving the LWP as it was.  Return true if the
+     call succeeded.  The default can't make system calls in the
+     inferior, and returns false.  */
+  virtual bool low_inferior_mprotect (pid_t tid, CORE_ADDR addr,
+				      ULONGEST len, int prot)
+  { return false; }
+
   /* Convert a ptrace/host siginfo object, into/from the siginfo in
      the layout of the inferiors' architecture.  Returns true if any
      conversion was done; false otherwise, in which case the caller
@@ -230,6 +244,11 @@ struct lwp_info : intrusive_list_node<lwp_info>
   /* Non-zero if this LWP is stopped.  */
   int stopped = 0;
 
+  /* The name of this LWP, as read from /proc while it is stopped.  It
+     is reset whenever the LWP is resumed or reports a stop, since it
+     can change it while running.  */
+  std::optional<std::string> name;
+
   /* Non-zero if this LWP will be/has been resumed.  Note that an LWP
      can be marked both as stopped and resumed at the same time.  This
      happens if we try to resume an LWP that has a wait status
@@ -346,4 +365,31 @@ void linux_nat_switch_fork (ptid_t new_ptid);
    uninitialized in such case).  */
 bool linux_nat_get_siginfo (ptid_t ptid, siginfo_t *siginfo);
 
+/* Return true if "set page-watchpoints" is on.  */
+
+extern bool linux_nat_page_watchpoints_p ();
+
+/* Return true if the LEN bytes at ADDR in the current inferior can be
+   watched by write-protecting the pages holding them: "set
+   page-watchpoints" is on, and the pages are mapped and don't hold a
+   stack.  */
+
+extern bool linux_nat_page_watchpoint_ok_p (CORE_ADDR addr, int len);
+
+/* Watch writes to the LEN bytes at ADDR in the current inferior by
+   write-protecting the pages holding them.  Return 0 on success, and
+   non-zero on failure, like the insert_watchpoint target method.  */
+
+extern int linux_nat_insert_page_watchpoint (CORE_ADDR addr, int len);
+
+/* Remove the page-protection watchpoint on the LEN bytes at ADDR in
+   the current inferior.  Return 0 on success.  */
+
+extern int linux_nat_remove_page_watchpoint (CORE_ADDR addr, int len);
+
+/* Return true if the current inferior has a page-protection
+   watchpoint on the LEN bytes at ADDR.  */
+
+extern bool linux_nat_page_watchpoint_p (CORE_ADDR addr, int len);
+
 #endif /* LINUX_NAT_H */
@@ -235,11 +235,53 @@ struct linux_info
 
   /* Inferior's displaced step buffers.  */
   std::optional<displaced_step_buffers> disp_step_bufs;
+
+  /* The number of displaced step buffers requested when
+     DISP_STEP_BUFS was created.  There may be fewer buffers, see
+     linux_displaced_step_prepare.  */
+  unsigned int disp_step_bufs_requested = 0;
+
+  /* The number of buffers of DISP_STEP_BUFS.  */
+  unsigned int disp_step_bufs_count = 0;
 };
 
 /* Per-inferior data key.  */
 static const registry<inferior>::key<linux_info> linux_inferior_data;
 
+/* The number of displaced stepping buffers requested with "set
+   displaced-stepping-buffers", or 0 to use the architecture's
+   default.  */
+static unsigned int displaced_stepping_buffers = 0;
+
+/* Implement "show displaced-stepping-buffers".  */
+
+static void
+show_displaced_stepping_buffers (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  if (displaced_stepping_buffers == 0)
+    {
+      gdb_printf (file, _("The number of displaced stepping buffers is "
+			  "the architecture's default.\n"));
+      return;
+    }
+
+  /* Tell if the current inferior got fewer buffers than requested.  */
+  linux_info *info = linux_inferior_data.get (current_inferior ());
+  if (info != nullptr
+      && info->disp_step_bufs.has_value ()
+      && info->disp_step_bufs_requested == displaced_stepping_buffers
+      && info->disp_step_bufs_count < displaced_stepping_buffers)
+    gdb_printf (file, _("The number of displaced stepping buffers is %s, "
+			"but only %u fit after the entry point of the "
+			"current inferior.\n"),
+		value, info->disp_step_bufs_count);
+  else
+    gdb_printf (file, _("The number of displaced stepping buffers is %s.\n"),
+		value);
+}
+
 /* Frees whatever allocated space there is to be freed and sets INF's
    linux cache data pointer to NULL.  */
 
@@ -2507,6 +2549,19 @@ linux_displaced_step_prepare (gdbarch *arch, thread_info *thread,
 			      CORE_ADDR &displaced_pc)
 {
   linux_info *per_inferior = get_linux_inferior_data (thread->inf);
+  linux_gdbarch_data *gdbarch_data = get_linux_gdbarch_data (arch);
+  gdb_assert (gdbarch_data->num_disp_step_buffers > 0);
+
+  unsigned int num_buffers = displaced_stepping_buffers;
+  if (num_buffers == 0)
+    num_buffers = gdbarch_data->num_disp_step_buffers;
+
+  /* Apply a new "set displaced-stepping-buffers" once no buffer is in
+     use.  */
+  if (per_inferior->disp_step_bufs.has_value ()
+      && !per_inferior->disp_step_bufs->in_use ()
+      && per_inferior->disp_step_bufs_requested != num_buffers)
+    per_inferior->disp_step_bufs.reset ();
 
   if (!per_inferior->disp_step_bufs.has_value ())
     {
@@ -2516,11 +2571,30 @@ linux_displaced_step_prepare (gdbarch *arch, thread_info *thread,
 	= linux_displaced_step_location (thread->inf->arch ());
       int buf_len = gdbarch_displaced_step_buffer_length (arch);
 
-      linux_gdbarch_data *gdbarch_data = get_linux_gdbarch_data (arch);
-      gdb_assert (gdbarch_data->num_disp_step_buffers > 0);
+      per_inferior->disp_step_bufs_requested = num_buffers;
+
+      /* Buffers beyond those of the architecture would overwrite the
+	 code following the function holding the entry point, so only
+	 add them if that function is known and large enough.  */
+      unsigned int max_buffers = gdbarch_data->num_disp_step_buffers;
+      CORE_ADDR func_end;
+      if (find_pc_partial_function (disp_step_buf_addr, nullptr, nullptr,
+				    &func_end)
+	  && func_end > disp_step_buf_addr)
+	max_buffers = std::max<CORE_ADDR> (max_buffers,
+					   ((func_end - disp_step_buf_addr)
+					    / buf_len));
+      if (num_buffers > max_buffers)
+	{
+	  warning (_("Only %u of the %u displaced stepping buffers "
+		     "requested fit after the entry point."),
+		   max_buffers, num_buffers);
+	  num_buffers = max_buffers;
+	}
+      per_inferior->disp_step_bufs_count = num_buffers;
 
       std::vector<CORE_ADDR> buffers;
-      for (int i = 0; i < gdbarch_data->num_disp_step_buffers; i++)
+      for (unsigned int i = 0; i < num_buffers; i++)
 	buffers.push_back (disp_step_buf_addr + i * buf_len);
 
       per_inferior->disp_step_bufs.emplace (buffers);
@@ -2740,6 +2814,19 @@ _initialize_linux_tdep ()
   gdb::observers::inferior_execd.attach (linux_inferior_execd,
 					 "linux-tdep");
 
+  add_setshow_zuinteger_cmd ("displaced-stepping-buffers", class_run,
+			     &displaced_stepping_buffers, _("\
+Set the number of displaced stepping buffers."), _("\
+Show the number of displaced stepping buffers."), _("\
+This is the number of threads that can be stepped over breakpoints\n\
+using displaced stepping at the same time, in non-stop mode.  The\n\
+buffers are placed one after the other after the program's entry\n\
+point, so fewer buffers are used if they don't all fit there.  Zero\n\
+means to use the default of the architecture."),
+			     nullptr,
+			     show_displaced_stepping_buffers,
+			     &setlist, &showlist);
+
   add_setshow_boolean_cmd ("use-coredump-filter", class_files,
 			   &use_coredump_filter, _("\
 Set whether gcore should consider /proc/PID/coredump_filter."),
@@ -308,6 +308,10 @@ struct thread_db_thread_info : public private_thread_info
   /* Flag set when we see a TD_DEATH event for this thread.  */
   bool dying = false;
 
+  /* Flag set when the thread is resumed, since DYING may then change.
+     See thread_db_refresh_thread_state.  */
+  bool state_stale = false;
+
   /* Cached thread state.  */
   td_thrhandle_t th {};
   thread_t tid {};
@@ -425,6 +429,35 @@ thread_from_lwp (thread_info *stopped, ptid_t ptid)
   tp = stopped->inf->process_target ()->find_thread (ptid);
   return record_thread (info, tp, ptid, &th, &ti);
 }
+
+/* Fetch the user-level thread id of TP if it is not known yet.  When
+   the inferior has execution, the ids are not looked up when
+   libthread_db is loaded nor at each stop, but only when they are
+   needed, see try_thread_db_load_1.  This is only possible while TP
+   is stopped.  */
+
+static void
+thread_db_resolve_thread (thread_info *tp)
+{
+  if (tp->priv != NULL
+      || tp->state == THREAD_EXITED
+      || tp->executing ()
+      || !tp->inf->has_execution ()
+      || get_thread_db_info (tp->inf->process_target (),
+			     tp->ptid.pid ()) == NULL)
+    return;
+
+  try
+    {
+      thread_from_lwp (tp, tp->ptid);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      if (libthread_db_debug)
+	exception_fprintf (gdb_stdlog, except,
+			   "Warning: thread_db_resolve_thread: ");
+    }
+}
 
 
 /* See linux-nat.h.  */
@@ -445,7 +478,8 @@ thread_db_notice_clone (ptid_t parent, ptid_t child)
 
   /* If we do not know about the main thread's pthread info yet, this
      would be a good time to find it.  */
-  thread_from_lwp (stopped, parent);
+  if (stopped->priv == NULL)
+    thread_from_lwp (stopped, parent);
   return 1;
 }
 
@@ -920,13 +954,36 @@ try_thread_db_load_1 (struct thread_db_info *info)
       int pid = inferior_ptid.pid ();
       thread_info *curr_thread = inferior_thread ();
 
-      linux_stop_and_wait_all_lwps ();
+      bool all_stopped = true;
+      for (thread_info *tp : curr_thread->inf->non_exited_threads ())
+	if (tp->executing ())
+	  {
+	    all_stopped = false;
+	    break;
+	  }
 
-      for (const lwp_info *lp : all_lwps ())
-	if (lp->ptid.pid () == pid)
-	  thread_from_lwp (curr_thread, lp->ptid);
+      if (all_stopped)
+	{
+	  /* Mapping each LWP to its user-level thread takes several
+	     memory reads, which adds up for processes with many
+	     threads.  Only look up the current thread now; the others
+	     are looked up when they report an event, or when their
+	     user-level id is needed, see thread_db_resolve_thread.  */
+	  thread_from_lwp (curr_thread, curr_thread->ptid);
+	}
+      else
+	{
+	  /* Some threads are running, and would not be stopped when
+	     their ids are needed.  Stop them to look up all ids
+	     now.  */
+	  linux_stop_and_wait_all_lwps ();
+
+	  for (const lwp_info *lp : all_lwps ())
+	    if (lp->ptid.pid () == pid)
+	      thread_from_lwp (curr_thread, lp->ptid);
 
-      linux_unstop_all_lwps ();
+	  linux_unstop_all_lwps ();
+	}
     }
   else if (thread_db_find_new_threads_silently (inferior_thread ()) != 0)
     {
@@ -1336,6 +1393,7 @@ update_thread_state (thread_db_thread_info *priv,
 {
   priv->dying = (ti_p->ti_state == TD_THR_UNKNOWN
 		 || ti_p->ti_state == TD_THR_ZOMBIE);
+  priv->state_stale = false;
 }
 
 /* Record a new thread in GDB's thread list.  Creates the thread's
@@ -1416,8 +1474,12 @@ thread_db_target::wait (ptid_t ptid, struct target_waitstatus *ourstatus,
   if (info == NULL)
     return ptid;
 
-  /* Fill in the thread's user-level thread id and status.  */
-  thread_from_lwp (beneath->find_thread (ptid), ptid);
+  /* Fill in the thread's user-level thread id and status, unless
+     already known.  The id does not change for the life of the
+     thread.  */
+  thread_info *tp = beneath->find_thread (ptid);
+  if (tp->priv == NULL)
+    thread_from_lwp (tp, ptid);
 
   return ptid;
 }
@@ -1657,6 +1719,9 @@ thread_db_target::pid_to_str (ptid_t ptid)
 {
   thread_info *thread_info = current_inferior ()->find_thread (ptid);
 
+  if (thread_info != NULL)
+    thread_db_resolve_thread (thread_info);
+
   if (thread_info != NULL && thread_info->priv != NULL)
     {
       thread_db_thread_info *priv = get_thread_db_thread_info (thread_info);
@@ -1668,15 +1733,56 @@ thread_db_target::pid_to_str (ptid_t ptid)
   return beneath ()->pid_to_str (ptid);
 }
 
+/* Re-read the state of TP, a thread whose user-level thread id is
+   known, from libthread_db if TP ran since it was last read.  This
+   is only possible while TP is stopped.  */
+
+static void
+thread_db_refresh_thread_state (thread_info *tp)
+{
+  thread_db_thread_info *priv = get_thread_db_thread_info (tp);
+
+  if (!priv->state_stale
+      || tp->state == THREAD_EXITED
+      || tp->executing ()
+      || !tp->inf->has_execution ())
+    return;
+
+  thread_db_info *info = get_thread_db_info (tp->inf->process_target (),
+					     tp->ptid.pid ());
+  if (info == NULL)
+    return;
+
+  td_thrinfo_t ti;
+
+  /* Access an lwp we know is stopped.  */
+  info->proc_handle.thread = tp;
+  td_err_e err = info->td_thr_get_info_p (&priv->th, &ti);
+  if (err != TD_OK)
+    {
+      if (libthread_db_debug)
+	gdb_printf (gdb_stdlog,
+		    "Warning: thread_db_refresh_thread_state: %s\n",
+		    thread_db_err_str (err));
+      return;
+    }
+
+  update_thread_state (priv, &ti);
+}
+
 /* Return a string describing the state of the thread specified by
    INFO.  */
 
 const char *
 thread_db_target::extra_thread_info (thread_info *info)
 {
+  thread_db_resolve_thread (info);
+
   if (info->priv == NULL)
     return NULL;
 
+  thread_db_refresh_thread_state (info);
+
   thread_db_thread_info *priv = get_thread_db_thread_info (info);
 
   if (priv->dying)
@@ -1712,6 +1818,8 @@ thread_db_target::thread_handle_to_thread_info (const gdb_byte *thread_handle,
 
   for (thread_info *tp : inf->non_exited_threads ())
     {
+      thread_db_resolve_thread (tp);
+
       thread_db_thread_info *priv = get_thread_db_thread_info (tp);
 
       if (priv != NULL && handle_tid == priv->tid)
@@ -1726,6 +1834,8 @@ thread_db_target::thread_handle_to_thread_info (const gdb_byte *thread_handle,
 gdb::array_view<const gdb_byte>
 thread_db_target::thread_info_to_thread_handle (struct thread_info *tp)
 {
+  thread_db_resolve_thread (tp);
+
   thread_db_thread_info *priv = get_thread_db_thread_info (tp);
 
   if (priv == NULL)
@@ -1849,6 +1959,11 @@ thread_db_target::resume (ptid_t ptid, int step, enum gdb_signal signo)
   if (info)
     info->need_stale_parent_threads_check = 0;
 
+  /* The resumed threads may exit meanwhile.  */
+  for (thread_info *tp : all_non_exited_threads (beneath, ptid))
+    if (tp->priv != NULL)
+      get_thread_db_thread_info (tp)->state_stale = true;
+
   beneath->resume (ptid, step, signo);
 }
 
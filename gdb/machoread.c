@@ -936,6 +936,8 @@ static const struct sym_fns macho_sym_fns = {
   NULL,
   macho_symfile_relocate,	/* Relocate a debug section.  */
   NULL,				/* sym_get_probes */
+  NULL,				/* sym_prefetch */
+  NULL,				/* sym_prefetch_release */
 };
 
 void _initialize_machoread ();
@@ -40,11 +40,18 @@
 #include "gdbsupport/selftest.h"
 #include "inferior.h"
 #include "gdbsupport/thread-pool.h"
+#include "frame.h"
+#include "source-cache.h"
+#include "gdb-demangle.h"
+#include "symbol-name-filter.h"
+#include "gdbsupport/gdb_obstack.h"
+#include <unordered_set>
 
 #include "cli/cli-decode.h"
 #include "cli/cli-utils.h"
 #include "cli/cli-setshow.h"
 #include "cli/cli-cmds.h"
+#include "cli/cli-style.h"
 
 static void maintenance_do_deprecate (const char *, int);
 
@@ -518,6 +525,109 @@ maintenance_print_statistics (const char *args, int from_tty)
   print_objfile_statistics ();
 }
 
+/* See maint.h.  */
+
+std::vector<memory_usage_item>
+collect_memory_usage ()
+{
+  std::vector<memory_usage_item> result;
+  auto add = [&] (const char *subsystem, struct objfile *objfile,
+		  size_t bytes)
+    {
+      if (bytes != 0)
+	result.push_back ({ subsystem, objfile, bytes });
+    };
+
+  std::unordered_set<objfile_per_bfd_storage *> seen_per_bfd;
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      /* The symtabs, blocks, symbols and types of the objfile.  */
+      add ("objfile obstack", objfile,
+	   obstack_memory_used (&objfile->objfile_obstack));
+      add ("symbol name filter", objfile,
+	   symbol_name_filter_memory_used (objfile));
+
+      /* The per-BFD data may be shared by several objfiles.  */
+      objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+      if (!seen_per_bfd.insert (per_bfd).second)
+	continue;
+
+      add ("per-BFD obstack", objfile,
+	   obstack_memory_used (&per_bfd->storage_obstack));
+      add ("string cache", objfile, per_bfd->string_cache.memory_used ());
+      add ("minimal symbols", objfile,
+	   per_bfd->minimal_symbol_count * sizeof (minimal_symbol));
+      if (per_bfd->minsym_name_filter != nullptr)
+	add ("minimal symbol name filter", objfile,
+	     per_bfd->minsym_name_filter->memory_used ());
+
+      size_t index_bytes = 0;
+      for (const auto &iter : objfile->qf)
+	index_bytes += iter->memory_used (objfile);
+      add ("symbol index", objfile, index_bytes);
+    }
+
+  add ("section and compunit maps", nullptr,
+       objfiles_pspace_memory_used (current_program_space));
+  add ("frame cache", nullptr, frame_cache_memory_used ());
+  add ("source cache", nullptr, g_source_cache.memory_used ());
+  add ("value history", nullptr, value_history_memory_used ());
+  add ("demangled name cache", nullptr, demangle_cache_memory_used ());
+
+  return result;
+}
+
+/* The "maintenance info memory" command.  */
+
+static void
+maintenance_info_memory (const char *args, int from_tty)
+{
+  std::vector<memory_usage_item> usage = collect_memory_usage ();
+
+  /* The items of an objfile are consecutive.  */
+  size_t total = 0;
+  struct objfile *last_objfile = nullptr;
+  bool printed_global = false;
+  for (const memory_usage_item &item : usage)
+    {
+      if (item.objfile != nullptr && item.objfile != last_objfile)
+	gdb_printf (_("Memory used for objfile %ps:\n"),
+		    styled_string (file_name_style.style (),
+				   objfile_name (item.objfile)));
+      else if (item.objfile == nullptr && !printed_global)
+	{
+	  gdb_printf (_("Memory used for all objfiles:\n"));
+	  printed_global = true;
+	}
+      last_objfile = item.objfile;
+
+      gdb_printf (_("  %s: %s bytes\n"), item.subsystem,
+		  pulongest (item.bytes));
+      total += item.bytes;
+    }
+
+  /* The totals of the subsystems, in the order they were first
+     seen.  */
+  std::vector<std::pair<const char *, size_t>> totals;
+  for (const memory_usage_item &item : usage)
+    {
+      auto iter = std::find_if (totals.begin (), totals.end (),
+				[&] (const std::pair<const char *, size_t> &t)
+				{
+				  return strcmp (t.first, item.subsystem) == 0;
+				});
+      if (iter == totals.end ())
+	totals.emplace_back (item.subsystem, item.bytes);
+      else
+	iter->second += item.bytes;
+    }
+
+  gdb_printf (_("Total memory per subsystem:\n"));
+  for (const auto &t : totals)
+    gdb_printf (_("  %s: %s bytes\n"), t.first, pulongest (t.second));
+  gdb_printf (_("Total: %s bytes\n"), pulongest (total));
+}
+
 static void
 maintenance_print_architecture (const char *args, int from_tty)
 {
@@ -1261,6 +1371,16 @@ Options:\n\
 		 &maintenanceinfolist);
   set_cmd_completer_handle_brkchars (cmd, maint_info_sections_completer);
 
+  add_cmd ("memory", class_maintenance, maintenance_info_memory, _("\
+Show the memory used by GDB's symbol tables and caches.\n\
+\n\
+Print the number of bytes used by each subsystem of GDB for each\n\
+objfile of the current program space, such as obstacks, symbol\n\
+indices and minimal symbols, then by caches that are not specific to\n\
+an objfile, such as the frame cache, the source cache and the value\n\
+history, and finally the totals per subsystem."),
+	   &maintenanceinfolist);
+
   add_cmd ("target-sections", class_maintenance,
 	   maintenance_info_target_sections, _("\
 List GDB's internal section table.\n\
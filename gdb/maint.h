@@ -70,4 +70,28 @@ class scoped_command_stats
 extern obj_section *maint_obj_section_from_bfd_section (bfd *abfd,
 							asection *asection,
 							objfile *ofile);
+
+/* The memory used by one subsystem of GDB, as reported by
+   collect_memory_usage.  */
+
+struct memory_usage_item
+{
+  /* The name of the subsystem.  */
+  const char *subsystem;
+
+  /* The objfile the memory is used for, or nullptr if it isn't used
+     for a particular objfile.  */
+  struct objfile *objfile;
+
+  /* The number of bytes used.  */
+  size_t bytes;
+};
+
+/* Return the memory used by GDB's symbol and debug info data
+   structures for each objfile of the current program space, and by
+   its other main caches.  Data shared by several objfiles is only
+   reported for the first one.  Subsystems that use no memory are
+   omitted.  */
+
+extern std::vector<memory_usage_item> collect_memory_usage ();
 #endif /* MAINT_H */
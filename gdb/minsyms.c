@@ -388,6 +388,11 @@ lookup_minimal_symbol (const char *name, const char *sfile,
 				      name, sfile != NULL ? sfile : "NULL",
 				      objfile_debug_name (objfile));
 
+	  const symbol_name_filter *filter
+	    = objfile_minimal_symbol_name_filter (objfile);
+	  if (filter != nullptr && !filter->maybe_contains (name))
+	    continue;
+
 	  /* Do two passes: the first over the ordinary hash table,
 	     and the second over the demangled hash table.  */
 	  lookup_minimal_symbol_mangled (name, sfile, objfile,
@@ -1537,6 +1542,7 @@ minimal_symbol_reader::install ()
 	 });
 
       build_minimal_symbol_hash_tables (m_objfile, hash_values);
+      build_minimal_symbol_name_filter (m_objfile);
     }
 }
 
@@ -372,6 +372,8 @@ static const struct sym_fns ecoff_sym_fns =
   NULL,
   default_symfile_relocate,	/* Relocate a debug section.  */
   NULL,				/* sym_probe_fns */
+  NULL,				/* sym_prefetch */
+  NULL,				/* sym_prefetch_release */
 };
 
 void _initialize_mipsread ();
@@ -18,7 +18,9 @@
 
 #include "linux-procfs.h"
 #include "gdbsupport/filestuff.h"
+#include "gdbsupport/scoped_fd.h"
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unordered_set>
 #include <utility>
@@ -339,6 +341,50 @@ linux_proc_tid_get_name (ptid_t ptid)
 
 /* See linux-procfs.h.  */
 
+void
+linux_proc_task_names
+  (pid_t pid, gdb::function_view<void (long lwp, const char *name)> func)
+{
+  char pathname[128];
+
+  xsnprintf (pathname, sizeof (pathname), "/proc/%ld/task", (long) pid);
+  gdb_dir_up dir (opendir (pathname));
+  if (dir == NULL)
+    return;
+
+  /* Open the comm files relative to the task directory, to avoid
+     having the kernel look up /proc/PID again for each thread.  */
+  int dir_fd = dirfd (dir.get ());
+  struct dirent *dp;
+  while ((dp = readdir (dir.get ())) != NULL)
+    {
+      long lwp = strtol (dp->d_name, NULL, 10);
+      if (lwp <= 0)
+	continue;
+
+      char comm_path[64];
+      xsnprintf (comm_path, sizeof (comm_path), "%ld/comm", lwp);
+      scoped_fd comm_fd (openat (dir_fd, comm_path, O_RDONLY | O_CLOEXEC));
+      if (comm_fd.get () < 0)
+	continue;
+
+      char comm_buf[TASK_COMM_LEN + 1];
+      ssize_t len = read (comm_fd.get (), comm_buf, TASK_COMM_LEN);
+      if (len <= 0)
+	continue;
+
+      /* Make sure there is no newline at the end.  */
+      comm_buf[len] = '\0';
+      char *newline = strchr (comm_buf, '\n');
+      if (newline != NULL)
+	*newline = '\0';
+
+      func (lwp, comm_buf);
+    }
+}
+
+/* See linux-procfs.h.  */
+
 void
 linux_proc_attach_tgid_threads (pid_t pid,
 				linux_proc_attach_lwp_func attach_lwp)
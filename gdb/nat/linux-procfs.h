@@ -20,6 +20,7 @@
 #define NAT_LINUX_PROCFS_H
 
 #include <unistd.h>
+#include "gdbsupport/function-view.h"
 
 /* Return the TGID of LWPID from /proc/pid/status.  Returns -1 if not
    found.  Failure to open the /proc file results in a warning.  */
@@ -72,6 +73,15 @@ extern std::optional<std::string> linux_proc_get_stat_field (ptid_t ptid,
 
 extern const char *linux_proc_tid_get_name (ptid_t ptid);
 
+/* Call FUNC with the LWP id and the name of each thread listed in the
+   /proc/PID/task/ directory.  This reads the names of all the threads
+   of PID at once, which is much cheaper than calling
+   linux_proc_tid_get_name for each of them in turn.  Threads whose
+   name can't be read are skipped.  */
+
+extern void linux_proc_task_names
+  (pid_t pid, gdb::function_view<void (long lwp, const char *name)> func);
+
 /* Callback function for linux_proc_attach_tgid_threads.  If the PTID
    thread is not yet known, try to attach to it and return true,
    otherwise return false.  */
@@ -56,6 +56,35 @@
 /* Externally visible variables that are owned by this module.
    See declarations in objfile.h for more info.  */
 
+/* A compunit symtab whose code may contain the addresses of a
+   compunit_pc_segment.  */
+
+struct compunit_pc_candidate
+{
+  /* The order in which the compunit is found by iterating over the
+     objfiles and their compunits.  Lower comes first.  */
+  uint64_t order;
+
+  struct compunit_symtab *cust;
+};
+
+/* A range of addresses in the compunit PC map, from START to the
+   START of the next segment.  Its candidates are the elements
+   FIRST_CANDIDATE to the FIRST_CANDIDATE of the next segment of the
+   candidate array, sorted by order.  */
+
+struct compunit_pc_segment
+{
+  CORE_ADDR start;
+  size_t first_candidate;
+};
+
+/* The number of compunits that can be added after the compunit PC map
+   was built, before it is built again.  The compunits added since the
+   map was built are searched linearly.  */
+
+static constexpr size_t max_new_compunits = 64;
+
 struct objfile_pspace_info
 {
   objfile_pspace_info () = default;
@@ -73,6 +102,28 @@ struct objfile_pspace_info
 
   /* Nonzero if section map updates should be inhibited if possible.  */
   int inhibit_updates = 0;
+
+  /* The compunit PC map: the address ranges of the code of the
+     compunit symtabs of all the objfiles, as a sorted array of
+     segments that don't overlap, and the compunits of each
+     segment.  See iterate_over_compunits_at_pc.  */
+  std::vector<compunit_pc_segment> compunit_segments;
+  std::vector<compunit_pc_candidate> compunit_candidates;
+
+  /* The position of each objfile in the list of objfiles when the
+     compunit PC map was built.  */
+  std::unordered_map<objfile *, uint64_t> compunit_objfile_rank;
+
+  /* The compunits added since the compunit PC map was built, with
+     their order.  */
+  std::vector<compunit_pc_candidate> new_compunits;
+
+  /* The order of the last compunit added.  Compunits are added at the
+     front of the list of their objfile, so this decreases.  */
+  uint64_t last_new_compunit_order = UINT32_MAX;
+
+  /* True if the compunit PC map MUST be built again before use.  */
+  bool compunit_map_dirty = true;
 };
 
 /* Per-program-space data key.  */
@@ -463,6 +514,7 @@ objfile::make (gdb_bfd_ref_ptr bfd_, const char *name_, objfile_flags flags_,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->new_objfiles_available = 1;
+  get_objfile_pspace_data (current_program_space)->compunit_map_dirty = true;
 
   return result;
 }
@@ -574,8 +626,12 @@ objfile::~objfile ()
       clear_current_source_symtab_and_line ();
   }
 
-  /* Rebuild section map next time we need it.  */
-  get_objfile_pspace_data (pspace)->section_map_dirty = 1;
+  /* Rebuild section map next time we need it.  The compunit PC map
+     refers to the compunits of this objfile, so forget it now.  */
+  struct objfile_pspace_info *pspace_info = get_objfile_pspace_data (pspace);
+  pspace_info->section_map_dirty = 1;
+  pspace_info->compunit_map_dirty = true;
+  pspace_info->new_compunits.clear ();
 }
 
 
@@ -652,8 +708,10 @@ objfile_relocate1 (struct objfile *objfile,
   for (int i = 0; i < objfile->section_offsets.size (); ++i)
     objfile->section_offsets[i] = new_offsets[i];
 
-  /* Rebuild section map next time we need it.  */
+  /* Rebuild section map and compunit PC map next time we need
+     them.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  get_objfile_pspace_data (objfile->pspace)->compunit_map_dirty = true;
 
   /* Update the table in exec_ops, used to read memory.  */
   for (obj_section *s : objfile->sections ())
@@ -1186,6 +1244,243 @@ pc_in_section (CORE_ADDR pc, const char *name)
 }
 
 
+/* Call CALLBACK with each address range [START, END) where the code
+   of CUST may be.  That is the range of its global block, restricted
+   to the ranges of the block map, if it has one.  */
+
+static void
+map_compunit_pc_ranges
+  (struct compunit_symtab *cust,
+   gdb::function_view<void (CORE_ADDR start, CORE_ADDR end)> callback)
+{
+  const struct blockvector *bv = cust->blockvector ();
+  if (bv == nullptr)
+    return;
+
+  const struct block *global_block = bv->global_block ();
+  CORE_ADDR start = global_block->start ();
+  CORE_ADDR end = global_block->end ();
+  if (start >= end)
+    return;
+
+  if (bv->map () == nullptr)
+    {
+      callback (start, end);
+      return;
+    }
+
+  /* The transitions of the map are in order.  Report each range that
+     is mapped to a block, once its end is known.  */
+  std::optional<CORE_ADDR> range_start;
+  bv->map ()->foreach ([&] (CORE_ADDR addr, const void *obj)
+    {
+      if (range_start.has_value ())
+	{
+	  CORE_ADDR s = std::max (*range_start, start);
+	  CORE_ADDR e = std::min (addr, end);
+	  if (s < e)
+	    callback (s, e);
+	  range_start.reset ();
+	}
+      if (obj != nullptr)
+	range_start = addr;
+      return 0;
+    });
+
+  if (range_start.has_value () && std::max (*range_start, start) < end)
+    callback (std::max (*range_start, start), end);
+}
+
+/* Build the compunit PC map of PSPACE again, from the compunits of all
+   its objfiles.  */
+
+static void
+update_compunit_pc_map (struct program_space *pspace)
+{
+  struct objfile_pspace_info *pspace_info = get_objfile_pspace_data (pspace);
+
+  /* An address range of a compunit, and where it starts or ends.  */
+  struct pc_event
+  {
+    CORE_ADDR addr;
+    bool is_start;
+    compunit_pc_candidate candidate;
+  };
+  std::vector<pc_event> events;
+
+  pspace_info->compunit_objfile_rank.clear ();
+  uint64_t rank = 0;
+  for (objfile *objfile : pspace->objfiles ())
+    {
+      pspace_info->compunit_objfile_rank[objfile] = rank;
+
+      uint64_t index = (uint64_t) UINT32_MAX + 1;
+      for (compunit_symtab *cust : objfile->compunits ())
+	{
+	  compunit_pc_candidate candidate { (rank << 33) + index, cust };
+	  map_compunit_pc_ranges (cust, [&] (CORE_ADDR start, CORE_ADDR end)
+	    {
+	      events.push_back ({ start, true, candidate });
+	      events.push_back ({ end, false, candidate });
+	    });
+	  ++index;
+	}
+      ++rank;
+    }
+
+  /* Sweep over the ranges in address order, and start a segment at
+     every address where the set of candidates changes.  */
+  std::sort (events.begin (), events.end (),
+	     [] (const pc_event &a, const pc_event &b)
+	     {
+	       return a.addr < b.addr;
+	     });
+
+  std::vector<compunit_pc_segment> segments;
+  std::vector<compunit_pc_candidate> candidates;
+  std::vector<compunit_pc_candidate> active;
+  for (size_t i = 0; i < events.size (); )
+    {
+      CORE_ADDR addr = events[i].addr;
+      for (; i < events.size () && events[i].addr == addr; ++i)
+	{
+	  const pc_event &event = events[i];
+	  if (event.is_start)
+	    active.push_back (event.candidate);
+	  else
+	    {
+	      auto it = std::find_if (active.begin (), active.end (),
+				      [&] (const compunit_pc_candidate &c)
+				      {
+					return c.order == event.candidate.order;
+				      });
+	      gdb_assert (it != active.end ());
+	      active.erase (it);
+	    }
+	}
+
+      std::sort (active.begin (), active.end (),
+		 [] (const compunit_pc_candidate &a,
+		     const compunit_pc_candidate &b)
+		 {
+		   return a.order < b.order;
+		 });
+      segments.push_back ({ addr, candidates.size () });
+      candidates.insert (candidates.end (), active.begin (), active.end ());
+    }
+
+  /* A sentinel, so that the candidates of every segment end where
+     those of the next one begin.  */
+  segments.push_back ({ 0, candidates.size () });
+
+  pspace_info->compunit_segments = std::move (segments);
+  pspace_info->compunit_candidates = std::move (candidates);
+  pspace_info->new_compunits.clear ();
+  pspace_info->last_new_compunit_order = UINT32_MAX;
+  pspace_info->compunit_map_dirty = false;
+}
+
+/* See objfiles.h.  */
+
+void
+compunit_symtab_added (struct compunit_symtab *cust)
+{
+  struct objfile_pspace_info *pspace_info
+    = get_objfile_pspace_data (cust->objfile ()->pspace);
+  if (pspace_info->compunit_map_dirty)
+    return;
+
+  auto rank = pspace_info->compunit_objfile_rank.find (cust->objfile ());
+  if (rank == pspace_info->compunit_objfile_rank.end ()
+      || pspace_info->new_compunits.size () >= max_new_compunits)
+    {
+      pspace_info->compunit_map_dirty = true;
+      pspace_info->new_compunits.clear ();
+      return;
+    }
+
+  /* The compunit is added at the front of the list of its objfile, so
+     it comes before those already in the map.  */
+  uint64_t order = (rank->second << 33) + pspace_info->last_new_compunit_order;
+  --pspace_info->last_new_compunit_order;
+  pspace_info->new_compunits.push_back ({ order, cust });
+}
+
+/* See objfiles.h.  */
+
+void
+iterate_over_compunits_at_pc
+  (CORE_ADDR pc,
+   gdb::function_view<bool (struct compunit_symtab *cust)> callback)
+{
+  struct objfile_pspace_info *pspace_info
+    = get_objfile_pspace_data (current_program_space);
+  if (pspace_info->compunit_map_dirty)
+    update_compunit_pc_map (current_program_space);
+
+  /* Copy the candidates, since CALLBACK may expand symtabs and so
+     change the map.  */
+  std::vector<compunit_pc_candidate> found;
+
+  const std::vector<compunit_pc_segment> &segments
+    = pspace_info->compunit_segments;
+  auto seg = std::upper_bound (segments.begin (), segments.end () - 1, pc,
+			       [] (CORE_ADDR addr,
+				   const compunit_pc_segment &segment)
+			       {
+				 return addr < segment.start;
+			       });
+  if (seg != segments.begin ())
+    {
+      --seg;
+      found.insert (found.end (),
+		    (pspace_info->compunit_candidates.begin ()
+		     + seg[0].first_candidate),
+		    (pspace_info->compunit_candidates.begin ()
+		     + seg[1].first_candidate));
+    }
+
+  bool found_new = false;
+  for (const compunit_pc_candidate &candidate : pspace_info->new_compunits)
+    map_compunit_pc_ranges (candidate.cust,
+			    [&] (CORE_ADDR start, CORE_ADDR end)
+      {
+	if (start <= pc && pc < end
+	    && (found.empty () || found.back ().cust != candidate.cust))
+	  {
+	    found.push_back (candidate);
+	    found_new = true;
+	  }
+      });
+
+  if (found_new)
+    std::sort (found.begin (), found.end (),
+	       [] (const compunit_pc_candidate &a,
+		   const compunit_pc_candidate &b)
+	       {
+		 return a.order < b.order;
+	       });
+
+  for (const compunit_pc_candidate &candidate : found)
+    if (callback (candidate.cust))
+      break;
+}
+
+/* See objfiles.h.  */
+
+size_t
+objfiles_pspace_memory_used (struct program_space *pspace)
+{
+  struct objfile_pspace_info *info = get_objfile_pspace_data (pspace);
+  return (info->num_sections * sizeof (struct obj_section *)
+	  + (info->compunit_segments.capacity ()
+	     * sizeof (compunit_pc_segment))
+	  + (info->compunit_candidates.capacity ()
+	     * sizeof (compunit_pc_candidate))
+	  + (info->new_compunits.capacity ()
+	     * sizeof (compunit_pc_candidate)));
+}
+
 /* Set section_map_dirty so section map will be rebuilt next time it
    is used.  Called by reread_symbols.  */
 
@@ -1194,6 +1489,10 @@ objfiles_changed (void)
 {
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->section_map_dirty = 1;
+
+  /* Likewise the compunit PC map, whose compunits may be gone.  */
+  get_objfile_pspace_data (current_program_space)->compunit_map_dirty = true;
+  get_objfile_pspace_data (current_program_space)->new_compunits.clear ();
 }
 
 /* See comments in objfiles.h.  */
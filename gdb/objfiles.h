@@ -31,6 +31,7 @@
 #include "gdbarch.h"
 #include "jit.h"
 #include "quick-symbol.h"
+#include "symbol-name-filter.h"
 #include <forward_list>
 
 struct htab;
@@ -323,6 +324,10 @@ struct objfile_per_bfd_storage
      hash table.  */
   std::bitset<nr_languages> demangled_hash_languages;
 
+  /* An approximate set of the names of the minimal symbols, to skip
+     this per-BFD quickly in lookup_minimal_symbol.  */
+  std::unique_ptr<symbol_name_filter> minsym_name_filter;
+
 private:
   /* The BFD this object is associated to.  */
 
@@ -546,10 +551,15 @@ struct objfile
      If a match is found, the "partial" symbol table is expanded.
      Then, this calls iterate_over_some_symtabs (or equivalent) over
      all newly-created symbol tables, passing CALLBACK to it.
-     The result of this call is returned.  */
+     The result of this call is returned.
+
+     If LINE is positive, the caller is only interested in code for
+     that line of NAME, or for the first line with code after it, and
+     symbol tables known to have no such code may be left
+     unexpanded.  */
   bool map_symtabs_matching_filename
     (const char *name, const char *real_path,
-     gdb::function_view<bool (symtab *)> callback);
+     gdb::function_view<bool (symtab *)> callback, int line = 0);
 
   /* Check to see if the symbol is defined in a "partial" symbol table
      of this objfile.  BLOCK_INDEX should be either GLOBAL_BLOCK or
@@ -608,6 +618,10 @@ struct objfile
   /* See quick_symbol_functions.  */
   void compute_main_name ();
 
+  /* Call map_symbol_names on each of the quick symbol functions.
+     Return false if any of them returned false.  */
+  bool map_symbol_names (gdb::function_view<void (const char *)> callback);
+
   /* See quick_symbol_functions.  */
   struct compunit_symtab *find_compunit_symtab_by_address (CORE_ADDR address);
 
@@ -955,6 +969,30 @@ extern int have_minimal_symbols (void);
 
 extern struct obj_section *find_pc_section (CORE_ADDR pc);
 
+/* Call CALLBACK with each compunit symtab of the current program space
+   whose code may contain PC, until CALLBACK returns true.  The
+   compunits are passed in the order in which iterating over the
+   objfiles and over their compunits finds them.  The compunits whose
+   global block doesn't contain PC, and those whose block map doesn't
+   map PC, are never passed.
+
+   This uses a sorted map of the address ranges of all the compunits,
+   built again when objfiles are added, removed or relocated.  */
+
+extern void iterate_over_compunits_at_pc
+  (CORE_ADDR pc,
+   gdb::function_view<bool (struct compunit_symtab *cust)> callback);
+
+/* Record that CUST was added to its objfile, for
+   iterate_over_compunits_at_pc.  */
+
+extern void compunit_symtab_added (struct compunit_symtab *cust);
+
+/* Return the number of bytes of memory used by the section map and the
+   compunit PC map of PSPACE.  */
+
+extern size_t objfiles_pspace_memory_used (struct program_space *pspace);
+
 /* Return true if PC is in a section called NAME.  */
 extern bool pc_in_section (CORE_ADDR, const char *);
 
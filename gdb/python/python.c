@@ -76,6 +76,7 @@ static const char *gdbpy_should_print_stack = python_excp_message;
 #include "interps.h"
 #include "event-top.h"
 #include "py-event.h"
+#include "maint.h"
 
 /* True if Python has been successfully initialized, false
    otherwise.  */
@@ -1698,6 +1699,56 @@ gdbpy_current_language (PyObject *unused1, PyObject *unused2)
   return host_string_to_python_string (current_language->name ()).release ();
 }
 
+/* Implement gdb.memory_usage.  Return a list of (SUBSYSTEM, OBJFILE,
+   BYTES) tuples, where OBJFILE is None for memory that isn't used for
+   a particular objfile.  */
+
+static PyObject *
+gdbpy_memory_usage (PyObject *unused1, PyObject *unused2)
+{
+  std::vector<memory_usage_item> usage;
+  try
+    {
+      usage = collect_memory_usage ();
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  gdbpy_ref<> list (PyList_New (0));
+  if (list == nullptr)
+    return nullptr;
+
+  for (const memory_usage_item &item : usage)
+    {
+      gdbpy_ref<> objfile;
+      if (item.objfile != nullptr)
+	{
+	  objfile = objfile_to_objfile_object (item.objfile);
+	  if (objfile == nullptr)
+	    return nullptr;
+	}
+      else
+	objfile = gdbpy_ref<>::new_reference (Py_None);
+
+      gdbpy_ref<> subsystem = host_string_to_python_string (item.subsystem);
+      if (subsystem == nullptr)
+	return nullptr;
+      gdbpy_ref<> bytes = gdb_py_object_from_ulongest (item.bytes);
+      if (bytes == nullptr)
+	return nullptr;
+
+      gdbpy_ref<> tuple (PyTuple_Pack (3, subsystem.get (), objfile.get (),
+				       bytes.get ()));
+      if (tuple == nullptr
+	  || PyList_Append (list.get (), tuple.get ()) == -1)
+	return nullptr;
+    }
+
+  return list.release ();
+}
+
 
 
 /* See python.h.  */
@@ -2676,6 +2727,11 @@ Arguments (also strings) are passed to the command." },
   { "progspaces", gdbpy_progspaces, METH_NOARGS,
     "Return a sequence of all progspaces." },
 
+  { "memory_usage", gdbpy_memory_usage, METH_NOARGS,
+    "memory_usage () -> List.\n\
+Return a list of (subsystem, objfile, bytes) tuples describing the memory\n\
+used by GDB's symbol tables and caches." },
+
   { "current_objfile", gdbpy_get_current_objfile, METH_NOARGS,
     "Return the current Objfile being loaded, or None." },
 
@@ -156,6 +156,26 @@ struct quick_symbol_functions
      block_search_flags search_flags,
      domain_search_flags domain) = 0;
 
+  /* Expand the symbol tables in OBJFILE for the files matched by
+     FILE_MATCHER, like expand_symtabs_matching does when it is only
+     given FILE_MATCHER and EXPANSION_NOTIFY.  The caller is only
+     interested in code for source line LINE, or for the first line
+     with code after it, so an implementation may skip the symbol
+     tables that have no code for a line greater than or equal to LINE
+     in those files.  The default implementation does not skip
+     anything.  */
+  virtual bool expand_symtabs_for_source_line
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     int line,
+     gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+  {
+    return expand_symtabs_matching (objfile, file_matcher, nullptr, nullptr,
+				    expansion_notify,
+				    SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
+				    SEARCH_ALL_DOMAINS);
+  }
+
   /* Return the comp unit from OBJFILE that contains PC and
      SECTION.  Return NULL if there is no such compunit.  This
      should return the compunit that contains a symbol whose
@@ -191,6 +211,25 @@ struct quick_symbol_functions
   virtual void compute_main_name (struct objfile *objfile)
   {
   }
+
+  /* Return the number of bytes of memory used by the index of
+     OBJFILE.  Memory shared with other objfiles should only be
+     counted once.  The default implementation returns 0.  */
+  virtual size_t memory_used (struct objfile *objfile)
+  {
+    return 0;
+  }
+
+  /* Call CALLBACK with the name of every global or static symbol that
+     lookup_symbol might find in OBJFILE, and return true.  Other
+     names may be passed too.  If the names can't be listed, return
+     false, which is what the default implementation does.  */
+  virtual bool map_symbol_names
+    (struct objfile *objfile,
+     gdb::function_view<void (const char *)> callback)
+  {
+    return false;
+  }
 };
 
 typedef std::unique_ptr<quick_symbol_functions> quick_symbol_functions_up;
@@ -105,6 +105,9 @@ class record_btrace_target final : public target_ops
 					ULONGEST *xfered_len,
 					unsigned int addr_space) override;
 
+  bool read_memory_ranges (gdb::array_view<memory_read_range> ranges)
+    override;
+
   int insert_breakpoint (struct gdbarch *,
 			 struct bp_target_info *) override;
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
@@ -1541,6 +1544,22 @@ record_btrace_target::xfer_partial (enum target_object object,
 					 offset, len, xfered_len, addr_space);
 }
 
+/* The read_memory_ranges method of target record-btrace.  */
+
+bool
+record_btrace_target::read_memory_ranges
+  (gdb::array_view<memory_read_range> ranges)
+{
+  /* Leave it to xfer_partial to filter out the memory that can't be
+     read during replay.  */
+  if (replay_memory_access == replay_memory_access_read_only
+      && !record_btrace_generating_corefile
+      && record_is_replaying (inferior_ptid))
+    return false;
+
+  return this->beneath ()->read_memory_ranges (ranges);
+}
+
 /* The insert_breakpoint method of target record-btrace.  */
 
 int
@@ -79,7 +79,10 @@
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
 #include "xml-tdesc.h"
+#include "user-regs.h"
+#include "gdbsupport/buildargv.h"
 #include <map>
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -102,6 +105,7 @@ struct threads_listing_context;
 typedef int (*rmt_thread_action) (threadref *ref, void *context);
 struct protocol_feature;
 struct packet_reg;
+struct remote_thread_info;
 
 struct stop_reply;
 typedef std::unique_ptr<stop_reply> stop_reply_up;
@@ -233,6 +237,7 @@ enum {
   PACKET_vCont = 0,
   PACKET_X,
   PACKET_x,
+  PACKET_vReadMemRanges,
   PACKET_R,
   PACKET_qSymbol,
   PACKET_P,
@@ -279,6 +284,9 @@ enum {
   PACKET_vAttach,
   PACKET_vRun,
   PACKET_QStartNoAckMode,
+  PACKET_QCompressReplies,
+  PACKET_QExpeditedRegisters,
+  PACKET_qDeltaRegisters,
   PACKET_vKill,
   PACKET_qXfer_siginfo_read,
   PACKET_qXfer_siginfo_write,
@@ -528,6 +536,19 @@ typedef bool (*rmt_err_msg_handler) (const error_message &message);
 
 static bool default_err_msg_handler (const error_message& message);
 
+/* Statistics about the compressed replies to one kind of packet.  */
+
+struct compressed_reply_stats
+{
+  /* The number of compressed replies.  */
+  unsigned int count = 0;
+
+  /* The number of bytes of these replies, as received and once
+     decompressed.  */
+  ULONGEST compressed_bytes = 0;
+  ULONGEST uncompressed_bytes = 0;
+};
+
 /* Description of the remote protocol state for the currently
    connected target.  This is per-target state, and independent of the
    selected architecture.  */
@@ -623,6 +644,25 @@ class remote_state
      reliable.  */
   bool noack_mode = false;
 
+  /* True if the stub was asked to compress its large replies, with
+     the QCompressReplies packet.  */
+  bool compress_replies = false;
+
+  /* If COMPRESS_REPLIES, the kind of the last packet sent, as returned
+     by remote_packet_kind, and the statistics about the compressed
+     replies, by kind of packet.  */
+  std::string last_packet_kind;
+  std::map<std::string, compressed_reply_stats> compressed_replies;
+
+  /* The register numbers sent in the last QExpeditedRegisters packet,
+     i.e. the registers that the stub expedites in its stop replies in
+     addition to its default ones, and the value of "set remote
+     expedited-registers" and the architecture they were computed
+     from.  */
+  std::string expedited_registers;
+  std::string expedited_registers_setting;
+  struct gdbarch *expedited_registers_arch = nullptr;
+
   /* True if we're connected in extended remote mode.  */
   bool extended = false;
 
@@ -918,6 +958,8 @@ class remote_target : public process_stratum_target
 
   void commit_requested_thread_options ();
 
+  void commit_expedited_registers ();
+
   void commit_resumed () override;
   void resume (ptid_t, int, enum gdb_signal) override;
   ptid_t wait (ptid_t, struct target_waitstatus *, target_wait_flags) override;
@@ -1013,6 +1055,9 @@ class remote_target : public process_stratum_target
 
   ULONGEST get_memory_xfer_limit () override;
 
+  bool read_memory_ranges (gdb::array_view<memory_read_range> ranges)
+    override;
+
   void rcmd (const char *command, struct ui_file *output) override;
 
   const char *pid_to_exec_file (int pid) override;
@@ -1230,10 +1275,16 @@ class remote_target : public process_stratum_target
 			    ULONGEST offset, fileio_error *remote_errno);
   int remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 				 ULONGEST offset, fileio_error *remote_errno);
+  int hostio_pread_chunk_len ();
+  int remote_hostio_pread_window (int fd, gdb_byte *read_buf, int len,
+				  ULONGEST offset, fileio_error *remote_errno);
 
   int remote_hostio_send_command (int command_bytes, int which_packet,
 				  fileio_error *remote_errno, const char **attachment,
 				  int *attachment_len);
+  int remote_hostio_parse_reply (int bytes_read, int which_packet,
+				 fileio_error *remote_errno,
+				 const char **attachment, int *attachment_len);
   int remote_hostio_set_filesystem (struct inferior *inf,
 				    fileio_error *remote_errno);
   /* We should get rid of this and use fileio_open directly.  */
@@ -1380,6 +1431,8 @@ class remote_target : public process_stratum_target
   int send_g_packet ();
   void process_g_packet (struct regcache *regcache);
   void fetch_registers_using_g (struct regcache *regcache);
+  bool fetch_registers_using_delta (regcache *regcache,
+				    remote_thread_info *priv);
 
   void fetch_registers_using_e (regcache *regcache);
 
@@ -1406,6 +1459,10 @@ class remote_target : public process_stratum_target
 					 int unit_size, ULONGEST *xfered_len,
 					 unsigned int addr_space);
 
+  int read_window (ULONGEST len, ULONGEST chunk_len);
+
+  int decompress_reply (gdb::char_vector *buf, int len);
+
   target_xfer_status remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
 					  ULONGEST len_units,
 					  int unit_size,
@@ -1723,6 +1780,14 @@ struct remote_thread_info : public private_thread_info
      in the last stop reply or threads list.  */
   struct gdbarch *arch = nullptr;
 
+  /* The registers of this thread as last sent by the stub in reply to
+     a 'g' or qDeltaRegisters packet, in the 'g' packet format, and the
+     architecture of the regcache they were fetched for.  Empty if the
+     next qDeltaRegisters reply can't be applied to them, e.g. because
+     it failed.  */
+  std::string registers_baseline;
+  struct gdbarch *registers_baseline_arch = nullptr;
+
   /* Get the thread's resume state.  */
   enum resume_state get_resume_state () const
   {
@@ -2480,6 +2545,73 @@ show_remote_packet_max_chars (struct ui_file *file, int from_tty,
 		      "display is %s.\n"), value);
 }
 
+/* The size from which the stub is asked to compress its replies, with
+   the QCompressReplies packet.  Zero means never.  */
+
+static unsigned int remote_compression_threshold = 0;
+
+/* Implement "show remote compression-threshold".  */
+
+static void
+show_remote_compression_threshold (struct ui_file *file, int from_tty,
+				   struct cmd_list_element *c,
+				   const char *value)
+{
+  if (remote_compression_threshold == 0)
+    gdb_printf (file, _("Remote replies are not compressed.\n"));
+  else
+    gdb_printf (file, _("Remote replies of %s bytes or more are "
+			"compressed.\n"), value);
+}
+
+/* The names of the registers that the stub is asked to expedite in
+   its stop replies, in addition to the ones it chooses, separated by
+   spaces.  */
+
+static std::string remote_expedited_registers;
+
+/* Implement "show remote expedited-registers".  */
+
+static void
+show_remote_expedited_registers (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  if (remote_expedited_registers.empty ())
+    gdb_printf (file, _("The remote stub expedites its default registers "
+			"in stop replies.\n"));
+  else
+    gdb_printf (file, _("The remote stub is asked to expedite these "
+			"registers in stop replies too: %s.\n"), value);
+}
+
+/* Return the kind of the CNT-byte packet BUF, to collect statistics
+   about the replies to each kind of packet.  This is the name of
+   general query and 'v' packets, including the object of qXfer and
+   the operation of vFile packets, and the first character of other
+   packets.  */
+
+static std::string
+remote_packet_kind (const char *buf, int cnt)
+{
+  if (cnt == 0)
+    return "";
+
+  if (buf[0] != 'q' && buf[0] != 'Q' && buf[0] != 'v')
+    return std::string (buf, 1);
+
+  const char *end = buf + cnt;
+  const char *p = std::find_if (buf, end, [] (char c)
+    {
+      return c == ':' || c == ',' || c == ';';
+    });
+
+  std::string kind (buf, p);
+  if ((kind == "qXfer" || kind == "vFile") && p != end && *p == ':')
+    kind.append (p, std::find (p + 1, end, ':'));
+  return kind;
+}
+
 long
 remote_target::get_memory_write_packet_size ()
 {
@@ -5467,6 +5599,22 @@ remote_target::start_remote_1 (int from_tty, int extended_p)
 	rs->noack_mode = 1;
     }
 
+  /* Next, if the user set a compression threshold, ask the stub to
+     compress the replies that are larger than that.  */
+
+  if (remote_compression_threshold != 0
+      && (m_features.packet_support (PACKET_QCompressReplies)
+	  != PACKET_DISABLE))
+    {
+      xsnprintf (rs->buf.data (), get_remote_packet_size (),
+		 "QCompressReplies:zlib,%x", remote_compression_threshold);
+      putpkt (rs->buf);
+      getpkt (&rs->buf);
+      if ((m_features.packet_ok (rs->buf, PACKET_QCompressReplies)).status ()
+	  == PACKET_OK)
+	rs->compress_replies = true;
+    }
+
   if (extended_p)
     {
       /* Tell the remote that we are using the extended protocol.  */
@@ -6069,6 +6217,12 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_QEnvironmentUnset },
   { "QStartNoAckMode", PACKET_DISABLE, remote_supported_packet,
     PACKET_QStartNoAckMode },
+  { "QCompressReplies", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QCompressReplies },
+  { "QExpeditedRegisters", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QExpeditedRegisters },
+  { "qDeltaRegisters", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qDeltaRegisters },
   { "multiprocess", PACKET_DISABLE, remote_supported_packet,
     PACKET_multiprocess_feature },
   { "multi-address-space", PACKET_DISABLE, remote_supported_packet,
@@ -6151,6 +6305,8 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vAck:in-memory-library", PACKET_DISABLE, remote_supported_packet,
     PACKET_vAck_in_memory_library },
   { "x", PACKET_DISABLE, remote_supported_packet, PACKET_x },
+  { "vReadMemRanges", PACKET_DISABLE, remote_supported_packet,
+    PACKET_vReadMemRanges },
   { "Z0", PACKET_SUPPORT_UNKNOWN, remote_supported_packet, PACKET_Z0 },
   { "Z1", PACKET_SUPPORT_UNKNOWN, remote_supported_packet, PACKET_Z1 },
   { "Z2", PACKET_SUPPORT_UNKNOWN, remote_supported_packet, PACKET_Z2 },
@@ -6283,6 +6439,10 @@ remote_target::remote_query_supported ()
 	  != AUTO_BOOLEAN_FALSE)
 	remote_query_supported_append (&q, "unavailable+");
 
+      if (m_features.packet_set_cmd_state (PACKET_qDeltaRegisters)
+	  != AUTO_BOOLEAN_FALSE)
+	remote_query_supported_append (&q, "qDeltaRegisters+");
+
       remote_query_supported_append
 	(&q, "qXfer:libraries:read:in-memory-library+");
 
@@ -6597,6 +6757,10 @@ remote_target::open_1 (const char *name, int from_tty, int extended_p)
   remote->m_features.reset_all_packet_configs_support ();
   rs->explicit_packet_size = 0;
   rs->noack_mode = 0;
+  rs->compress_replies = false;
+  rs->expedited_registers.clear ();
+  rs->expedited_registers_setting.clear ();
+  rs->expedited_registers_arch = nullptr;
   rs->extended = extended_p;
   rs->waiting_for_stop_reply = 0;
   rs->ctrlc_pending_p = 0;
@@ -7421,6 +7585,7 @@ remote_target::resume (ptid_t scope_ptid, int step, enum gdb_signal siggnal)
     }
 
   commit_requested_thread_options ();
+  commit_expedited_registers ();
 
   /* In all-stop, we can't mark REMOTE_ASYNC_GET_PENDING_EVENTS_TOKEN
      (explained in remote-notif.c:handle_notification) so
@@ -7592,6 +7757,7 @@ remote_target::commit_resumed ()
     return;
 
   commit_requested_thread_options ();
+  commit_expedited_registers ();
 
   /* Try to send wildcard actions ("vCont;c" or "vCont;c:pPID.-1")
      instead of resuming all threads of each process individually.
@@ -9531,8 +9697,108 @@ remote_target::process_g_packet (struct regcache *regcache)
 void
 remote_target::fetch_registers_using_g (struct regcache *regcache)
 {
+  thread_info *tp = find_thread (regcache->ptid ());
+  remote_thread_info *priv
+    = tp != nullptr ? get_remote_thread_info (tp) : nullptr;
+
+  /* The stub only remembers the registers of the live threads.  */
+  if (get_traceframe_number () != -1)
+    priv = nullptr;
+
+  if (priv != nullptr && fetch_registers_using_delta (regcache, priv))
+    return;
+
   send_g_packet ();
   process_g_packet (regcache);
+
+  /* Remember the registers, to apply the next qDeltaRegisters reply
+     to them.  */
+  if (priv != nullptr
+      && m_features.packet_support (PACKET_qDeltaRegisters) != PACKET_DISABLE)
+    {
+      priv->registers_baseline = get_remote_state ()->buf.data ();
+      priv->registers_baseline_arch = regcache->arch ();
+    }
+}
+
+/* Fetch the registers included in the 'g' packet with the
+   qDeltaRegisters packet, which returns the ones that changed since
+   the stub last sent the registers of the thread, recorded by PRIV.
+   Return false if this is not possible, in which case the 'g' packet
+   must be used.  */
+
+bool
+remote_target::fetch_registers_using_delta (regcache *regcache,
+					    remote_thread_info *priv)
+{
+  struct remote_state *rs = get_remote_state ();
+  gdbarch *gdbarch = regcache->arch ();
+  remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
+
+  /* Whatever happens below, the registers recorded by the stub won't
+     be the ones of PRIV anymore, unless the reply is applied to them
+     successfully.  */
+  std::string baseline = std::move (priv->registers_baseline);
+  priv->registers_baseline.clear ();
+
+  if (m_features.packet_support (PACKET_qDeltaRegisters) == PACKET_DISABLE
+      || baseline.empty ()
+      || priv->registers_baseline_arch != gdbarch)
+    return false;
+
+  putpkt ("qDeltaRegisters");
+  getpkt (&rs->buf);
+
+  packet_result result = m_features.packet_ok (rs->buf,
+					       PACKET_qDeltaRegisters);
+  if (result.status () != PACKET_OK)
+    return false;
+
+  /* The reply is "OK" if no register changed, or a list of
+     'n...:r...;' pairs otherwise, where n... is the register number
+     and r... its contents, as in the 'g' packet.  */
+  if (strcmp (rs->buf.data (), "OK") != 0)
+    {
+      const char *p = rs->buf.data ();
+
+      while (*p != '\0')
+	{
+	  ULONGEST pnum;
+	  const char *p_col = unpack_varlen_hex (p, &pnum);
+
+	  if (p_col == p || *p_col != ':')
+	    error (_("Remote 'qDeltaRegisters' reply is badly formatted: %s"),
+		   rs->buf.data ());
+
+	  packet_reg *reg = packet_reg_from_pnum (gdbarch, rsa, pnum);
+	  if (reg == nullptr || !reg->in_g_packet)
+	    error (_("Remote sent bad register number %s in "
+		     "'qDeltaRegisters' reply"), hex_string (pnum));
+
+	  size_t offset = 2 * reg->offset;
+	  size_t len = 2 * register_size (gdbarch, reg->regnum);
+
+	  p = p_col + 1;
+	  if (offset + len > baseline.size ()
+	      || strnlen (p, len) < len || p[len] != ';')
+	    error (_("Remote sent a bad value for register %s in "
+		     "'qDeltaRegisters' reply"), hex_string (pnum));
+
+	  baseline.replace (offset, len, p, len);
+	  p += len + 1;
+	}
+    }
+
+  /* Supply the updated registers as if they were a 'g' packet
+     reply.  */
+  if (rs->buf.size () <= baseline.size ())
+    rs->buf.resize (baseline.size () + 1);
+  memcpy (rs->buf.data (), baseline.c_str (), baseline.size () + 1);
+  process_g_packet (regcache);
+
+  priv->registers_baseline = std::move (baseline);
+  priv->registers_baseline_arch = gdbarch;
+  return true;
 }
 
 /* Fetch the expedited registers.  */
@@ -10242,6 +10508,65 @@ remote_target::remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr,
 				 packet_format[0], 1, addr_space);
 }
 
+/* The number of memory and file read requests that may be sent before
+   their replies are received, on connections without acknowledgments.
+   See remote_read_bytes_1 and remote_hostio_pread.  A value of 0 or 1
+   disables this.  */
+
+static unsigned int remote_read_window = 1;
+
+/* The largest allowed value of REMOTE_READ_WINDOW.  The requests must
+   all fit in the stub's input buffers while it is blocked sending
+   replies that GDB doesn't read yet.  */
+
+#define MAX_REMOTE_READ_WINDOW 256
+
+/* Implement "set remote read-window".  */
+
+static void
+set_remote_read_window (const char *args, int from_tty,
+			struct cmd_list_element *c)
+{
+  if (remote_read_window > MAX_REMOTE_READ_WINDOW)
+    {
+      remote_read_window = MAX_REMOTE_READ_WINDOW;
+      error (_("Read window can't be larger than %d."),
+	     MAX_REMOTE_READ_WINDOW);
+    }
+}
+
+/* Implement "show remote read-window".  */
+
+static void
+show_remote_read_window (struct ui_file *file, int from_tty,
+			 struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("The number of remote read requests that may be "
+		      "in flight is %s.\n"), value);
+}
+
+/* Return how many read requests to send at once on the current
+   connection to read LEN bytes, if each request reads CHUNK_LEN
+   bytes.  */
+
+int
+remote_target::read_window (ULONGEST len, ULONGEST chunk_len)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  /* Without no-ack mode, each packet must be acknowledged before the
+     next one is sent.  Traceframes may only hold part of the memory
+     that is asked for, in which case later requests are useless.  */
+  if (remote_read_window <= 1
+      || !rs->noack_mode
+      || get_traceframe_number () != -1
+      || chunk_len == 0)
+    return 1;
+
+  ULONGEST n_chunks = (len + chunk_len - 1) / chunk_len;
+  return std::min (n_chunks, (ULONGEST) remote_read_window);
+}
+
 /* Read memory data directly from the remote machine.
    This does not use the data cache; the data cache uses this.
    MEMADDR is the address in the remote memory space.
@@ -10256,6 +10581,11 @@ remote_target::remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr,
    'enum target_xfer_status' value).  Save the number of bytes
    transferred in *XFERED_LEN_UNITS.
 
+   If more memory is requested than fits in a packet, and "set remote
+   read-window" allows it, the requests for several consecutive chunks
+   of memory are sent before the first reply is received, so that the
+   round trips overlap.
+
    See the comment of remote_write_bytes_aux for an example of
    memory read/write exchange between gdb and the stub.  */
 
@@ -10269,7 +10599,6 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   int buf_size_bytes;		/* Max size of packet output buffer.  */
   char *p;
   int todo_units;
-  int decoded_bytes;
 
   buf_size_bytes = get_memory_read_packet_size ();
   /* The packet buffer will be large enough for the payload;
@@ -10300,61 +10629,100 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
       break;
     }
 
-  /* Construct "m/x"<memaddr>","<len>".  */
-  memaddr = remote_address_masked (memaddr);
-  p = rs->buf.data ();
-  *p++ = packet_format;
-  p += hexnumstr (p, (ULONGEST) memaddr);
+  if (addr_space != 0 && !m_features.remote_multi_address_space_p ())
+    {
+      /* If the remote doesn't support access requests to different memory
+	 spaces we need to error out.  We can't just read from the default
+	 space, as the value would be wrong.  */
+      error (_("Remote server does not support reading from non-default \n"
+	       "address spaces."));
+    }
 
-  if (addr_space != 0)
-  {
-    if (m_features.remote_multi_address_space_p ())
-      {
-	*p++ = '@';
-	p += hexnumstr (p, (ULONGEST) addr_space);
-      }
-    else
-      {
-	/* If the remote doesn't support access requests to different memory
-	   spaces we need to error out.  We can't just read from the default
-	   space, as the value would be wrong.  */
-	error (_("Remote server does not support reading from non-default \n"
-		 "address spaces."));
-      }
-  }
+  int n_requests = read_window (len_units, todo_units);
 
-  *p++ = ',';
-  p += hexnumstr (p, (ULONGEST) todo_units);
-  *p = '\0';
-  putpkt (rs->buf);
-  int packet_len = getpkt (&rs->buf);
-  if (packet_len < 0)
-    return TARGET_XFER_E_IO;
+  for (int i = 0; i < n_requests; i++)
+    {
+      ULONGEST chunk_units = std::min ((ULONGEST) todo_units,
+				       len_units - i * todo_units);
 
-  packet_result result = packet_check_result (rs->buf, false);
-  if (result.status () == PACKET_ERROR)
-    return TARGET_XFER_E_IO;
+      /* Construct "m/x"<memaddr>","<len>".  */
+      p = rs->buf.data ();
+      *p++ = packet_format;
+      p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr
+							  + i * todo_units));
 
-  p = rs->buf.data ();
-  if (packet_format == 'x')
-    {
-      if (*p != 'b')
-	return TARGET_XFER_E_IO;
+      if (addr_space != 0)
+	{
+	  *p++ = '@';
+	  p += hexnumstr (p, (ULONGEST) addr_space);
+	}
 
-      p++;
-      decoded_bytes = remote_unescape_input ((const gdb_byte *) p,
-					     packet_len - 1, myaddr,
-					     todo_units * unit_size);
+      *p++ = ',';
+      p += hexnumstr (p, chunk_units);
+      *p = '\0';
+      putpkt (rs->buf);
     }
-  else
+
+  /* Receive all the replies, even after a failed or partial read, so
+     that the next packet sent gets its own reply.  Only keep the
+     memory contents up to the first failed or partial read.  */
+  ULONGEST xfered_units = 0;
+  bool done = false;
+  bool failed = false;
+  for (int i = 0; i < n_requests; i++)
     {
-      /* Reply describes memory byte by byte, each byte encoded as two hex
-	 characters.  */
-      decoded_bytes = hex2bin (p, myaddr, todo_units * unit_size);
+      ULONGEST chunk_units = std::min ((ULONGEST) todo_units,
+				       len_units - i * todo_units);
+
+      int packet_len = getpkt (&rs->buf);
+      if (packet_len < 0)
+	return TARGET_XFER_E_IO;
+
+      if (done)
+	continue;
+
+      packet_result result = packet_check_result (rs->buf, false);
+      if (result.status () == PACKET_ERROR)
+	{
+	  failed = xfered_units == 0;
+	  done = true;
+	  continue;
+	}
+
+      p = rs->buf.data ();
+      gdb_byte *chunk_addr = myaddr + xfered_units * unit_size;
+      int decoded_bytes;
+      if (packet_format == 'x')
+	{
+	  if (*p != 'b')
+	    {
+	      failed = xfered_units == 0;
+	      done = true;
+	      continue;
+	    }
+
+	  p++;
+	  decoded_bytes = remote_unescape_input ((const gdb_byte *) p,
+						 packet_len - 1, chunk_addr,
+						 chunk_units * unit_size);
+	}
+      else
+	{
+	  /* Reply describes memory byte by byte, each byte encoded as
+	     two hex characters.  */
+	  decoded_bytes = hex2bin (p, chunk_addr, chunk_units * unit_size);
+	}
+
+      xfered_units += decoded_bytes / unit_size;
+      if (decoded_bytes / unit_size < chunk_units)
+	done = true;
     }
 
+  if (failed)
+    return TARGET_XFER_E_IO;
+
   /* Return what we have.  Let higher layers handle partial reads.  */
-  *xfered_len_units = (ULONGEST) (decoded_bytes / unit_size);
+  *xfered_len_units = xfered_units;
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
@@ -10730,6 +11098,9 @@ remote_target::putpkt_binary (const char *buf, int cnt)
 	       "and then try again."));
     }
 
+  if (rs->compress_replies)
+    rs->last_packet_kind = remote_packet_kind (buf, cnt);
+
   /* Copy the packet into buffer BUF2, encapsulating it
      and giving it a checksum.  */
 
@@ -11159,6 +11530,9 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
 	  /* Skip the ack char if we're in no-ack mode.  */
 	  if (!rs->noack_mode)
 	    remote_serial_write ("+", 1);
+	  if (rs->compress_replies && val >= 2
+	      && (*buf)[0] == '}' && (*buf)[1] == 'Z')
+	    val = decompress_reply (buf, val);
 	  if (is_notif != NULL)
 	    *is_notif = false;
 	  return val;
@@ -11187,6 +11561,96 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
     }
 }
 
+/* Decompress the LEN-byte reply in BUF, sent by the stub following a
+   QCompressReplies packet, replacing it by the original reply.  Return
+   the length of the original reply.  The compressed reply has the form
+   "}Z<length>:<data>", where LENGTH is the length of the original reply
+   in hex, and DATA is that reply compressed with zlib, then escaped
+   like other binary data.  */
+
+int
+remote_target::decompress_reply (gdb::char_vector *buf, int len)
+{
+  struct remote_state *rs = get_remote_state ();
+  const char *end = buf->data () + len;
+  ULONGEST orig_len;
+
+  const char *p = unpack_varlen_hex (buf->data () + 2, &orig_len);
+  if (p >= end || *p != ':' || orig_len > INT_MAX)
+    error (_("Invalid compressed reply from remote target."));
+  p++;
+
+  gdb::byte_vector data (end - p);
+  int data_len = remote_unescape_input ((const gdb_byte *) p, end - p,
+					data.data (), data.size ());
+
+  if (buf->size () <= orig_len)
+    buf->resize (orig_len + 1);
+
+  uLongf out_len = orig_len;
+  if (uncompress ((Bytef *) buf->data (), &out_len, data.data (),
+		  data_len) != Z_OK
+      || out_len != orig_len)
+    error (_("Invalid compressed reply from remote target."));
+  (*buf)[orig_len] = '\0';
+
+  remote_debug_printf_nofunc ("Reply decompressed from %d to %s bytes",
+			      len, pulongest (orig_len));
+
+  compressed_reply_stats &stats
+    = rs->compressed_replies[rs->last_packet_kind];
+  stats.count++;
+  stats.compressed_bytes += len;
+  stats.uncompressed_bytes += orig_len;
+
+  return orig_len;
+}
+
+/* Implement "maint info remote-compression".  */
+
+static void
+maint_info_remote_compression (const char *args, int from_tty)
+{
+  remote_target *remote = get_current_remote_target ();
+  if (remote == nullptr)
+    error (_("No remote target is selected."));
+
+  remote_state *rs = remote->get_remote_state ();
+  if (!rs->compress_replies)
+    {
+      gdb_printf (_("The remote target does not compress its replies.\n"));
+      return;
+    }
+
+  if (rs->compressed_replies.empty ())
+    {
+      gdb_printf (_("No compressed reply was received.\n"));
+      return;
+    }
+
+  ui_out_emit_table table_emitter (current_uiout, 4,
+				   rs->compressed_replies.size (),
+				   "compressed-replies");
+  current_uiout->table_header (10, ui_left, "packet", "Packet");
+  current_uiout->table_header (7, ui_right, "count", "Replies");
+  current_uiout->table_header (14, ui_right, "received", "Bytes received");
+  current_uiout->table_header (12, ui_right, "uncompressed",
+			       "Uncompressed");
+  current_uiout->table_body ();
+
+  for (const auto &[kind, stats] : rs->compressed_replies)
+    {
+      ui_out_emit_tuple tuple_emitter (current_uiout, nullptr);
+      current_uiout->field_string ("packet", kind);
+      current_uiout->field_unsigned ("count", stats.count);
+      current_uiout->field_string ("received",
+				   pulongest (stats.compressed_bytes));
+      current_uiout->field_string ("uncompressed",
+				   pulongest (stats.uncompressed_bytes));
+      current_uiout->text ("\n");
+    }
+}
+
 /* Kill any new fork children of inferior INF that haven't been
    processed by follow_fork.  */
 
@@ -12595,6 +13059,128 @@ remote_target::get_memory_xfer_limit ()
   return get_memory_write_packet_size ();
 }
 
+/* Implementation of to_read_memory_ranges.  Send as many ranges per
+   "vReadMemRanges" packet as their contents fit in its reply.  */
+
+bool
+remote_target::read_memory_ranges (gdb::array_view<memory_read_range> ranges)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  /* The largest number of characters describing a range in a request,
+     and the largest number of characters preceding the contents of a
+     range in a reply.  */
+  const int max_range_request = 2 * (sizeof (ULONGEST) * 2) + 2;
+  const int max_range_header = sizeof (ULONGEST) * 2 + 1;
+
+  if (m_features.packet_support (PACKET_vReadMemRanges) == PACKET_DISABLE)
+    return false;
+
+  set_remote_traceframe ();
+
+  /* Traceframes only hold some parts of memory, see
+     remote_read_bytes.  */
+  if (get_traceframe_number () != -1
+      || !target_has_execution ()
+      || (gdbarch_addressable_memory_unit_size (current_inferior ()->arch ())
+	  != 1))
+    return false;
+
+  set_general_thread (inferior_ptid);
+
+  long buf_size = get_memory_read_packet_size ();
+  size_t next = 0;
+  bool sent = false;
+  while (next < ranges.size ())
+    {
+      /* Construct "vReadMemRanges:"<addr>","<len>[";"<addr>","<len>]...
+	 The size of the reply, with all its contents escaped, must not
+	 exceed BUF_SIZE.  */
+      char *p = rs->buf.data ();
+      strcpy (p, "vReadMemRanges:");
+      p += strlen (p);
+
+      size_t first = next;
+      long reply_size = 1;
+      for (; next < ranges.size (); next++)
+	{
+	  const memory_read_range &range = ranges[next];
+	  long room = buf_size - reply_size - max_range_header;
+	  ULONGEST todo = range.len;
+
+	  if (room < 2
+	      || (p - rs->buf.data ()) + max_range_request
+		  >= get_remote_packet_size ())
+	    break;
+
+	  if (todo > (ULONGEST) room / 2)
+	    {
+	      /* Only read part of a range that doesn't fit on its own;
+		 leave other ranges for the next packet.  */
+	      if (next > first)
+		break;
+	      todo = room / 2;
+	    }
+
+	  if (next > first)
+	    *p++ = ';';
+	  p += hexnumstr (p, (ULONGEST) remote_address_masked (range.addr));
+	  *p++ = ',';
+	  p += hexnumstr (p, todo);
+	  reply_size += max_range_header + 2 * todo;
+	}
+      *p = '\0';
+
+      if (next == first)
+	break;
+
+      putpkt (rs->buf);
+      int packet_len = getpkt (&rs->buf);
+      if (packet_len < 0)
+	return sent;
+
+      packet_result result = m_features.packet_ok (rs->buf,
+						   PACKET_vReadMemRanges);
+      if (result.status () != PACKET_OK)
+	return sent;
+      sent = true;
+
+      /* The reply is "b" followed by the number of bytes read from
+	 each range, a colon, and those bytes.  */
+      if (rs->buf[0] != 'b')
+	error (_("Malformed vReadMemRanges reply: %s"), rs->buf.data ());
+
+      gdb::byte_vector data (packet_len - 1);
+      int data_len
+	= remote_unescape_input ((const gdb_byte *) rs->buf.data () + 1,
+				 packet_len - 1, data.data (), data.size ());
+      const gdb_byte *q = data.data ();
+      const gdb_byte *q_end = q + data_len;
+      for (size_t i = first; i < next && q < q_end; i++)
+	{
+	  memory_read_range &range = ranges[i];
+	  const gdb_byte *colon
+	    = (const gdb_byte *) memchr (q, ':', q_end - q);
+	  if (colon == nullptr)
+	    error (_("Malformed vReadMemRanges reply"));
+
+	  ULONGEST n = 0;
+	  for (; q < colon; q++)
+	    n = (n << 4) | fromhex (*q);
+	  q = colon + 1;
+
+	  if (n > range.len || n > q_end - q)
+	    error (_("Malformed vReadMemRanges reply"));
+
+	  memcpy (range.buf, q, n);
+	  range.xfered_len = n;
+	  q += n;
+	}
+    }
+
+  return true;
+}
+
 int
 remote_target::search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
 			      const gdb_byte *pattern, ULONGEST pattern_len,
@@ -13230,6 +13816,12 @@ remote_target::read_description ()
 
   if (!data->guesses.empty ())
     {
+      /* The stub remembers the registers it sends for the next
+	 qDeltaRegisters packet, but we don't know which thread they
+	 are of.  */
+      for (thread_info *tp : all_non_exited_threads (this))
+	get_remote_thread_info (tp)->registers_baseline.clear ();
+
       int bytes = send_g_packet ();
 
       for (const remote_g_packet_guess &guess : data->guesses)
@@ -13383,8 +13975,7 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
 					   int *attachment_len)
 {
   struct remote_state *rs = get_remote_state ();
-  int ret, bytes_read;
-  const char *attachment_tmp;
+  int bytes_read;
 
   if (m_features.packet_support (which_packet) == PACKET_DISABLE)
     {
@@ -13395,6 +13986,24 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
   putpkt_binary (rs->buf.data (), command_bytes);
   bytes_read = getpkt (&rs->buf);
 
+  return remote_hostio_parse_reply (bytes_read, which_packet, remote_errno,
+				    attachment, attachment_len);
+}
+
+/* Parse the reply to an I/O packet, of length BYTES_READ, in the
+   global RS->BUF.  The arguments and return value are those of
+   remote_hostio_send_command.  */
+
+int
+remote_target::remote_hostio_parse_reply (int bytes_read, int which_packet,
+					  fileio_error *remote_errno,
+					  const char **attachment,
+					  int *attachment_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  int ret;
+  const char *attachment_tmp;
+
   /* If it timed out, something is wrong.  Don't try to parse the
      buffer.  */
   if (bytes_read < 0)
@@ -13625,6 +14234,119 @@ remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
   return ret;
 }
 
+/* Return how many bytes of a file to ask for in each "vFile:pread"
+   request sent by remote_hostio_pread_window.  This is small enough
+   for the reply to hold them even if each one must be escaped, so
+   that the stub doesn't return fewer bytes before the end of the
+   file.  */
+
+int
+remote_target::hostio_pread_chunk_len ()
+{
+  /* Leave room for the "F" return code and the ";" separator.  */
+  return (get_remote_packet_size () - 32) / 2;
+}
+
+/* Read LEN bytes at OFFSET of the remote file FD into READ_BUF.  If
+   more than one request is needed and "set remote read-window" allows
+   it, send several "vFile:pread" requests for consecutive chunks of the
+   file before receiving the first reply, so that the round trips
+   overlap.  Otherwise, send a single request.  Return the number of
+   bytes read, or -1 with *REMOTE_ERRNO set if none could be read.  */
+
+int
+remote_target::remote_hostio_pread_window (int fd, gdb_byte *read_buf,
+					   int len, ULONGEST offset,
+					   fileio_error *remote_errno)
+{
+  struct remote_state *rs = get_remote_state ();
+  int chunk_len = hostio_pread_chunk_len ();
+  int n_requests = read_window (len, chunk_len);
+
+  if (n_requests <= 1
+      || m_features.packet_support (PACKET_vFile_pread) != PACKET_ENABLE)
+    return remote_hostio_pread_vFile (fd, read_buf, len, offset,
+				      remote_errno);
+
+  for (int i = 0; i < n_requests; i++)
+    {
+      char *p = rs->buf.data ();
+      int left = get_remote_packet_size ();
+
+      remote_buffer_add_string (&p, &left, "vFile:pread:");
+
+      remote_buffer_add_int (&p, &left, fd);
+      remote_buffer_add_string (&p, &left, ",");
+
+      remote_buffer_add_int (&p, &left, std::min (chunk_len,
+						  len - i * chunk_len));
+      remote_buffer_add_string (&p, &left, ",");
+
+      remote_buffer_add_int (&p, &left, offset + i * chunk_len);
+
+      putpkt_binary (rs->buf.data (), p - rs->buf.data ());
+    }
+
+  /* Receive all the replies, even after a failed or short read, so
+     that the next packet sent gets its own reply.  Only keep the
+     contents up to the first failed or short read.  */
+  int total = 0;
+  bool done = false;
+  bool failed = false;
+  bool bad_reply = false;
+  for (int i = 0; i < n_requests; i++)
+    {
+      int chunk = std::min (chunk_len, len - i * chunk_len);
+      fileio_error chunk_errno;
+      const char *attachment;
+      int attachment_len;
+
+      int bytes_read = getpkt (&rs->buf);
+      if (bytes_read < 0)
+	{
+	  *remote_errno = FILEIO_EINVAL;
+	  return -1;
+	}
+
+      if (done)
+	continue;
+
+      int ret = remote_hostio_parse_reply (bytes_read, PACKET_vFile_pread,
+					   &chunk_errno, &attachment,
+					   &attachment_len);
+      if (ret < 0)
+	{
+	  if (total == 0)
+	    {
+	      *remote_errno = chunk_errno;
+	      failed = true;
+	    }
+	  done = true;
+	  continue;
+	}
+
+      int read_len = remote_unescape_input ((gdb_byte *) attachment,
+					    attachment_len,
+					    read_buf + total, chunk);
+      if (read_len != ret)
+	{
+	  bad_reply = true;
+	  done = true;
+	  continue;
+	}
+
+      total += ret;
+      if (ret < chunk)
+	done = true;
+    }
+
+  if (bad_reply)
+    error (_("Read returned a different number of bytes than "
+	     "it contains."));
+
+  return failed ? -1 : total;
+}
+
 /* See declaration.h.  */
 
 int
@@ -13674,11 +14396,16 @@ remote_target::remote_hostio_pread (int fd, gdb_byte *read_buf, int len,
 
   cache->fd = fd;
   cache->offset = offset;
-  cache->buf.resize (get_remote_packet_size ());
 
-  ret = remote_hostio_pread_vFile (cache->fd, &cache->buf[0],
-				   cache->buf.size (),
-				   cache->offset, remote_errno);
+  /* Read ahead as much as is asked for, as far as the requests that
+     remote_hostio_pread_window may send at once go.  */
+  long readahead = std::min ((long) len, ((long) remote_read_window
+					  * hostio_pread_chunk_len ()));
+  cache->buf.resize (std::max (get_remote_packet_size (), readahead));
+
+  ret = remote_hostio_pread_window (cache->fd, &cache->buf[0],
+				    cache->buf.size (),
+				    cache->offset, remote_errno);
   if (ret <= 0)
     {
       cache->invalidate_fd (fd);
@@ -16185,6 +16912,97 @@ remote_target::commit_requested_thread_options ()
   flush ();
 }
 
+/* Return the number of the raw register of GDBARCH named NAME, or -1
+   if there is none.  The user registers "pc", "sp", "ps" and "fp"
+   stand for the raw registers the architecture uses for them, if
+   any.  */
+
+static int
+expedited_register_regnum (struct gdbarch *gdbarch, const char *name)
+{
+  int regnum = user_reg_map_name_to_regnum (gdbarch, name, -1);
+  if (regnum >= 0 && regnum < gdbarch_num_regs (gdbarch))
+    return regnum;
+
+  if (strcmp (name, "pc") == 0)
+    regnum = gdbarch_pc_regnum (gdbarch);
+  else if (strcmp (name, "sp") == 0)
+    regnum = gdbarch_sp_regnum (gdbarch);
+  else if (strcmp (name, "ps") == 0)
+    regnum = gdbarch_ps_regnum (gdbarch);
+  else if (strcmp (name, "fp") == 0)
+    regnum = gdbarch_deprecated_fp_regnum (gdbarch);
+  else
+    return -1;
+
+  if (regnum >= 0 && regnum < gdbarch_num_regs (gdbarch))
+    return regnum;
+  return -1;
+}
+
+/* Like commit_requested_thread_options, tell the stub which registers
+   to expedite in its stop replies, with the QExpeditedRegisters
+   packet, if "set remote expedited-registers" or the architecture
+   changed since the last time.  */
+
+void
+remote_target::commit_expedited_registers ()
+{
+  struct remote_state *rs = get_remote_state ();
+  struct gdbarch *gdbarch = current_inferior ()->arch ();
+
+  if (m_features.packet_support (PACKET_QExpeditedRegisters) == PACKET_DISABLE
+      || (rs->expedited_registers_arch == gdbarch
+	  && rs->expedited_registers_setting == remote_expedited_registers))
+    return;
+
+  rs->expedited_registers_arch = gdbarch;
+  rs->expedited_registers_setting = remote_expedited_registers;
+
+  remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
+  std::string regs;
+
+  gdb_argv names (remote_expedited_registers.c_str ());
+  for (const char *name : names.as_array_view ())
+    {
+      if (*name == '$')
+	name++;
+      if (*name == '\0')
+	continue;
+
+      int regnum = expedited_register_regnum (gdbarch, name);
+      packet_reg *reg = nullptr;
+
+      if (regnum >= 0)
+	reg = packet_reg_from_regnum (gdbarch, rsa, regnum);
+      if (reg == nullptr || reg->pnum == -1)
+	{
+	  warning (_("Register \"%s\" can't be expedited by the remote "
+		     "target."), name);
+	  continue;
+	}
+
+      if (!regs.empty ())
+	regs += ';';
+      regs += phex_nz (reg->pnum, 0);
+    }
+
+  if (regs == rs->expedited_registers)
+    return;
+
+  std::string packet = "QExpeditedRegisters:" + regs;
+  putpkt (packet.c_str ());
+  getpkt (&rs->buf);
+
+  packet_result result = m_features.packet_ok (rs->buf,
+					       PACKET_QExpeditedRegisters);
+  if (result.status () == PACKET_OK)
+    rs->expedited_registers = std::move (regs);
+  else if (result.status () == PACKET_ERROR)
+    warning (_("Remote failure reply to QExpeditedRegisters: %s"),
+	     result.err_msg ());
+}
+
 static void
 show_remote_cmd (const char *args, int from_tty)
 {
@@ -16948,6 +17766,50 @@ Specify \"unlimited\" for unlimited hardware breakpoints."),
 			    NULL, show_hardware_breakpoint_limit,
 			    &remote_set_cmdlist, &remote_show_cmdlist);
 
+  add_setshow_zuinteger_cmd ("read-window", no_class,
+			     &remote_read_window, _("\
+Set the number of remote read requests that may be in flight."), _("\
+Show the number of remote read requests that may be in flight."), _("\
+When reading more memory or file contents than fit in a packet, GDB\n\
+can send up to this many requests before receiving the first reply,\n\
+so that their round trips overlap.  This is only done on connections\n\
+that don't use acknowledgments, see \"set remote noack-packet\".\n\
+Zero or one, the default, disables this."),
+			     set_remote_read_window, show_remote_read_window,
+			     &remote_set_cmdlist, &remote_show_cmdlist);
+
+  add_setshow_zuinteger_cmd ("compression-threshold", no_class,
+			     &remote_compression_threshold, _("\
+Set the size from which remote replies are compressed."), _("\
+Show the size from which remote replies are compressed."), _("\
+If non-zero, GDB asks the remote stub, when connecting, to compress\n\
+the replies that are at least this many bytes long, if that makes\n\
+them shorter.  This can speed up slow connections, at the expense of\n\
+processing time on both sides.  Zero, the default, disables this."),
+			     nullptr, show_remote_compression_threshold,
+			     &remote_set_cmdlist, &remote_show_cmdlist);
+
+  add_cmd ("remote-compression", class_maintenance,
+	   maint_info_remote_compression, _("\
+Show statistics about the compressed replies of the remote target.\n\
+For each kind of packet whose replies were compressed, show the number\n\
+of compressed replies, and their total size as received and once\n\
+decompressed."),
+	   &maintenanceinfolist);
+
+  add_setshow_string_noescape_cmd ("expedited-registers", no_class,
+				   &remote_expedited_registers, _("\
+Set the registers that the remote stub expedites in stop replies."), _("\
+Show the registers that the remote stub expedites in stop replies."), _("\
+The argument is a list of raw register names, separated by spaces, that\n\
+the remote stub is asked to send along with each stop reply, in addition\n\
+to the ones it chooses, like the program counter and stack pointer.\n\
+This saves reading all the registers of a thread when only these are\n\
+needed at a stop, e.g. by displays or breakpoint conditions.\n\
+The stub is told before resuming the program."),
+				   nullptr, show_remote_expedited_registers,
+				   &remote_set_cmdlist, &remote_show_cmdlist);
+
   add_setshow_zuinteger_cmd ("remoteaddresssize", class_obscure,
 			     &remote_address_size, _("\
 Set the maximum size of the address (in bits) in a memory packet."), _("\
@@ -16962,6 +17824,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
 
   add_packet_config_cmd (PACKET_x, "x", "binary-upload", 0);
 
+  add_packet_config_cmd (PACKET_vReadMemRanges, "vReadMemRanges",
+			 "read-memory-ranges", 0);
+
   add_packet_config_cmd (PACKET_vCont, "vCont", "verbose-resume", 0);
 
   add_packet_config_cmd (PACKET_QPassSignals, "QPassSignals", "pass-signals",
@@ -17087,6 +17952,15 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
 
   add_packet_config_cmd (PACKET_QStartNoAckMode, "QStartNoAckMode", "noack", 0);
 
+  add_packet_config_cmd (PACKET_QCompressReplies, "QCompressReplies",
+			 "compress-replies", 0);
+
+  add_packet_config_cmd (PACKET_QExpeditedRegisters, "QExpeditedRegisters",
+			 "expedited-registers", 0);
+
+  add_packet_config_cmd (PACKET_qDeltaRegisters, "qDeltaRegisters",
+			 "delta-registers", 0);
+
   add_packet_config_cmd (PACKET_vKill, "vKill", "kill", 0);
 
   add_packet_config_cmd (PACKET_qAttached, "qAttached", "query-attached", 0);
@@ -0,0 +1,471 @@
+/* Frame unwinder using SFrame stack trace information, for GDB.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The .sframe section holds, for each function, a table of frame row
+   entries (FREs) giving the canonical frame address (CFA) as an
+   offset from the stack or frame pointer, and the offsets from the
+   CFA at which the return address and the frame pointer are saved.
+   This is all that is needed to unwind the PC, SP and FP, and looking
+   it up is much cheaper than interpreting DWARF CFI: no bytecode is
+   run, and the lookup is a binary search in a sorted table.
+
+   The other callee-saved registers are not described by SFrame, so
+   their values in the caller are unknown: they may have been saved
+   anywhere in the frame, and reused.  They are unwound as optimized
+   out, rather than as having the same value, which would show wrong
+   values for the caller's variables that live in them.  Since DWARF
+   CFI shows them, this unwinder is only used when asked for.  */
+
+#include "sframe-frame.h"
+#include "frame.h"
+#include "frame-unwind.h"
+#include "gdbarch.h"
+#include "gdbcore.h"
+#include "objfiles.h"
+#include "gdb_bfd.h"
+#include "value.h"
+#include "cli/cli-cmds.h"
+#include "sframe-api.h"
+
+/* Whether the SFrame unwinder is used.  It is off by default, since
+   the values of the callee-saved registers in callers, which DWARF CFI
+   describes, are lost with it.  */
+
+static bool sframe_unwinder_enabled = false;
+
+/* Implement "maint show sframe-unwinder".  */
+
+static void
+show_sframe_unwinder_enabled (struct ui_file *file, int from_tty,
+			      struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Whether frames are unwound using SFrame "
+		      "information is %s.\n"), value);
+}
+
+/* The SFrame information of an objfile.  */
+
+struct sframe_objfile_info
+{
+  sframe_objfile_info () = default;
+
+  ~sframe_objfile_info ()
+  {
+    if (decoder != nullptr)
+      sframe_decoder_free (&decoder);
+  }
+
+  DISABLE_COPY_AND_ASSIGN (sframe_objfile_info);
+
+  /* The decoded .sframe section, or nullptr if the objfile has no
+     usable one.  */
+  sframe_decoder_ctx *decoder = nullptr;
+
+  /* The unrelocated address of the .sframe section.  Function start
+     addresses in it are relative to this.  */
+  CORE_ADDR section_vma = 0;
+};
+
+static const registry<objfile>::key<sframe_objfile_info>
+  sframe_objfile_data;
+
+/* Return the SFrame ABI/arch identifier matching GDBARCH, or 0 if
+   SFrame doesn't support it.  */
+
+static unsigned char
+sframe_abi_for_gdbarch (struct gdbarch *gdbarch)
+{
+  const struct bfd_arch_info *info = gdbarch_bfd_arch_info (gdbarch);
+  bool big_endian = gdbarch_byte_order (gdbarch) == BFD_ENDIAN_BIG;
+
+  if (info->arch == bfd_arch_i386 && info->mach == bfd_mach_x86_64
+      && !big_endian)
+    return SFRAME_ABI_AMD64_ENDIAN_LITTLE;
+  else if (info->arch == bfd_arch_aarch64)
+    return (big_endian
+	    ? SFRAME_ABI_AARCH64_ENDIAN_BIG
+	    : SFRAME_ABI_AARCH64_ENDIAN_LITTLE);
+
+  return 0;
+}
+
+/* Return the SFrame information of OBJFILE, reading and decoding its
+   .sframe section the first time.  */
+
+static const sframe_objfile_info *
+get_sframe_objfile_info (struct objfile *objfile)
+{
+  sframe_objfile_info *info = sframe_objfile_data.get (objfile);
+  if (info != nullptr)
+    return info;
+
+  info = sframe_objfile_data.emplace (objfile);
+
+  bfd *abfd = objfile->obfd.get ();
+  asection *section = bfd_get_section_by_name (abfd, ".sframe");
+  if (section == nullptr || bfd_section_size (section) == 0)
+    return info;
+
+  /* Relocatable files would need the relocations of the section to be
+     applied first.  */
+  if ((bfd_get_file_flags (abfd) & (EXEC_P | DYNAMIC)) == 0)
+    return info;
+
+  gdb::byte_vector contents;
+  if (!gdb_bfd_get_full_section_contents (abfd, section, &contents))
+    return info;
+
+  int err = 0;
+  sframe_decoder_ctx *decoder
+    = sframe_decode ((const char *) contents.data (), contents.size (),
+		     &err);
+  if (decoder == nullptr)
+    {
+      warning (_("Could not decode the .sframe section of %s: %s"),
+	       objfile_name (objfile), sframe_errmsg (err));
+      return info;
+    }
+
+  /* Older versions of the format have a different layout, which the
+     lookup functions of libsframe don't handle.  */
+  if (sframe_decoder_get_version (decoder) != SFRAME_VERSION_2)
+    {
+      sframe_decoder_free (&decoder);
+      return info;
+    }
+
+  info->decoder = decoder;
+  info->section_vma = bfd_section_vma (section);
+  return info;
+}
+
+/* The frame cache of the SFrame unwinder.  */
+
+struct sframe_frame_cache
+{
+  /* The row found for the frame's PC, and what it was decoded with.  */
+  sframe_frame_row_entry fre;
+  sframe_decoder_ctx *decoder;
+
+  /* Whether the addresses below were computed.  */
+  bool computed;
+
+  /* Whether the return address is undefined, which marks the
+     outermost frame.  The addresses below are not computed then.  */
+  bool undefined_retaddr;
+
+  /* The canonical frame address, which is also the value of the stack
+     pointer in the caller.  */
+  CORE_ADDR cfa;
+
+  /* Whether the return address is saved on the stack, and where.
+     When it isn't (AArch64 leaf functions), it is still in the link
+     register.  */
+  bool ra_saved;
+  CORE_ADDR ra_addr;
+
+  /* Whether the caller's frame pointer is saved on the stack, and
+     where.  When it isn't, it is unchanged.  */
+  bool fp_saved;
+  CORE_ADDR fp_addr;
+};
+
+/* The register numbers the unwinder deals with, for GDBARCH.  */
+
+struct sframe_regnums
+{
+  int sp;
+  int fp;
+  int ra;
+  int pc;
+
+  /* The callee-saved registers other than the above, which SFrame
+     doesn't describe.  */
+  std::vector<int> callee_saved;
+};
+
+static const registry<gdbarch>::key<sframe_regnums> sframe_regnums_data;
+
+/* Return the register numbers of GDBARCH, computing them the first
+   time.  */
+
+static const sframe_regnums &
+sframe_get_regnums (struct gdbarch *gdbarch)
+{
+  sframe_regnums *cached = sframe_regnums_data.get (gdbarch);
+  if (cached != nullptr)
+    return *cached;
+
+  sframe_regnums &regnums = *sframe_regnums_data.emplace (gdbarch);
+
+  regnums.sp = gdbarch_sp_regnum (gdbarch);
+  regnums.pc = gdbarch_pc_regnum (gdbarch);
+
+  /* Use the DWARF numbers of the registers, which are part of the
+     ABI, so as not to depend on the tdep headers.  */
+  if (sframe_abi_for_gdbarch (gdbarch) == SFRAME_ABI_AMD64_ENDIAN_LITTLE)
+    {
+      regnums.fp = gdbarch_dwarf2_reg_to_regnum (gdbarch, 6);
+      regnums.ra = -1;
+
+      /* %rbx and %r12 to %r15.  */
+      for (int dwarf_reg : { 3, 12, 13, 14, 15 })
+	regnums.callee_saved.push_back
+	  (gdbarch_dwarf2_reg_to_regnum (gdbarch, dwarf_reg));
+    }
+  else
+    {
+      regnums.fp = gdbarch_dwarf2_reg_to_regnum (gdbarch, 29);
+      regnums.ra = gdbarch_dwarf2_reg_to_regnum (gdbarch, 30);
+
+      /* x19 to x28, and v8 to v15, whose low 64 bits are
+	 callee-saved.  */
+      for (int dwarf_reg = 19; dwarf_reg <= 28; dwarf_reg++)
+	regnums.callee_saved.push_back
+	  (gdbarch_dwarf2_reg_to_regnum (gdbarch, dwarf_reg));
+      for (int dwarf_reg = 64 + 8; dwarf_reg <= 64 + 15; dwarf_reg++)
+	regnums.callee_saved.push_back
+	  (gdbarch_dwarf2_reg_to_regnum (gdbarch, dwarf_reg));
+    }
+
+  return regnums;
+}
+
+/* Compute the addresses in CACHE, for THIS_FRAME.  */
+
+static void
+sframe_frame_compute (const frame_info_ptr &this_frame,
+		      sframe_frame_cache *cache)
+{
+  if (cache->computed)
+    return;
+
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  const sframe_regnums &regnums = sframe_get_regnums (gdbarch);
+  int err = 0;
+
+  uint8_t base_reg = sframe_fre_get_base_reg_id (&cache->fre, &err);
+  int32_t cfa_offset
+    = sframe_fre_get_cfa_offset (cache->decoder, &cache->fre, &err);
+
+  /* A row without any offset says that the return address is
+     undefined, as in the functions that start a program or a
+     thread.  */
+  if (err != 0)
+    {
+      cache->undefined_retaddr = true;
+      cache->computed = true;
+      return;
+    }
+
+  int base_regnum = base_reg == SFRAME_BASE_REG_FP ? regnums.fp : regnums.sp;
+  cache->cfa = get_frame_register_unsigned (this_frame, base_regnum)
+		+ cfa_offset;
+
+  err = 0;
+  int32_t ra_offset
+    = sframe_fre_get_ra_offset (cache->decoder, &cache->fre, &err);
+  cache->ra_saved = err == 0;
+  cache->ra_addr = cache->cfa + ra_offset;
+
+  err = 0;
+  int32_t fp_offset
+    = sframe_fre_get_fp_offset (cache->decoder, &cache->fre, &err);
+  cache->fp_saved = err == 0;
+  cache->fp_addr = cache->cfa + fp_offset;
+
+  cache->computed = true;
+}
+
+/* Implement the "stop_reason" frame_unwind method.  */
+
+static enum unwind_stop_reason
+sframe_frame_unwind_stop_reason (const frame_info_ptr &this_frame,
+				 void **this_cache)
+{
+  sframe_frame_cache *cache = (sframe_frame_cache *) *this_cache;
+
+  sframe_frame_compute (this_frame, cache);
+  if (cache->undefined_retaddr)
+    return UNWIND_OUTERMOST;
+
+  return UNWIND_NO_REASON;
+}
+
+/* Implement the "this_id" frame_unwind method.  */
+
+static void
+sframe_frame_this_id (const frame_info_ptr &this_frame, void **this_cache,
+		      struct frame_id *this_id)
+{
+  sframe_frame_cache *cache = (sframe_frame_cache *) *this_cache;
+
+  sframe_frame_compute (this_frame, cache);
+
+  /* The outermost frame keeps the outer_frame_id it was given.  */
+  if (cache->undefined_retaddr)
+    return;
+
+  (*this_id) = frame_id_build (cache->cfa, get_frame_func (this_frame));
+}
+
+/* Implement the "prev_register" frame_unwind method.  */
+
+static struct value *
+sframe_frame_prev_register (const frame_info_ptr &this_frame,
+			    void **this_cache, int regnum)
+{
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  sframe_frame_cache *cache = (sframe_frame_cache *) *this_cache;
+  const sframe_regnums &regnums = sframe_get_regnums (gdbarch);
+
+  sframe_frame_compute (this_frame, cache);
+
+  if (cache->undefined_retaddr)
+    {
+      if (regnum == regnums.pc || regnum == regnums.ra)
+	return frame_unwind_got_optimized (this_frame, regnum);
+      return frame_unwind_got_register (this_frame, regnum, regnum);
+    }
+
+  if (regnum == regnums.sp)
+    return frame_unwind_got_address (this_frame, regnum, cache->cfa);
+
+  if (regnum == regnums.fp && cache->fp_saved)
+    return frame_unwind_got_memory (this_frame, regnum, cache->fp_addr);
+
+  if (regnum == regnums.pc || regnum == regnums.ra)
+    {
+      if (cache->ra_saved)
+	{
+	  CORE_ADDR ra
+	    = read_memory_unsigned_integer (cache->ra_addr,
+					    gdbarch_ptr_bit (gdbarch) / 8,
+					    gdbarch_byte_order (gdbarch));
+	  return frame_unwind_got_address (this_frame, regnum,
+					   gdbarch_addr_bits_remove (gdbarch,
+								     ra));
+	}
+      else if (regnums.ra >= 0)
+	{
+	  /* The return address is still in the link register.  */
+	  CORE_ADDR ra = get_frame_register_unsigned (this_frame, regnums.ra);
+	  return frame_unwind_got_address (this_frame, regnum,
+					   gdbarch_addr_bits_remove (gdbarch,
+								     ra));
+	}
+    }
+
+  if (std::find (regnums.callee_saved.begin (), regnums.callee_saved.end (),
+		 regnum) != regnums.callee_saved.end ())
+    return frame_unwind_got_optimized (this_frame, regnum);
+
+  return frame_unwind_got_register (this_frame, regnum, regnum);
+}
+
+/* Implement the "sniffer" frame_unwind method.  Claim the frame if
+   its PC is described by the .sframe section of its objfile.  */
+
+static int
+sframe_frame_sniffer (const struct frame_unwind *self,
+		      const frame_info_ptr &this_frame, void **this_cache)
+{
+  if (!sframe_unwinder_enabled)
+    return 0;
+
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  unsigned char abi = sframe_abi_for_gdbarch (gdbarch);
+  if (abi == 0)
+    return 0;
+
+  /* Signal handlers and their callers are left to the unwinders that
+     know about signal frames.  */
+  if (get_next_frame (this_frame) != nullptr
+      && get_frame_type (get_next_frame (this_frame)) == SIGTRAMP_FRAME)
+    return 0;
+
+  CORE_ADDR pc = get_frame_address_in_block (this_frame);
+  struct obj_section *osect = find_pc_section (pc);
+  if (osect == nullptr)
+    return 0;
+
+  const sframe_objfile_info *info = get_sframe_objfile_info (osect->objfile);
+  if (info->decoder == nullptr
+      || sframe_decoder_get_abi_arch (info->decoder) != abi)
+    return 0;
+
+  CORE_ADDR unrelocated_pc = pc - osect->objfile->text_section_offset ();
+  LONGEST sframe_pc = (LONGEST) (unrelocated_pc - info->section_vma);
+  if (sframe_pc != (int32_t) sframe_pc)
+    return 0;
+
+  sframe_frame_row_entry fre;
+  if (sframe_find_fre (info->decoder, (int32_t) sframe_pc, &fre) != 0)
+    return 0;
+
+  /* Return addresses signed with pointer authentication are left to
+     the DWARF unwinder, which knows how to authenticate them.  */
+  int err = 0;
+  if (sframe_fre_get_ra_mangled_p (info->decoder, &fre, &err))
+    return 0;
+
+  sframe_frame_cache *cache = FRAME_OBSTACK_ZALLOC (sframe_frame_cache);
+  cache->fre = fre;
+  cache->decoder = info->decoder;
+  *this_cache = cache;
+  return 1;
+}
+
+static const struct frame_unwind sframe_frame_unwind =
+{
+  "sframe",
+  NORMAL_FRAME,
+  sframe_frame_unwind_stop_reason,
+  sframe_frame_this_id,
+  sframe_frame_prev_register,
+  NULL,
+  sframe_frame_sniffer
+};
+
+/* See sframe-frame.h.  */
+
+void
+sframe_append_unwinders (struct gdbarch *gdbarch)
+{
+  frame_unwind_append_unwinder (gdbarch, &sframe_frame_unwind);
+}
+
+void _initialize_sframe_frame ();
+void
+_initialize_sframe_frame ()
+{
+  add_setshow_boolean_cmd ("sframe-unwinder", class_maintenance,
+			   &sframe_unwinder_enabled, _("\
+Set whether frames are unwound using SFrame information."), _("\
+Show whether frames are unwound using SFrame information."), _("\
+When on, frames whose code is described by the .sframe section of its\n\
+object file are unwound using it, instead of DWARF call frame\n\
+information or prologue analysis.  This is cheaper, but the values of\n\
+the callee-saved registers other than the frame pointer are then\n\
+unknown in callers, so are shown as optimized out.  The default is off."),
+			   nullptr,
+			   show_sframe_unwinder_enabled,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+}
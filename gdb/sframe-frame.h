@@ -0,0 +1,34 @@
+/* Frame unwinder using SFrame stack trace information, for GDB.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SFRAME_FRAME_H
+#define SFRAME_FRAME_H
+
+struct gdbarch;
+
+/* Append the SFrame frame unwinder to the list of GDBARCH's
+   unwinders.  It only claims frames whose PC is covered by the
+   .sframe section of an objfile, and only for the architectures
+   SFrame supports (AMD64 and AArch64), so it should be appended
+   before the DWARF CFI unwinders, which then handle everything
+   else.  */
+
+extern void sframe_append_unwinders (struct gdbarch *gdbarch);
+
+#endif /* SFRAME_FRAME_H */
@@ -48,7 +48,9 @@
 #include "debuginfod-support.h"
 #include "source.h"
 #include "cli/cli-style.h"
+#include "target-file-cache.h"
 #include <iterator>
+#include <unordered_map>
 
 /* See solib.h.  */
 
@@ -458,16 +460,31 @@ solib_bfd_init (bfd *abfd)
 	   b->printable_name);
 }
 
+/* While update_solib_list prefetches shared libraries from the target,
+   the names that solib_find found for them, by the name they were
+   searched as.  This saves solib_bfd_open from searching for them
+   again on the target.  */
+
+static const std::unordered_map<std::string, std::string>
+  *prefetched_solib_names;
+
 /* Find shared library PATHNAME and open a BFD for it.  */
 
 gdb_bfd_ref_ptr
 solib_bfd_open (const char *pathname)
 {
-  int found_file;
+  int found_file = -1;
+  gdb::unique_xmalloc_ptr<char> found_pathname;
 
   /* Search for shared library file.  */
-  gdb::unique_xmalloc_ptr<char> found_pathname
-    = solib_find (pathname, &found_file);
+  if (prefetched_solib_names != nullptr)
+    {
+      auto iter = prefetched_solib_names->find (pathname);
+      if (iter != prefetched_solib_names->end ())
+	found_pathname = make_unique_xstrdup (iter->second.c_str ());
+    }
+  if (found_pathname == nullptr)
+    found_pathname = solib_find (pathname, &found_file);
   if (found_pathname == NULL)
     {
       /* Return failure if the file could not be found, so that we can
@@ -916,6 +933,43 @@ update_solib_list (int from_tty)
       int not_found = 0;
       const char *not_found_filename = NULL;
 
+      /* If the shared objects are read through the target and the
+	 target file cache is enabled, fetch them into the cache all at
+	 once, before reading them one by one.  */
+      std::vector<std::string> target_filenames;
+      std::unordered_map<std::string, std::string> found_names;
+      if (target_file_cache_enabled ()
+	  && is_target_filename (gdb_sysroot.c_str ())
+	  && !target_filesystem_is_local ())
+	for (const solib &new_so : inferior)
+	  {
+	    if (new_so.so_name.empty ())
+	      continue;
+
+	    /* Search for the library as solib_map_sections will.  */
+	    gdb::unique_xmalloc_ptr<char> name
+	      (tilde_expand (new_so.so_name.c_str ()));
+	    gdb::unique_xmalloc_ptr<char> filename;
+	    try
+	      {
+		filename = solib_find (name.get (), nullptr);
+	      }
+	    catch (const gdb_exception_error &ex)
+	      {
+		/* Leave the error to solib_map_sections.  */
+		continue;
+	      }
+
+	    if (filename != nullptr && is_target_filename (filename.get ()))
+	      {
+		target_filenames.emplace_back (filename.get ());
+		found_names.emplace (name.get (), filename.get ());
+	      }
+	  }
+      target_file_cache_prefetch prefetch (target_filenames, gnutarget);
+      scoped_restore restore_prefetched_solib_names
+	= make_scoped_restore (&prefetched_solib_names, &found_names);
+
       /* Fill in the rest of each of the `so' nodes.  */
       for (solib &new_so : inferior)
 	{
@@ -1037,20 +1091,38 @@ solib_add (const char *pattern, int from_tty, int readsyms)
   {
     bool any_matches = false;
     bool loaded_any_symbols = false;
+    std::vector<objfile *> new_objfiles;
     symfile_add_flags add_flags = SYMFILE_DEFER_BP_RESET;
 
     if (from_tty)
       add_flags |= SYMFILE_VERBOSE;
 
+    /* Normally, we would read the symbols from a library only if
+       READSYMS is set.  However, we're making a small exception for
+       the pthread library, because we sometimes need the library
+       symbols to be loaded in order to provide thread support
+       (x86-linux for instance).  */
+    auto add_this_solib_p = [&] (const solib &so)
+      {
+	return readsyms || libpthread_solib_p (so);
+      };
+
+    /* Read ahead the symbols of all the libraries about to be loaded,
+       in parallel.  The objfiles are still created one at a time
+       below, and whatever they did not use is discarded on exit.  */
+    std::vector<bfd *> to_prefetch;
+    for (solib &gdb : current_program_space->solibs ())
+      if ((!pattern || re_exec (gdb.so_name.c_str ()))
+	  && add_this_solib_p (gdb)
+	  && !gdb.symbols_loaded
+	  && gdb.abfd != nullptr)
+	to_prefetch.push_back (gdb.abfd.get ());
+    scoped_symbol_file_prefetch prefetch (to_prefetch);
+
     for (solib &gdb : current_program_space->solibs ())
       if (!pattern || re_exec (gdb.so_name.c_str ()))
 	{
-	  /* Normally, we would read the symbols from that library
-	     only if READSYMS is set.  However, we're making a small
-	     exception for the pthread library, because we sometimes
-	     need the library symbols to be loaded in order to provide
-	     thread support (x86-linux for instance).  */
-	  const int add_this_solib = (readsyms || libpthread_solib_p (gdb));
+	  const int add_this_solib = add_this_solib_p (gdb);
 
 	  any_matches = true;
 	  if (add_this_solib)
@@ -1065,12 +1137,24 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 					       gdb.so_name.c_str ()));
 		}
 	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = true;
+		{
+		  loaded_any_symbols = true;
+		  new_objfiles.push_back (gdb.objfile);
+		}
 	    }
 	}
 
+    /* Only the breakpoints that may have locations in the new
+       libraries need to be re-set.  If reading the symbols of a
+       library failed, we don't know what was added.  */
     if (loaded_any_symbols)
-      breakpoint_re_set ();
+      {
+	if (std::count (new_objfiles.begin (), new_objfiles.end (),
+			nullptr) == 0)
+	  breakpoint_re_set_objfiles (new_objfiles);
+	else
+	  breakpoint_re_set ();
+      }
 
     if (from_tty && pattern && !any_matches)
       gdb_printf ("No loaded shared libraries match the pattern `%s'.\n",
@@ -460,6 +460,20 @@ source_cache::get_source_lines (struct symtab *s, int first_line,
 			first_line, last_line, lines);
 }
 
+/* See source-cache.h.  */
+
+size_t
+source_cache::memory_used () const
+{
+  size_t result = 0;
+  for (const source_text &text : m_source_map)
+    result += text.fullname.capacity () + text.contents.capacity ();
+  for (const auto &iter : m_offset_cache)
+    result += (iter.first.capacity ()
+	       + iter.second.capacity () * sizeof (off_t));
+  return result;
+}
+
 /* Implement 'maint flush source-cache' command.  */
 
 static void
@@ -61,6 +61,10 @@ class source_cache
   bool get_source_lines (struct symtab *s, int first_line,
 			 int last_line, std::string *lines_out);
 
+  /* Return the number of bytes of memory used by the cached file
+     contents and line offsets.  */
+  size_t memory_used () const;
+
   /* Remove all the items from the source cache.  */
   void clear ()
   {
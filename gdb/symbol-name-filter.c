@@ -0,0 +1,526 @@
+/* Approximate sets of symbol names, to speed up failing lookups
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "symbol-name-filter.h"
+#include "symtab.h"
+#include "block.h"
+#include "objfiles.h"
+#include "minsyms.h"
+#include "cli/cli-cmds.h"
+#include "gdbsupport/gdb-safe-ctype.h"
+#include "gdbsupport/selftest.h"
+
+/* Whether the name filters are used.  */
+
+static bool symbol_name_filter_enabled = true;
+
+/* Implement "maint show symbol-name-filter".  */
+
+static void
+show_symbol_name_filter_enabled (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  gdb_printf (file, _("Whether symbol lookups use name filters "
+		      "to skip objfiles is %s.\n"),
+	      value);
+}
+
+/* The number of bits set in the filter for each key.  With about 10
+   bits per name, this gives about 1% of false positives.  */
+
+static constexpr int name_filter_n_hashes = 4;
+static constexpr size_t name_filter_bits_per_name = 10;
+
+/* Compute the key of NAME, as described with symbol_name_filter, and
+   store its hash in *HASH.  Return false if NAME has no reliable
+   key.  */
+
+static bool
+symbol_name_key_hash (const char *name, uint64_t *hash)
+{
+  /* Ada verbatim names, and Objective-C methods.  */
+  if (name[0] == '<' || name[0] == '[' || name[0] == '-' || name[0] == '+')
+    return false;
+
+  /* Operator names contain characters that are also used for nesting,
+     and may be spelled in several ways.  */
+  if (strstr (name, "operator") != nullptr)
+    return false;
+
+  /* Find the last component at the outer level, and where its
+     template arguments or parameters start, if it has any.  */
+  const char *start = name;
+  const char *end = nullptr;
+  int depth = 0;
+  const char *p;
+  for (p = name; *p != '\0'; ++p)
+    {
+      switch (*p)
+	{
+	case '(':
+	case '<':
+	case '[':
+	  if (depth == 0 && end == nullptr)
+	    end = p;
+	  ++depth;
+	  break;
+
+	case ')':
+	case '>':
+	case ']':
+	  if (--depth < 0)
+	    return false;
+	  break;
+
+	case ':':
+	  if (depth == 0 && p[1] == ':')
+	    {
+	      ++p;
+	      start = p + 1;
+	      end = nullptr;
+	    }
+	  break;
+
+	case '.':
+	  if (depth == 0)
+	    {
+	      start = p + 1;
+	      end = nullptr;
+	    }
+	  break;
+
+	case '_':
+	  /* GNAT encodes the dots of qualified names as "__", so the
+	     last component of such a name is ambiguous.  */
+	  if (p[1] == '_' && p != start)
+	    return false;
+	  break;
+
+	case '\'':
+	case '"':
+	  return false;
+	}
+    }
+
+  if (end == nullptr)
+    end = p;
+
+  /* A 64-bit FNV-1a hash of the key, followed by the finalizer of
+     MurmurHash3, so that all the bits of the result are usable.  */
+  uint64_t h = 0xcbf29ce484222325ull;
+  bool empty = true;
+  for (p = start; p < end; ++p)
+    {
+      if (ISSPACE (*p))
+	continue;
+      h ^= (unsigned char) TOLOWER (*p);
+      h *= 0x100000001b3ull;
+      empty = false;
+    }
+
+  if (empty)
+    return false;
+
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+
+  *hash = h;
+  return true;
+}
+
+/* See symbol-name-filter.h.  */
+
+symbol_name_filter::symbol_name_filter (size_t n_names)
+{
+  size_t n_words = 1;
+  while (n_words * 64 < n_names * name_filter_bits_per_name)
+    n_words *= 2;
+  m_bits.resize (n_words);
+}
+
+/* See symbol-name-filter.h.  */
+
+void
+symbol_name_filter::set_bits (uint64_t hash)
+{
+  size_t mask = m_bits.size () * 64 - 1;
+  uint64_t h1 = hash & 0xffffffff;
+  uint64_t h2 = (hash >> 32) | 1;
+
+  for (int i = 0; i < name_filter_n_hashes; ++i)
+    {
+      size_t bit = (h1 + i * h2) & mask;
+      m_bits[bit / 64] |= (uint64_t) 1 << (bit % 64);
+    }
+}
+
+/* See symbol-name-filter.h.  */
+
+bool
+symbol_name_filter::test_bits (uint64_t hash) const
+{
+  size_t mask = m_bits.size () * 64 - 1;
+  uint64_t h1 = hash & 0xffffffff;
+  uint64_t h2 = (hash >> 32) | 1;
+
+  for (int i = 0; i < name_filter_n_hashes; ++i)
+    {
+      size_t bit = (h1 + i * h2) & mask;
+      if ((m_bits[bit / 64] & ((uint64_t) 1 << (bit % 64))) == 0)
+	return false;
+    }
+
+  return true;
+}
+
+/* See symbol-name-filter.h.  */
+
+void
+symbol_name_filter::add (const char *name)
+{
+  uint64_t hash;
+
+  if (symbol_name_key_hash (name, &hash))
+    {
+      set_bits (hash);
+      ++m_n_names;
+      return;
+    }
+
+  /* A GNAT encoded name like "pck__foo" has no key, but is found by
+     lookups of "pck.foo" or "foo", which have one.  Add the key of
+     each of its "__" separated components, since which one is the
+     last component of the decoded name depends on the suffixes, like
+     the "__2" of overloads, that GNAT appends.  The other names
+     without a key, like C++ operators, are only matched by lookups
+     without a key, for which maybe_contains always returns true.  */
+  if (strstr (name + 1, "__") == nullptr)
+    return;
+
+  bool added = false;
+  std::string component;
+  const char *p = name;
+  while (*p != '\0')
+    {
+      const char *sep = strstr (p + 1, "__");
+      const char *end = sep != nullptr ? sep : p + strlen (p);
+
+      component.assign (p, end);
+      if (symbol_name_key_hash (component.c_str (), &hash))
+	{
+	  set_bits (hash);
+	  added = true;
+	}
+
+      if (sep == nullptr)
+	break;
+      p = sep + 2;
+    }
+
+  if (added)
+    ++m_n_names;
+}
+
+/* See symbol-name-filter.h.  */
+
+bool
+symbol_name_filter::maybe_contains (const char *name) const
+{
+  uint64_t hash;
+
+  ++m_n_lookups;
+  if (!symbol_name_key_hash (name, &hash) || test_bits (hash))
+    return true;
+
+  ++m_n_rejected;
+  return false;
+}
+
+/* See symbol-name-filter.h.  */
+
+void
+symbol_name_filter::print_stats (const char *what) const
+{
+  gdb_printf (_("  %s filter: %zu names, %zu bytes\n"), what,
+	      m_n_names, m_bits.size () * sizeof (uint64_t));
+  gdb_printf (_("  %s filter: %u lookups, %u objfiles skipped\n"), what,
+	      m_n_lookups, m_n_rejected);
+}
+
+/* The symbol name filter of an objfile.  */
+
+struct objfile_name_filter
+{
+  /* The filter, or nullptr if the names can't all be listed.  */
+  std::unique_ptr<symbol_name_filter> filter;
+
+  /* The number of quick symbol functions of the objfile when FILTER
+     was built.  When symbols are read again, the filter must be
+     rebuilt.  */
+  size_t n_qf = 0;
+};
+
+static const registry<objfile>::key<objfile_name_filter> name_filter_key;
+
+/* Call CALLBACK with the names of the global and static symbols of
+   CUST.  */
+
+static void
+map_compunit_symbol_names (compunit_symtab *cust,
+			   gdb::function_view<void (const char *)> callback)
+{
+  const blockvector *bv = cust->blockvector ();
+  if (bv == nullptr)
+    return;
+
+  for (block_enum i : { GLOBAL_BLOCK, STATIC_BLOCK })
+    for (symbol *sym : bv->block (i)->multidict_symbols ())
+      {
+	callback (sym->search_name ());
+	if (sym->natural_name () != sym->search_name ())
+	  callback (sym->natural_name ());
+      }
+}
+
+/* See symbol-name-filter.h.  */
+
+const symbol_name_filter *
+objfile_symbol_name_filter (struct objfile *objfile)
+{
+  if (!symbol_name_filter_enabled)
+    return nullptr;
+
+  size_t n_qf = std::distance (objfile->qf.begin (), objfile->qf.end ());
+  objfile_name_filter *data = name_filter_key.get (objfile);
+  if (data != nullptr)
+    {
+      if (data->n_qf == n_qf)
+	return data->filter.get ();
+      name_filter_key.clear (objfile);
+    }
+
+  data = name_filter_key.emplace (objfile);
+  data->n_qf = n_qf;
+
+  std::vector<const char *> names;
+  auto add_name = [&] (const char *name)
+    {
+      names.push_back (name);
+    };
+
+  if (!objfile->map_symbol_names (add_name))
+    return nullptr;
+  for (compunit_symtab *cust : objfile->compunits ())
+    map_compunit_symbol_names (cust, add_name);
+
+  symtab_create_debug_printf ("building the symbol name filter of %s "
+			      "from %zu names",
+			      objfile_name (objfile), names.size ());
+
+  data->filter = std::make_unique<symbol_name_filter> (names.size ());
+  for (const char *name : names)
+    data->filter->add (name);
+
+  return data->filter.get ();
+}
+
+/* See symbol-name-filter.h.  */
+
+void
+symbol_name_filter_add_compunit (struct compunit_symtab *cust)
+{
+  objfile_name_filter *data = name_filter_key.get (cust->objfile ());
+  if (data == nullptr || data->filter == nullptr)
+    return;
+
+  map_compunit_symbol_names (cust, [&] (const char *name)
+    {
+      data->filter->add (name);
+    });
+}
+
+/* See symbol-name-filter.h.  */
+
+void
+build_minimal_symbol_name_filter (struct objfile *objfile)
+{
+  objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  minimal_symbol *msymbols = per_bfd->msymbols.get ();
+  int mcount = per_bfd->minimal_symbol_count;
+
+  /* Most minimal symbols have a linkage name and a different
+     demangled name.  */
+  auto filter = std::make_unique<symbol_name_filter> (2 * mcount);
+  for (int i = 0; i < mcount; ++i)
+    {
+      filter->add (msymbols[i].linkage_name ());
+      if (msymbols[i].search_name () != msymbols[i].linkage_name ())
+	filter->add (msymbols[i].search_name ());
+    }
+
+  per_bfd->minsym_name_filter = std::move (filter);
+}
+
+/* See symbol-name-filter.h.  */
+
+const symbol_name_filter *
+objfile_minimal_symbol_name_filter (struct objfile *objfile)
+{
+  if (!symbol_name_filter_enabled)
+    return nullptr;
+
+  return objfile->per_bfd->minsym_name_filter.get ();
+}
+
+/* See symbol-name-filter.h.  */
+
+size_t
+symbol_name_filter_memory_used (struct objfile *objfile)
+{
+  objfile_name_filter *data = name_filter_key.get (objfile);
+  if (data == nullptr || data->filter == nullptr)
+    return 0;
+  return data->filter->memory_used ();
+}
+
+/* See symbol-name-filter.h.  */
+
+void
+print_symbol_name_filter_statistics (struct objfile *objfile)
+{
+  objfile_name_filter *data = name_filter_key.get (objfile);
+  if (data != nullptr && data->filter != nullptr)
+    data->filter->print_stats (_("Symbol name"));
+
+  if (objfile->per_bfd->minsym_name_filter != nullptr)
+    objfile->per_bfd->minsym_name_filter->print_stats
+      (_("Minimal symbol name"));
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Return true if LOOKUP_NAME and SYMBOL_NAME have the same key.  */
+
+static bool
+same_key (const char *lookup_name, const char *symbol_name)
+{
+  uint64_t h1, h2;
+  return (symbol_name_key_hash (lookup_name, &h1)
+	  && symbol_name_key_hash (symbol_name, &h2)
+	  && h1 == h2);
+}
+
+/* Return true if NAME has no key.  */
+
+static bool
+no_key (const char *name)
+{
+  uint64_t hash;
+  return !symbol_name_key_hash (name, &hash);
+}
+
+static void
+test_symbol_name_filter ()
+{
+  /* Names that are matched by the lookups of other names must have the
+     same key.  */
+  SELF_CHECK (same_key ("foo", "foo"));
+  SELF_CHECK (same_key ("foo", "foo(int)"));
+  SELF_CHECK (same_key ("foo", "ns::foo (char const*)"));
+  SELF_CHECK (same_key ("ns::foo", "foo"));
+  SELF_CHECK (same_key ("foo", "foo<int>"));
+  SELF_CHECK (same_key ("A<B::C>::foo", "foo"));
+  SELF_CHECK (same_key ("(anonymous namespace)::foo", "foo"));
+  SELF_CHECK (same_key ("foo", "foo[abi:cxx11]()"));
+  SELF_CHECK (same_key ("pck.foo", "foo"));
+  SELF_CHECK (same_key ("FOO", "foo"));
+  SELF_CHECK (same_key ("main.(*T).Method", "Method"));
+  SELF_CHECK (same_key ("__libc_start_main", "__libc_start_main"));
+  SELF_CHECK (same_key ("std::__cxx11::foo", "foo"));
+  SELF_CHECK (!same_key ("foo", "bar"));
+  SELF_CHECK (!same_key ("foo::bar", "foo"));
+
+  SELF_CHECK (no_key ("operator<"));
+  SELF_CHECK (no_key ("A::operator int"));
+  SELF_CHECK (no_key ("pck__foo"));
+  SELF_CHECK (no_key ("<pck__foo>"));
+  SELF_CHECK (no_key ("-[Foo bar:]"));
+  SELF_CHECK (no_key ("foo)"));
+  SELF_CHECK (no_key ("ns::"));
+
+  symbol_name_filter filter (100);
+  for (int i = 0; i < 100; ++i)
+    filter.add (string_printf ("sym_%d", i).c_str ());
+  for (int i = 0; i < 100; ++i)
+    SELF_CHECK (filter.maybe_contains (string_printf ("sym_%d", i).c_str ()));
+
+  /* The filter is approximate, but not by that much.  */
+  int n_found = 0;
+  for (int i = 100; i < 1100; ++i)
+    if (filter.maybe_contains (string_printf ("sym_%d", i).c_str ()))
+      ++n_found;
+  SELF_CHECK (n_found < 100);
+
+  /* Names without a key are never rejected.  */
+  SELF_CHECK (filter.maybe_contains ("operator=="));
+
+  /* GNAT encoded names are found by the lookups of their decoded
+     names.  */
+  symbol_name_filter ada_filter (10);
+  ada_filter.add ("pck__foo");
+  ada_filter.add ("pck__inner__bar__2");
+  SELF_CHECK (ada_filter.maybe_contains ("foo"));
+  SELF_CHECK (ada_filter.maybe_contains ("pck.foo"));
+  SELF_CHECK (ada_filter.maybe_contains ("pck__foo"));
+  SELF_CHECK (ada_filter.maybe_contains ("bar"));
+  SELF_CHECK (ada_filter.maybe_contains ("pck.inner.bar"));
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
+void _initialize_symbol_name_filter ();
+void
+_initialize_symbol_name_filter ()
+{
+  add_setshow_boolean_cmd ("symbol-name-filter", class_maintenance,
+			   &symbol_name_filter_enabled, _("\
+Set whether symbol lookups use name filters to skip objfiles."), _("\
+Show whether symbol lookups use name filters to skip objfiles."), _("\
+When enabled, each objfile keeps an approximate set of the names of\n\
+its symbols and minimal symbols.  Lookups of global and static symbols,\n\
+and of minimal symbols, skip the objfiles whose set shows that they\n\
+can't have the name looked up."),
+			   nullptr,
+			   show_symbol_name_filter_enabled,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+#if GDB_SELF_TEST
+  selftests::register_test ("symbol-name-filter",
+			    selftests::test_symbol_name_filter);
+#endif
+}
@@ -0,0 +1,115 @@
+/* Approximate sets of symbol names, to speed up failing lookups
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SYMBOL_NAME_FILTER_H
+#define SYMBOL_NAME_FILTER_H
+
+struct objfile;
+struct compunit_symtab;
+
+/* A compact, approximate set of symbol names, implemented as a Bloom
+   filter.  A name that was added is always reported as possibly
+   present.  A name that was not added is usually, but not always,
+   reported as absent.
+
+   Names are not stored as is, but reduced to a key: the last
+   component of the qualified name, without template arguments,
+   parameters, whitespace or case.  This way, a lookup name has the
+   same key as all the symbol names it can match, whatever the
+   language rules used for matching are.  Names for which such a key
+   can't be computed reliably, like C++ operators, are always reported
+   as possibly present.  */
+
+class symbol_name_filter
+{
+public:
+  /* Create an empty filter, sized for about N_NAMES names.  */
+  explicit symbol_name_filter (size_t n_names);
+
+  DISABLE_COPY_AND_ASSIGN (symbol_name_filter);
+
+  /* Add NAME to this filter.  */
+  void add (const char *name);
+
+  /* Return false if no symbol name that a lookup of NAME could match
+     was added to this filter.  Return true if one may have been.  */
+  bool maybe_contains (const char *name) const;
+
+  /* Print statistics about this filter.  WHAT describes the names it
+     holds.  */
+  void print_stats (const char *what) const;
+
+  /* Return the number of bytes of memory used by this filter.  */
+  size_t memory_used () const
+  {
+    return m_bits.size () * sizeof (uint64_t);
+  }
+
+private:
+  /* Set or test the bits of the key whose hash is HASH.  */
+  void set_bits (uint64_t hash);
+  bool test_bits (uint64_t hash) const;
+
+  /* The bits of the filter.  The number of bits is a power of 2.  */
+  std::vector<uint64_t> m_bits;
+
+  /* The number of names added.  */
+  size_t m_n_names = 0;
+
+  /* The number of calls to maybe_contains, and how many of them
+     returned false.  */
+  mutable unsigned int m_n_lookups = 0;
+  mutable unsigned int m_n_rejected = 0;
+};
+
+/* Return the filter holding the names of all the global and static
+   symbols that a lookup in OBJFILE may find, whether they are in
+   expanded symtabs or not.  It is built the first time it is needed.
+   Return nullptr if OBJFILE's symbol readers can't list their names,
+   or if "maint set symbol-name-filter" is off.  */
+
+extern const symbol_name_filter *objfile_symbol_name_filter
+  (struct objfile *objfile);
+
+/* Add the names of the global and static symbols of CUST to the
+   filter of its objfile, if that was already built.  */
+
+extern void symbol_name_filter_add_compunit (struct compunit_symtab *cust);
+
+/* Build the filter of the minimal symbols of OBJFILE's per-BFD data,
+   once they are all installed.  */
+
+extern void build_minimal_symbol_name_filter (struct objfile *objfile);
+
+/* Return the filter of the minimal symbol names of OBJFILE, or nullptr
+   if there is none, or if "maint set symbol-name-filter" is off.  */
+
+extern const symbol_name_filter *objfile_minimal_symbol_name_filter
+  (struct objfile *objfile);
+
+/* Return the number of bytes of memory used by the symbol name filter
+   of OBJFILE, not counting its minimal symbol name filter.  */
+
+extern size_t symbol_name_filter_memory_used (struct objfile *objfile);
+
+/* Print the statistics of the filters of OBJFILE, if it has any.  */
+
+extern void print_symbol_name_filter_statistics (struct objfile *objfile);
+
+#endif /* SYMBOL_NAME_FILTER_H */
@@ -172,15 +172,15 @@ objfile::forget_cached_source_info ()
 bool
 objfile::map_symtabs_matching_filename
   (const char *name, const char *real_path,
-   gdb::function_view<bool (symtab *)> callback)
+   gdb::function_view<bool (symtab *)> callback, int line)
 {
   if (debug_symfile)
     gdb_printf (gdb_stdlog,
 		"qf->map_symtabs_matching_filename (%s, \"%s\", "
-		"\"%s\", %s)\n",
+		"\"%s\", %s, %d)\n",
 		objfile_debug_name (this), name,
 		real_path ? real_path : NULL,
-		host_address_to_string (&callback));
+		host_address_to_string (&callback), line);
 
   bool retval = true;
   const char *name_basename = lbasename (name);
@@ -214,14 +214,22 @@ objfile::map_symtabs_matching_filename
 
   for (const auto &iter : qf)
     {
-      if (!iter->expand_symtabs_matching (this,
-					  match_one_filename,
-					  nullptr,
-					  nullptr,
-					  on_expansion,
-					  (SEARCH_GLOBAL_BLOCK
-					   | SEARCH_STATIC_BLOCK),
-					  SEARCH_ALL_DOMAINS))
+      bool keep_going;
+      if (line > 0)
+	keep_going = iter->expand_symtabs_for_source_line (this,
+							   match_one_filename,
+							   line,
+							   on_expansion);
+      else
+	keep_going = iter->expand_symtabs_matching (this,
+						    match_one_filename,
+						    nullptr,
+						    nullptr,
+						    on_expansion,
+						    (SEARCH_GLOBAL_BLOCK
+						     | SEARCH_STATIC_BLOCK),
+						    SEARCH_ALL_DOMAINS);
+      if (!keep_going)
 	{
 	  retval = false;
 	  break;
@@ -468,6 +476,31 @@ objfile::compute_main_name ()
     iter->compute_main_name (this);
 }
 
+bool
+objfile::map_symbol_names (gdb::function_view<void (const char *)> callback)
+{
+  if (debug_symfile)
+    gdb_printf (gdb_stdlog,
+		"qf->map_symbol_names (%s, %s)\n",
+		objfile_debug_name (this),
+		host_address_to_string (&callback));
+
+  bool retval = true;
+  for (const auto &iter : qf)
+    if (!iter->map_symbol_names (this, callback))
+      {
+	retval = false;
+	break;
+      }
+
+  if (debug_symfile)
+    gdb_printf (gdb_stdlog,
+		"qf->map_symbol_names (...) = %d\n",
+		retval);
+
+  return retval;
+}
+
 struct compunit_symtab *
 objfile::find_compunit_symtab_by_address (CORE_ADDR address)
 {
@@ -814,6 +847,7 @@ static const struct sym_fns debug_sym_fns =
   debug_sym_read_linetable,
   debug_sym_relocate,
   &debug_sym_probe_fns,
+  NULL,
 };
 
 /* Install the debugging versions of the symfile functions for OBJFILE.
@@ -53,7 +53,9 @@
 #include "solib.h"
 #include "remote.h"
 #include "stack.h"
+#include "symbol-name-filter.h"
 #include "gdb_bfd.h"
+#include "target-file-cache.h"
 #include "cli/cli-utils.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/pathstuff.h"
@@ -61,6 +63,8 @@
 #include "cli/cli-style.h"
 #include "gdbsupport/forward-scope-exit.h"
 #include "gdbsupport/buildargv.h"
+#include "gdbsupport/parallel-for.h"
+#include "run-on-main-thread.h"
 
 #include <sys/types.h>
 #include <fcntl.h>
@@ -68,6 +72,7 @@
 #include <ctype.h>
 #include <chrono>
 #include <algorithm>
+#include <unordered_set>
 
 int (*deprecated_ui_load_progress_hook) (const char *section,
 					 unsigned long num);
@@ -1001,7 +1006,7 @@ finish_new_objfile (struct objfile *objfile, symfile_add_flags add_flags)
     }
   else if ((add_flags & SYMFILE_DEFER_BP_RESET) == 0)
     {
-      breakpoint_re_set ();
+      breakpoint_re_set_objfiles (objfile);
     }
 
   /* We're done reading the symbol file; finish off complaints.  */
@@ -1159,6 +1164,75 @@ symbol_file_add_from_bfd (const gdb_bfd_ref_ptr &abfd, const char *name,
 				     parent);
 }
 
+/* See symfile.h.  */
+
+scoped_symbol_file_prefetch::scoped_symbol_file_prefetch
+  (gdb::array_view<bfd *const> abfds)
+{
+  /* The BFDs that have something to read ahead.  A BFD may be shared
+     by several symbol files, but must only be read by one worker.  */
+  std::unordered_set<bfd *> seen;
+  for (bfd *abfd : abfds)
+    {
+      if (!seen.insert (abfd).second)
+	continue;
+
+      const struct sym_fns *sf;
+      try
+	{
+	  sf = find_sym_fns (abfd);
+	}
+      catch (const gdb_exception_error &)
+	{
+	  /* Reported when the symbol file is added.  */
+	  continue;
+	}
+
+      if (sf != nullptr && sf->sym_prefetch != nullptr)
+	m_work.emplace_back (gdb_bfd_ref_ptr::new_reference (abfd), sf);
+    }
+
+  if (m_work.empty ())
+    return;
+
+  symtab_create_debug_printf ("reading ahead the symbols of %zu files",
+			      m_work.size ());
+
+  /* Warnings can't be emitted from the workers.  Keep them per file,
+     so that they can be emitted in order below.  */
+  std::vector<deferred_warnings> warnings (m_work.size ());
+
+  gdb::parallel_for_each (1, (size_t) 0, m_work.size (),
+			  [&] (size_t first, size_t last)
+    {
+      /* The last range is handled by the main thread, whose BFD error
+	 state must be kept.  */
+      SCOPE_EXIT
+	{
+	  if (!is_main_thread ())
+	    bfd_thread_cleanup ();
+	};
+
+      for (size_t i = first; i < last; ++i)
+	{
+	  scoped_restore_warning_hook restore_warnings (&warnings[i]);
+	  m_work[i].second->sym_prefetch (m_work[i].first.get ());
+	}
+    });
+
+  for (const deferred_warnings &w : warnings)
+    w.emit ();
+}
+
+/* See symfile.h.  */
+
+scoped_symbol_file_prefetch::~scoped_symbol_file_prefetch ()
+{
+  for (const auto &[abfd, sf] : m_work)
+    if (sf->sym_prefetch_release != nullptr)
+      sf->sym_prefetch_release (abfd.get ());
+}
+
 /* Process a symbol file, as either the main file or as a dynamically
    loaded file.  See symbol_file_add_with_addrs's comments for details.  */
 
@@ -2484,7 +2558,7 @@ reread_symbols (int from_tty)
 	continue;
 
       struct stat new_statbuf;
-      int res = bfd_stat (objfile->obfd.get (), &new_statbuf);
+      int res = target_file_cache_stat (objfile->obfd.get (), &new_statbuf);
       if (res != 0)
 	{
 	  /* If this object is from an archive (what you usually create
@@ -2890,6 +2964,9 @@ add_compunit_symtab_to_objfile (struct compunit_symtab *cu)
 {
   cu->next = cu->objfile ()->compunit_symtabs;
   cu->objfile ()->compunit_symtabs = cu;
+
+  compunit_symtab_added (cu);
+  symbol_name_filter_add_compunit (cu);
 }
 
 
@@ -26,6 +26,7 @@
 #include "symfile-add-flags.h"
 #include "objfile-flags.h"
 #include "gdb_bfd.h"
+#include "gdbsupport/array-view.h"
 #include "gdbsupport/function-view.h"
 #include "target-section.h"
 #include "quick-symbol.h"
@@ -173,6 +174,19 @@ struct sym_fns
   /* If non-NULL, this objfile has probe support, and all the probe
      functions referred to here will be non-NULL.  */
   const struct sym_probe_fns *sym_probe_fns;
+
+  /* If non-NULL, read ahead the data of ABFD that sym_read will need
+     and that does not depend on an objfile, such as the BFD symbol
+     tables.  This is called from worker threads, concurrently for
+     different BFDs, before the objfile of ABFD is created.  Errors
+     should not be reported here, but left to sym_read.  */
+
+  void (*sym_prefetch) (bfd *abfd);
+
+  /* If non-NULL, discard what sym_prefetch read ahead for ABFD and
+     sym_read did not use.  This is called from the main thread.  */
+
+  void (*sym_prefetch_release) (bfd *abfd);
 };
 
 extern section_addr_info
@@ -241,6 +255,27 @@ extern struct objfile *symbol_file_add_from_bfd (const gdb_bfd_ref_ptr &,
 extern void symbol_file_add_separate (const gdb_bfd_ref_ptr &, const char *,
 				      symfile_add_flags, struct objfile *);
 
+/* Read ahead, using the thread pool, the parts of the symbols of the
+   BFDs in ABFDS that can be read without an objfile.  This is meant
+   to be instantiated before adding several symbol files at once, with
+   symbol_file_add_from_bfd.  Whatever was read ahead and not used by
+   the time this object is destroyed is discarded.  */
+
+class scoped_symbol_file_prefetch
+{
+public:
+
+  explicit scoped_symbol_file_prefetch (gdb::array_view<bfd *const> abfds);
+  ~scoped_symbol_file_prefetch ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_symbol_file_prefetch);
+
+private:
+
+  /* The BFDs that were read ahead, and their symbol readers.  */
+  std::vector<std::pair<gdb_bfd_ref_ptr, const sym_fns *>> m_work;
+};
+
 /* Find separate debuginfo for OBJFILE (using .gnu_debuglink section).
    Returns pathname, or an empty string.
 
@@ -107,6 +107,7 @@ print_objfile_statistics (void)
 		    objfile_name (objfile));
 	objfile->per_bfd->string_cache.print_statistics ("string cache");
 	objfile->print_stats (true);
+	print_symbol_name_filter_statistics (objfile);
       }
 }
 
@@ -31,6 +31,7 @@
 #include "expression.h"
 #include "language.h"
 #include "demangle.h"
+#include "gdb-demangle.h"
 #include "inferior.h"
 #include "source.h"
 #include "filenames.h"
@@ -674,11 +675,17 @@ iterate_over_some_symtabs (const char *name,
    in the symtab filename will also work.
 
    Calls CALLBACK with each symtab that is found.  If CALLBACK returns
-   true, the search stops.  */
+   true, the search stops.
+
+   If LINE is positive, the caller is only interested in code for that
+   line of NAME, or for the first line with code after it.  Symbol
+   tables that are not expanded yet and are known to have no such code
+   are then skipped.  */
 
 void
 iterate_over_symtabs (const char *name,
-		      gdb::function_view<bool (symtab *)> callback)
+		      gdb::function_view<bool (symtab *)> callback,
+		      int line)
 {
   gdb::unique_xmalloc_ptr<char> real_path;
 
@@ -704,7 +711,7 @@ iterate_over_symtabs (const char *name,
   for (objfile *objfile : current_program_space->objfiles ())
     {
       if (objfile->map_symtabs_matching_filename (name, real_path.get (),
-						  callback))
+						  callback, line))
 	return;
     }
 }
@@ -943,30 +950,40 @@ gdb::unique_xmalloc_ptr<char>
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
-  gdb::unique_xmalloc_ptr<char> demangled;
-  int i;
+  /* The same names are often found in many objfiles, so share the
+     results.  */
+  enum language language = gsymbol->language ();
+  gdb::unique_xmalloc_ptr<char> result
+    = demangle_cache_lookup (demangle_cache_kind::SYMBOL, &language, mangled,
+			     [&] (enum language *lang_p)
+      {
+	gdb::unique_xmalloc_ptr<char> demangled;
 
-  if (gsymbol->language () != language_unknown)
-    {
-      const struct language_defn *lang = language_def (gsymbol->language ());
+	if (*lang_p != language_unknown)
+	  {
+	    const struct language_defn *lang = language_def (*lang_p);
 
-      lang->sniff_from_mangled_name (mangled, &demangled);
-      return demangled;
-    }
+	    lang->sniff_from_mangled_name (mangled, &demangled);
+	    return demangled;
+	  }
 
-  for (i = language_unknown; i < nr_languages; ++i)
-    {
-      enum language l = (enum language) i;
-      const struct language_defn *lang = language_def (l);
+	for (int i = language_unknown; i < nr_languages; ++i)
+	  {
+	    enum language l = (enum language) i;
+	    const struct language_defn *lang = language_def (l);
 
-      if (lang->sniff_from_mangled_name (mangled, &demangled))
-	{
-	  gsymbol->m_language = l;
-	  return demangled;
-	}
-    }
+	    if (lang->sniff_from_mangled_name (mangled, &demangled))
+	      {
+		*lang_p = l;
+		return demangled;
+	      }
+	  }
 
-  return NULL;
+	return demangled;
+      });
+
+  gsymbol->m_language = language;
+  return result;
 }
 
 /* Set both the mangled and demangled (if any) names for GSYMBOL based
@@ -2565,6 +2582,16 @@ lookup_symbol_in_objfile (struct objfile *objfile, enum block_enum block_index,
 			      ? "GLOBAL_BLOCK" : "STATIC_BLOCK",
 			      name, domain_name (domain).c_str ());
 
+  /* Skip the objfile quickly if it has no symbol by this name.  This
+     avoids waiting for, and searching, its index.  */
+  const symbol_name_filter *filter = objfile_symbol_name_filter (objfile);
+  if (filter != nullptr && !filter->maybe_contains (name))
+    {
+      symbol_lookup_debug_printf
+	("lookup_symbol_in_objfile (...) = NULL (name filter)");
+      return {};
+    }
+
   result = lookup_symbol_in_objfile_symtabs (objfile, block_index,
 					     name, domain);
   if (result.symbol != NULL)
@@ -2888,75 +2915,85 @@ find_pc_sect_compunit_symtab (CORE_ADDR pc, struct obj_section *section)
      like xcoff does (I'm not sure).
 
      It also happens for objfiles that have their functions reordered.
-     For these, the symtab we are looking for is not necessarily read in.  */
+     For these, the symtab we are looking for is not necessarily read in.
+
+     The compunits that can't contain PC are skipped without looking at
+     them, see iterate_over_compunits_at_pc.  */
 
-  for (objfile *obj_file : current_program_space->objfiles ())
+  struct compunit_symtab *found_cust = nullptr;
+  iterate_over_compunits_at_pc (pc, [&] (compunit_symtab *cust)
     {
-      for (compunit_symtab *cust : obj_file->compunits ())
+      struct objfile *obj_file = cust->objfile ();
+      const struct blockvector *bv = cust->blockvector ();
+      const struct block *global_block = bv->global_block ();
+      CORE_ADDR start = global_block->start ();
+      CORE_ADDR end = global_block->end ();
+      bool in_range_p = start <= pc && pc < end;
+      if (!in_range_p)
+	return false;
+
+      if (bv->map () != nullptr)
 	{
-	  const struct blockvector *bv = cust->blockvector ();
-	  const struct block *global_block = bv->global_block ();
-	  CORE_ADDR start = global_block->start ();
-	  CORE_ADDR end = global_block->end ();
-	  bool in_range_p = start <= pc && pc < end;
-	  if (!in_range_p)
-	    continue;
+	  if (bv->map ()->find (pc) == nullptr)
+	    return false;
 
-	  if (bv->map () != nullptr)
-	    {
-	      if (bv->map ()->find (pc) == nullptr)
-		continue;
+	  found_cust = cust;
+	  return true;
+	}
 
-	      return cust;
-	    }
+      CORE_ADDR range = end - start;
+      if (best_cust != nullptr
+	  && range >= best_cust_range)
+	/* Cust doesn't have a smaller range than best_cust, skip it.  */
+	return false;
 
-	  CORE_ADDR range = end - start;
-	  if (best_cust != nullptr
-	      && range >= best_cust_range)
-	    /* Cust doesn't have a smaller range than best_cust, skip it.  */
-	    continue;
-	
-	  /* For an objfile that has its functions reordered,
-	     find_pc_psymtab will find the proper partial symbol table
-	     and we simply return its corresponding symtab.  */
-	  /* In order to better support objfiles that contain both
-	     stabs and coff debugging info, we continue on if a psymtab
-	     can't be found.  */
-	  struct compunit_symtab *result
-	    = obj_file->find_pc_sect_compunit_symtab (msymbol, pc,
-						      section, 0);
-	  if (result != nullptr)
-	    return result;
-
-	  if (section != 0)
-	    {
-	      struct symbol *found_sym = nullptr;
+      /* For an objfile that has its functions reordered,
+	 find_pc_psymtab will find the proper partial symbol table
+	 and we simply return its corresponding symtab.  */
+      /* In order to better support objfiles that contain both
+	 stabs and coff debugging info, we continue on if a psymtab
+	 can't be found.  */
+      struct compunit_symtab *result
+	= obj_file->find_pc_sect_compunit_symtab (msymbol, pc,
+						  section, 0);
+      if (result != nullptr)
+	{
+	  found_cust = result;
+	  return true;
+	}
+
+      if (section != 0)
+	{
+	  struct symbol *found_sym = nullptr;
 
-	      for (int b_index = GLOBAL_BLOCK;
-		   b_index <= STATIC_BLOCK && found_sym == nullptr;
-		   ++b_index)
+	  for (int b_index = GLOBAL_BLOCK;
+	       b_index <= STATIC_BLOCK && found_sym == nullptr;
+	       ++b_index)
+	    {
+	      const struct block *b = bv->block (b_index);
+	      for (struct symbol *sym : block_iterator_range (b))
 		{
-		  const struct block *b = bv->block (b_index);
-		  for (struct symbol *sym : block_iterator_range (b))
+		  if (matching_obj_sections (sym->obj_section (obj_file),
+					     section))
 		    {
-		      if (matching_obj_sections (sym->obj_section (obj_file),
-						 section))
-			{
-			  found_sym = sym;
-			  break;
-			}
+		      found_sym = sym;
+		      break;
 		    }
 		}
-	      if (found_sym == nullptr)
-		continue;		/* No symbol in this symtab matches
-					   section.  */
 	    }
-
-	  /* Cust is best found sofar, save it.  */
-	  best_cust = cust;
-	  best_cust_range = range;
+	  if (found_sym == nullptr)
+	    return false;	/* No symbol in this symtab matches
+				   section.  */
 	}
-    }
+
+      /* Cust is best found sofar, save it.  */
+      best_cust = cust;
+      best_cust_range = range;
+      return false;
+    });
+
+  if (found_cust != nullptr)
+    return found_cust;
 
   if (best_cust != NULL)
     return best_cust;
@@ -2832,7 +2832,8 @@ bool iterate_over_some_symtabs (const char *name,
 				gdb::function_view<bool (symtab *)> callback);
 
 void iterate_over_symtabs (const char *name,
-			   gdb::function_view<bool (symtab *)> callback);
+			   gdb::function_view<bool (symtab *)> callback,
+			   int line = 0);
 
 
 std::vector<CORE_ADDR> find_pcs_for_symtab_line
@@ -281,6 +281,11 @@ target_debug_print_gdb_array_view_const_int
   (const gdb::array_view<const int> &view)
 { return host_address_to_string (view.data ()); }
 
+static std::string
+target_debug_print_gdb_array_view_memory_read_range
+  (const gdb::array_view<memory_read_range> &view)
+{ return pulongest (view.size ()); }
+
 static std::string
 target_debug_print_record_print_flags (record_print_flags flags)
 { return plongest (flags); }
@@ -0,0 +1,446 @@
+/* Caching of files read from the target.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "target-file-cache.h"
+
+#include "build-id.h"
+#include "cli/cli-cmds.h"
+#include "command.h"
+#include "event-top.h"
+#include "filenames.h"
+#include "inferior.h"
+#include "target.h"
+#include "gdbsupport/byte-vector.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/scope-exit.h"
+#include <sys/stat.h>
+#include <unordered_map>
+
+/* When true, show debug messages about the target file cache.  */
+static bool debug_target_file_cache = false;
+
+#define target_file_cache_debug(FMT, ...)				\
+  debug_prefixed_printf_cond_nofunc (debug_target_file_cache,		\
+				     "target-file-cache", FMT, ## __VA_ARGS__)
+
+/* Whether the target file cache is used, for "set/show target-file-cache
+   enabled".  */
+static bool target_file_cache_enabled_p = false;
+
+/* The target file cache directory, for "set/show target-file-cache
+   directory".  */
+static std::string target_file_cache_directory;
+
+/* The number of files found in the cache, and fetched into it, during
+   this session, and the number of bytes fetched.  */
+static unsigned int target_file_cache_hits = 0;
+static unsigned int target_file_cache_misses = 0;
+static ULONGEST target_file_cache_bytes_fetched = 0;
+
+/* A file opened by target_file_cache_prefetch.  */
+
+struct prefetched_file
+{
+  /* The BFD target used to open it.  */
+  std::string target;
+
+  /* Its BFD.  */
+  gdb_bfd_ref_ptr abfd;
+};
+
+/* The files opened by the live target_file_cache_prefetch object, if
+   any, by name.  */
+static std::unordered_map<std::string, prefetched_file> prefetched_files;
+
+/* See target-file-cache.h.  */
+
+bool
+target_file_cache_enabled ()
+{
+  return (target_file_cache_enabled_p
+	  && !target_file_cache_directory.empty ());
+}
+
+/* Return the name of the cached copy of the target file ABFD, whose
+   status on the target is ST.  Return an empty string if the file
+   can't be cached.  */
+
+static std::string
+cache_file_name (bfd *abfd, const struct stat &st)
+{
+  const bfd_build_id *build_id = build_id_bfd_get (abfd);
+
+  /* A separate debug file has the same build ID as the file it is for,
+     so the size is needed to tell them apart.  */
+  if (build_id != nullptr)
+    return string_printf ("%s/build-id/%s.%s",
+			  target_file_cache_directory.c_str (),
+			  build_id_to_string (build_id).c_str (),
+			  pulongest (st.st_size));
+
+  const char *name = bfd_get_filename (abfd) + strlen (TARGET_SYSROOT_PREFIX);
+  if (!IS_ABSOLUTE_PATH (name) || strstr (name, "/../") != nullptr)
+    return {};
+
+  return string_printf ("%s/by-name%s.%s.%s",
+			target_file_cache_directory.c_str (), name,
+			pulongest (st.st_size), plongest (st.st_mtime));
+}
+
+/* Copy the target file NAME, of SIZE bytes, to the local file
+   FILENAME.  Throw an error on failure.  */
+
+static void
+fetch_target_file (const char *name, off_t size, const std::string &filename)
+{
+  if (!mkdir_recursive (ldirname (filename.c_str ()).c_str ()))
+    perror_with_name (_("Couldn't make cache directory"));
+
+  gdb::char_vector temp_filename = make_temp_filename (filename);
+  scoped_fd out_fd = gdb_mkostemp_cloexec (temp_filename.data (), O_BINARY);
+  if (out_fd.get () == -1)
+    perror_with_name (temp_filename.data ());
+  gdb::unlinker unlink_file (temp_filename.data ());
+
+  fileio_error target_errno;
+  int fd = target_fileio_open (current_inferior (),
+			       name + strlen (TARGET_SYSROOT_PREFIX),
+			       FILEIO_O_RDONLY, 0, false, &target_errno);
+  if (fd == -1)
+    error (_("Couldn't open %s: %s"), name,
+	   safe_strerror (fileio_error_to_host (target_errno)));
+
+  SCOPE_EXIT
+    {
+      /* Ignore errors on close, like gdb_bfd does.  */
+      try
+	{
+	  target_fileio_close (fd, &target_errno);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	}
+    };
+
+  /* Large reads let the remote target pipeline its requests, see "set
+     remote read-window".  */
+  gdb::byte_vector buf (1024 * 1024);
+  off_t offset = 0;
+  while (offset < size)
+    {
+      QUIT;
+
+      int n = target_fileio_pread (fd, buf.data (),
+				   std::min<off_t> (buf.size (), size - offset),
+				   offset, &target_errno);
+      if (n == -1)
+	error (_("Couldn't read %s: %s"), name,
+	       safe_strerror (fileio_error_to_host (target_errno)));
+      if (n == 0)
+	error (_("%s is shorter than expected"), name);
+
+      for (int written = 0; written < n; )
+	{
+	  ssize_t ret = write (out_fd.get (), buf.data () + written,
+			       n - written);
+	  if (ret < 0 && errno == EINTR)
+	    continue;
+	  if (ret <= 0)
+	    perror_with_name (temp_filename.data ());
+	  written += ret;
+	}
+
+      offset += n;
+    }
+
+  out_fd = scoped_fd ();
+  if (rename (temp_filename.data (), filename.c_str ()) != 0)
+    perror_with_name (filename.c_str ());
+  unlink_file.keep ();
+
+  target_file_cache_bytes_fetched += size;
+}
+
+/* See target-file-cache.h.  */
+
+gdb_bfd_ref_ptr
+target_file_cache_open (bfd *abfd, const char *target)
+{
+  if (!target_file_cache_enabled ())
+    return nullptr;
+
+  const char *name = bfd_get_filename (abfd);
+  gdb_assert (is_target_filename (name));
+
+  std::string filename;
+  struct stat st;
+  try
+    {
+      if (bfd_stat (abfd, &st) != 0 || !S_ISREG (st.st_mode))
+	return nullptr;
+
+      filename = cache_file_name (abfd, st);
+      if (filename.empty ())
+	return nullptr;
+
+      struct stat local_st;
+      if (stat (filename.c_str (), &local_st) == 0
+	  && local_st.st_size == st.st_size)
+	{
+	  target_file_cache_debug ("%s found in %s", name, filename.c_str ());
+	  target_file_cache_hits++;
+	}
+      else
+	{
+	  target_file_cache_debug ("fetching %s to %s", name,
+				   filename.c_str ());
+	  target_file_cache_misses++;
+	  fetch_target_file (name, st.st_size, filename);
+	}
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      target_file_cache_debug ("couldn't cache %s: %s", name, ex.what ());
+      return nullptr;
+    }
+
+  scoped_fd fd = gdb_open_cloexec (filename, O_RDONLY | O_BINARY, 0);
+  if (fd.get () == -1)
+    return nullptr;
+
+  /* Unlike gdb_bfd_fopen, don't make the BFD cacheable, so that BFD
+     never closes its file descriptor and reopens it by name.  This
+     allows keeping the target file name, which the rest of GDB relies
+     on to know where the file comes from.  */
+  bfd *result = bfd_fopen (filename.c_str (), target, FOPEN_RB, fd.release ());
+  if (result == nullptr)
+    return nullptr;
+
+  if (bfd_set_filename (result, name) == nullptr)
+    {
+      bfd_close (result);
+      return nullptr;
+    }
+
+  /* The modification time of the local copy is when it was fetched.
+     Report the one of the target file instead, which is what
+     reread_symbols compares with to know whether the file changed.  */
+  result->mtime = st.st_mtime;
+  result->mtime_set = true;
+
+  return gdb_bfd_ref_ptr::new_reference (result);
+}
+
+/* See target-file-cache.h.  */
+
+int
+target_file_cache_stat (bfd *abfd, struct stat *st)
+{
+  const char *name = bfd_get_filename (abfd);
+  if (!is_target_filename (name) || target_filesystem_is_local ())
+    return bfd_stat (abfd, st);
+
+  fileio_error target_errno;
+  int fd = target_fileio_open (current_inferior (),
+			       name + strlen (TARGET_SYSROOT_PREFIX),
+			       FILEIO_O_RDONLY, 0, false, &target_errno);
+  if (fd == -1)
+    {
+      errno = fileio_error_to_host (target_errno);
+      return -1;
+    }
+
+  int result = target_fileio_fstat (fd, st, &target_errno);
+  if (result == -1)
+    errno = fileio_error_to_host (target_errno);
+
+  /* Ignore errors on close, like gdb_bfd does.  */
+  try
+    {
+      fileio_error close_errno;
+      target_fileio_close (fd, &close_errno);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+    }
+
+  return result;
+}
+
+/* See target-file-cache.h.  */
+
+gdb_bfd_ref_ptr
+target_file_cache_take_prefetched (const char *name, const char *target)
+{
+  auto it = prefetched_files.find (name);
+  if (it == prefetched_files.end ()
+      || it->second.target != (target != nullptr ? target : ""))
+    return nullptr;
+
+  gdb_bfd_ref_ptr result = std::move (it->second.abfd);
+  prefetched_files.erase (it);
+  return result;
+}
+
+/* See target-file-cache.h.  */
+
+target_file_cache_prefetch::target_file_cache_prefetch
+  (const std::vector<std::string> &filenames, const char *target)
+{
+  if (!target_file_cache_enabled ())
+    return;
+
+  prefetched_files.clear ();
+  for (const std::string &name : filenames)
+    {
+      gdb_assert (is_target_filename (name.c_str ()));
+
+      if (prefetched_files.find (name) != prefetched_files.end ())
+	continue;
+
+      /* A file that can't be opened now is opened, and its error
+	 reported, when it is needed.  */
+      gdb_bfd_ref_ptr abfd;
+      try
+	{
+	  abfd = gdb_bfd_open (name.c_str (), target);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  target_file_cache_debug ("couldn't prefetch %s: %s", name.c_str (),
+				   ex.what ());
+	}
+      if (abfd == nullptr)
+	continue;
+
+      prefetched_files.emplace (name,
+				prefetched_file {target != nullptr
+						 ? target : "",
+						 std::move (abfd)});
+    }
+}
+
+/* See target-file-cache.h.  */
+
+target_file_cache_prefetch::~target_file_cache_prefetch ()
+{
+  prefetched_files.clear ();
+}
+
+/* set/show target-file-cache commands.  */
+static cmd_list_element *set_target_file_cache_prefix_list;
+static cmd_list_element *show_target_file_cache_prefix_list;
+
+/* "set target-file-cache directory" handler.  */
+
+static void
+set_target_file_cache_directory_command (const char *arg, int from_tty,
+					 cmd_list_element *element)
+{
+  /* Make sure the directory is absolute and tilde-expanded.  */
+  target_file_cache_directory
+    = gdb_abspath (target_file_cache_directory.c_str ());
+}
+
+/* "show target-file-cache enabled" handler.  */
+
+static void
+show_target_file_cache_enabled_command (ui_file *stream, int from_tty,
+					cmd_list_element *cmd,
+					const char *value)
+{
+  gdb_printf (stream, _("The target file cache is %s.\n"), value);
+}
+
+/* "show target-file-cache directory" handler.  */
+
+static void
+show_target_file_cache_directory_command (ui_file *stream, int from_tty,
+					  cmd_list_element *cmd,
+					  const char *value)
+{
+  gdb_printf (stream, _("The directory of the target file cache is "
+			"\"%s\".\n"), value);
+}
+
+/* "show target-file-cache stats" handler.  */
+
+static void
+show_target_file_cache_stats_command (const char *arg, int from_tty)
+{
+  gdb_printf (_("Cache hits (this session): %u\n"),
+	      target_file_cache_hits);
+  gdb_printf (_("Cache misses (this session): %u\n"),
+	      target_file_cache_misses);
+  gdb_printf (_("Bytes fetched (this session): %s\n"),
+	      pulongest (target_file_cache_bytes_fetched));
+}
+
+void _initialize_target_file_cache ();
+void
+_initialize_target_file_cache ()
+{
+  /* Set the default cache directory.  */
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    target_file_cache_directory = cache_dir + "/target-files";
+
+  add_setshow_prefix_cmd ("target-file-cache", class_files,
+			  _("Set target file cache options."),
+			  _("Show target file cache options."),
+			  &set_target_file_cache_prefix_list,
+			  &show_target_file_cache_prefix_list,
+			  &setlist, &showlist);
+
+  add_setshow_boolean_cmd ("enabled", class_files,
+			   &target_file_cache_enabled_p, _("\
+Enable the target file cache."), _("\
+Show whether the target file cache is enabled."), _("\
+When on, GDB keeps local copies of the files it reads from the target,\n\
+with a \"target:\" file name, in the directory set with\n\
+\"set target-file-cache directory\", and reads these copies instead of\n\
+fetching the files again in later sessions."),
+			   nullptr, show_target_file_cache_enabled_command,
+			   &set_target_file_cache_prefix_list,
+			   &show_target_file_cache_prefix_list);
+
+  add_setshow_filename_cmd ("directory", class_files,
+			    &target_file_cache_directory, _("\
+Set the directory of the target file cache."), _("\
+Show the directory of the target file cache."),
+			    nullptr,
+			    set_target_file_cache_directory_command,
+			    show_target_file_cache_directory_command,
+			    &set_target_file_cache_prefix_list,
+			    &show_target_file_cache_prefix_list);
+
+  add_cmd ("stats", class_files, show_target_file_cache_stats_command,
+	   _("Show some stats about the target file cache."),
+	   &show_target_file_cache_prefix_list);
+
+  add_setshow_boolean_cmd ("target-file-cache", class_maintenance,
+			   &debug_target_file_cache, _("\
+Set display of target file cache debug messages."), _("\
+Show display of target file cache debug messages."), _("\
+When on, debugging output for the target file cache is displayed."),
+			   nullptr, nullptr,
+			   &setdebuglist, &showdebuglist);
+}
@@ -0,0 +1,84 @@
+/* Caching of files read from the target.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef TARGET_FILE_CACHE_H
+#define TARGET_FILE_CACHE_H
+
+#include "gdb_bfd.h"
+
+/* The target file cache keeps local copies of the files that GDB reads
+   through the target, with a "target:" file name, when the target's
+   file system is not the local one.  The copies are kept in a
+   directory of the host, across sessions.  A file is identified by
+   its build ID and size if it has a build ID, and by its name, size
+   and modification time on the target otherwise.
+
+   Reading a file from the cache only takes a few requests to the
+   target, to identify it, and GDB can map the sections of a local
+   file in memory instead of reading them through the target.  */
+
+/* Return true if the target file cache is enabled.  */
+
+extern bool target_file_cache_enabled ();
+
+/* ABFD is a BFD opened through the target, whose file name starts with
+   "target:".  If the target file cache is enabled, return a BFD for a
+   local copy of the same file, fetching it into the cache if needed,
+   and using the BFD target TARGET.  Return nullptr if the cache is
+   disabled or if the file can't be cached, in which case ABFD should
+   be used as is.  */
+
+extern gdb_bfd_ref_ptr target_file_cache_open (bfd *abfd,
+					       const char *target);
+
+/* Like bfd_stat, but for a BFD whose file name starts with "target:",
+   and whose target file system is not the local one, store the status
+   of the file on the target in *ST.  This is the status of the file
+   ABFD was read from even if target_file_cache_open returned ABFD.
+   Return 0 on success, and -1 with errno set on failure.  */
+
+extern int target_file_cache_stat (bfd *abfd, struct stat *st);
+
+/* If NAME was fetched by a target_file_cache_prefetch object for the
+   BFD target TARGET, return its BFD and forget about it.  Otherwise,
+   return nullptr.  */
+
+extern gdb_bfd_ref_ptr target_file_cache_take_prefetched
+  (const char *name, const char *target);
+
+/* While an object of this type is alive, the BFDs of a set of target
+   files that were fetched at once are kept open, so that opening them
+   with gdb_bfd_open doesn't need any request to the target.  */
+
+class target_file_cache_prefetch
+{
+public:
+  /* Open the files FILENAMES, whose names start with "target:", with
+     the BFD target TARGET, fetching the ones that are not in the cache
+     yet.  Do nothing if the cache is disabled.  */
+  target_file_cache_prefetch (const std::vector<std::string> &filenames,
+			      const char *target);
+
+  /* Forget about the files that were not opened.  */
+  ~target_file_cache_prefetch ();
+
+  DISABLE_COPY_AND_ASSIGN (target_file_cache_prefetch);
+};
+
+#endif /* TARGET_FILE_CACHE_H */
@@ -2180,6 +2180,17 @@ read_memory_robust (struct target_ops *ops,
   return result;
 }
 
+/* See target.h.  */
+
+bool
+target_read_memory_ranges (gdb::array_view<memory_read_range> ranges)
+{
+  for (memory_read_range &range : ranges)
+    range.xfered_len = 0;
+
+  return current_inferior ()->top_target ()->read_memory_ranges (ranges);
+}
+
 
 /* An alternative to target_write with progress callbacks.  */
 
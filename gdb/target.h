@@ -292,6 +292,32 @@ struct memory_read_result
 extern std::vector<memory_read_result> read_memory_robust
     (struct target_ops *ops, const ULONGEST offset, const LONGEST len);
 
+/* A range of raw memory to read with target_read_memory_ranges.  */
+
+struct memory_read_range
+{
+  /* The address of the first byte to read.  */
+  CORE_ADDR addr;
+  /* The number of bytes to read.  */
+  ULONGEST len;
+  /* Where to store the contents.  Must have room for LEN bytes.  */
+  gdb_byte *buf;
+  /* Set to the number of bytes read from ADDR on, which may be less
+     than LEN, or zero if none could be read.  */
+  ULONGEST xfered_len = 0;
+};
+
+/* Read the raw memory of each of RANGES, if possible with a single
+   request to the target.  This is worthwhile when the ranges are not
+   contiguous, or are too many to be covered by a single
+   target_read_raw_memory call, and each request to the target has a
+   high latency, as with remote targets.  Return false, without
+   reading anything, if the target can't read several ranges at once;
+   the caller should then read them one by one.  */
+
+extern bool target_read_memory_ranges
+  (gdb::array_view<memory_read_range> ranges);
+
 /* Request that OPS transfer up to LEN addressable units from BUF to the
    target's OBJECT.  When writing to a memory object, the addressable unit
    size is architecture dependent and can be found using
@@ -853,6 +879,12 @@ struct target_ops
     virtual ULONGEST get_memory_xfer_limit ()
       TARGET_DEFAULT_RETURN (ULONGEST_MAX);
 
+    /* Read the raw memory of each of RANGES.  Return false if the
+       target can't read several ranges at once.  For details, see
+       target_read_memory_ranges.  */
+    virtual bool read_memory_ranges (gdb::array_view<memory_read_range> ranges)
+      TARGET_DEFAULT_RETURN (false);
+
     /* Returns the memory map for the target.  A return value of NULL
        means that no memory map is available.  If a memory address
        does not fall within any returned regions, it's assumed to be
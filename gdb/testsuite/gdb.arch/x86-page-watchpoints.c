@@ -0,0 +1,65 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <sys/mman.h>
+
+/* A region too large for the debug registers, and unwatched data
+   sharing its pages.  */
+
+struct
+{
+  int watched[1024];
+  int unwatched[1024];
+} data;
+
+/* Pages that the program write-protects itself while watched.  */
+
+char protected_data[2 * 4096] __attribute__ ((aligned (4096)));
+
+/* A region on the stack.  */
+
+static void
+stack_region (void)
+{
+  volatile int local[2048];
+
+  local[1000] = 0;
+  local[1000] = 1;		/* stack write */
+}
+
+int
+main (void)
+{
+  int i;
+
+  stack_region ();
+
+  for (i = 0; i < 1024; i++)
+    data.unwatched[i] = i;
+
+  data.watched[512] = 1;	/* first write */
+
+  for (i = 0; i < 1024; i++)
+    data.unwatched[i] = -i;
+
+  data.watched[1023] = 2;	/* second write */
+
+  mprotect (protected_data, sizeof (protected_data), PROT_NONE);
+  protected_data[0] = 1;	/* write to protected */
+
+  return 0;			/* done */
+}
@@ -0,0 +1,73 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int counter;
+
+#define BP_ORDER_FUNC(N)			\
+  void __attribute__ ((noinline))		\
+  bp_order_func_ ## N (void)			\
+  {						\
+    counter++;					\
+  }
+
+BP_ORDER_FUNC (1)
+BP_ORDER_FUNC (2)
+BP_ORDER_FUNC (3)
+BP_ORDER_FUNC (4)
+BP_ORDER_FUNC (5)
+BP_ORDER_FUNC (6)
+BP_ORDER_FUNC (7)
+BP_ORDER_FUNC (8)
+BP_ORDER_FUNC (9)
+BP_ORDER_FUNC (10)
+BP_ORDER_FUNC (11)
+BP_ORDER_FUNC (12)
+BP_ORDER_FUNC (13)
+BP_ORDER_FUNC (14)
+BP_ORDER_FUNC (15)
+BP_ORDER_FUNC (16)
+BP_ORDER_FUNC (17)
+BP_ORDER_FUNC (18)
+BP_ORDER_FUNC (19)
+BP_ORDER_FUNC (20)
+
+int
+main (void)
+{
+  bp_order_func_1 ();
+  bp_order_func_2 ();
+  bp_order_func_3 ();
+  bp_order_func_4 ();
+  bp_order_func_5 ();
+  bp_order_func_6 ();
+  bp_order_func_7 ();
+  bp_order_func_8 ();
+  bp_order_func_9 ();
+  bp_order_func_10 ();
+  bp_order_func_11 ();
+  bp_order_func_12 ();
+  bp_order_func_13 ();
+  bp_order_func_14 ();
+  bp_order_func_15 ();
+  bp_order_func_16 ();
+  bp_order_func_17 ();
+  bp_order_func_18 ();
+  bp_order_func_19 ();
+  bp_order_func_20 ();
+
+  return counter == 20 ? 0 : 1;
+}
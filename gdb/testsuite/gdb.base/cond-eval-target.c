@@ -0,0 +1,75 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+#define NUM_THREADS 4
+#define ITERATIONS 10
+
+/* The number of calls to hit.  */
+volatile int counter;
+
+volatile int global;
+int *volatile null_ptr;
+
+static pthread_barrier_t barrier;
+
+void __attribute__ ((noinline))
+hit (int i)
+{
+  __sync_fetch_and_add (&counter, 1);
+  global = i;
+}
+
+static void *
+worker (void *arg)
+{
+  int i;
+
+  pthread_barrier_wait (&barrier);
+
+  for (i = 0; i < ITERATIONS; i++)
+    hit (i);
+
+  return NULL;
+}
+
+void __attribute__ ((noinline))
+threads_done (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  hit (0);			/* next over */
+  hit (1);			/* step into */
+  hit (2);
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS);
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, worker, NULL);
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  threads_done ();
+
+  return 0;
+}
@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int global;
+
+static void __attribute__ ((noinline))
+leaf (void)
+{
+  global++;		/* break here */
+}
+
+static int __attribute__ ((noinline))
+middle (int depth)
+{
+  char buf[64];
+
+  buf[depth] = depth;
+  if (depth == 0)
+    leaf ();
+  else
+    middle (depth - 1);
+  return buf[depth];
+}
+
+int
+main (void)
+{
+  return middle (5);
+}
@@ -0,0 +1,41 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This file is built into many compilation units, CU being the
+   number of each.  The cold function of each unit goes to a section
+   shared by all the units, so that the code of each unit is split in
+   two, and the address range of each unit overlaps the others.  */
+
+#define CAT2(a, b) a ## b
+#define CAT(a, b) CAT2 (a, b)
+
+#define FUNC CAT (pc_lookup_func_, CU)
+#define COLD CAT (pc_lookup_cold_, CU)
+
+int COLD (int x) __attribute__ ((noinline, section (".text.pc_lookup_cold")));
+
+int
+COLD (int x)
+{
+  return x * CU;	/* cold line */
+}
+
+int
+FUNC (int x)
+{
+  return COLD (x) + CU;	/* func line */
+}
@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int global;
+
+static int
+recurse (int depth)
+{
+  int result;
+
+  if (depth == 0)
+    {
+      result = global;		/* break here */
+      result++;
+      global = result;
+      result++;
+      return result;
+    }
+
+  result = recurse (depth - 1);
+  return result + depth;
+}
+
+int
+main (void)
+{
+  return recurse (20) == 212 ? 0 : 1;
+}
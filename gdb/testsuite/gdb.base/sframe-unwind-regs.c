@@ -0,0 +1,54 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int global;
+int input = 7;
+
+/* With -O2, OUTER and MIDDLE both keep a value in the same
+   callee-saved register across their call, which MIDDLE saves on the
+   stack.  NOIPA makes sure that OUTER doesn't know that.  */
+
+int __attribute__ ((noipa))
+leaf (int x)
+{
+  global += x;		/* break here */
+  return global;
+}
+
+int __attribute__ ((noipa))
+middle (int x)
+{
+  int kept = x * 5 + 2;
+
+  leaf (x);
+  return kept + global;
+}
+
+int __attribute__ ((noipa))
+outer (int n)
+{
+  int local = n * 3 + 1;
+
+  middle (n + 1);
+  return local + global;
+}
+
+int
+main (void)
+{
+  return outer (input);
+}
@@ -0,0 +1,32 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+extern int prefetch_lib1_func (int);
+extern int prefetch_lib2_func (int);
+extern int prefetch_lib3_func (int);
+
+int
+main (void)
+{
+  int val = 0;
+
+  val = prefetch_lib1_func (val);
+  val = prefetch_lib2_func (val);
+  val = prefetch_lib3_func (val);
+
+  return val == 3 ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The number of calls to do_alloc with a small size between two
+   calls with a large one.  Set by GDB.  */
+volatile unsigned long small_allocs = 1;
+
+volatile unsigned long total;
+
+void
+do_alloc (unsigned long size)
+{
+  total += size;
+}
+
+int
+main (void)
+{
+  while (1)
+    {
+      unsigned long i;
+
+      for (i = 0; i < small_allocs; i++)
+	do_alloc (16);
+
+      do_alloc (1 << 21);
+    }
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when it goes through
+# many hits of a conditional breakpoint whose condition is false.
+
+from perftest import perftest
+
+
+class CondBreakpoint(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super(CondBreakpoint, self).__init__("cond-breakpoint")
+
+    def warm_up(self):
+        gdb.execute("continue", False, True)
+
+    def _run(self):
+        gdb.execute("continue", False, True)
+
+    def execute_test(self):
+        for mode in ("host", "target"):
+            try:
+                gdb.execute(
+                    "set breakpoint condition-evaluation %s" % mode, False, True
+                )
+            except gdb.error:
+                continue
+            self.measure.measure(self._run, "evaluation-%s" % mode)
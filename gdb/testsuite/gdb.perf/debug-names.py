@@ -0,0 +1,45 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when it reads the
+# .debug_names index of a program.
+
+from perftest import perftest, utils
+
+
+class DebugNames(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, binfile, worker_threads):
+        super(DebugNames, self).__init__("debug-names")
+        self.binfile = binfile
+        self.worker_threads = worker_threads.split()
+
+    def warm_up(self):
+        utils.select_file(self.binfile)
+        utils.select_file(None)
+
+    def _doit(self):
+        utils.select_file(self.binfile)
+        # Looking up a symbol that doesn't exist waits until the whole
+        # index has been read.
+        gdb.lookup_global_symbol("no_such_symbol")
+
+    def execute_test(self):
+        for threads in self.worker_threads:
+            gdb.execute("maint set worker-threads %s" % threads)
+            iteration = 5
+            while iteration > 0:
+                self.measure.measure(self._doit, "threads-%s" % threads)
+                utils.select_file(None)
+                iteration -= 1
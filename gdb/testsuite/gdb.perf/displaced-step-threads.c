@@ -0,0 +1,67 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+#define NUM_THREADS 8
+
+/* The number of times each thread goes through the breakpoint in each
+   round.  Set by the test.  */
+volatile int iterations = 100;
+
+volatile int counter;
+
+void __attribute__ ((noinline))
+marker (void)
+{
+  counter++;
+}
+
+static void *
+worker (void *arg)
+{
+  int i;
+
+  for (i = 0; i < iterations; i++)
+    marker ();
+
+  return NULL;
+}
+
+void __attribute__ ((noinline))
+round_done (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  while (1)
+    {
+      for (i = 0; i < NUM_THREADS; i++)
+	pthread_create (&threads[i], NULL, worker, NULL);
+      for (i = 0; i < NUM_THREADS; i++)
+	pthread_join (threads[i], NULL);
+
+      round_done ();
+    }
+
+  return 0;
+}
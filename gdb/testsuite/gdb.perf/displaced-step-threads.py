@@ -0,0 +1,55 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when several threads go
+# through a breakpoint in non-stop mode, depending on the number of
+# displaced stepping buffers.
+
+import re
+
+from perftest import perftest
+
+
+class DisplacedStepThreads(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super(DisplacedStepThreads, self).__init__("displaced-step-threads")
+
+    def warm_up(self):
+        gdb.execute("continue", False, True)
+
+    def _run(self):
+        # Run one round: all the threads go through the breakpoint,
+        # and the main thread stops at round_done.
+        gdb.execute("continue", False, True)
+
+    def _buffers_used(self, count):
+        # The number of buffers actually used, which is smaller than
+        # COUNT if they don't all fit after the entry point.
+        show = gdb.execute("show displaced-stepping-buffers", False, True)
+        match = re.search(r"but only (\d+) fit", show)
+        return int(match.group(1)) if match else count
+
+    def execute_test(self):
+        measured = set()
+        for count in (1, 2, 4, 8):
+            gdb.execute("set displaced-stepping-buffers %d" % count)
+            # Run one round for the new count to take effect, then
+            # measure each number of buffers actually used once.
+            self._run()
+            used = self._buffers_used(count)
+            if used in measured:
+                continue
+            measured.add(used)
+            self.measure.measure(self._run, used)
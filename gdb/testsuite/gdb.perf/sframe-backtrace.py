@@ -0,0 +1,42 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB doing a backtrace of a
+# deep stack, with the SFrame unwinder and with the DWARF CFI unwinder.
+
+from perftest import perftest
+
+
+class SFrameBackTrace(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, depth):
+        super(SFrameBackTrace, self).__init__("sframe-backtrace")
+        self.depth = depth
+
+    def warm_up(self):
+        gdb.execute("bt", False, True)
+        gdb.execute("bt", False, True)
+
+    def _do_test(self):
+        """Do backtrace multiple times, unwinding from scratch each time."""
+        do_test_command = "bt %d" % self.depth
+        for _ in range(1, 15):
+            gdb.execute("maint flush register-cache", False, True)
+            gdb.execute(do_test_command, False, True)
+
+    def execute_test(self):
+        gdb.execute("maint set persistent-unwind-cache off")
+        for mode in ("off", "on"):
+            gdb.execute("maint set sframe-unwinder %s" % mode)
+            self.measure.measure(self._do_test, "sframe-unwinder-%s" % mode)
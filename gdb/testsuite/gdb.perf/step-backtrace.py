@@ -0,0 +1,42 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB doing a backtrace after
+# each step in a deep stack.
+
+from perftest import perftest
+
+
+class StepBackTrace(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super(StepBackTrace, self).__init__("step-backtrace")
+
+    def warm_up(self):
+        gdb.execute("bt", False, True)
+
+    def _do_test(self):
+        for _ in range(4):
+            gdb.execute("next", False, True)
+            gdb.execute("bt", False, True)
+
+    def execute_test(self):
+        for mode in ("off", "on"):
+            gdb.execute("maint set persistent-unwind-cache %s" % mode)
+            # Fill the cache.
+            gdb.execute("next", False, True)
+            gdb.execute("bt", False, True)
+            self.measure.measure(
+                self._do_test, "persistent-unwind-cache-%s" % mode
+            )
@@ -0,0 +1,60 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+
+/* The number of threads, besides the main thread, that the program
+   should have.  Set by GDB.  */
+volatile int thread_count = 0;
+
+static void *
+thread_function (void *arg)
+{
+  while (1)
+    pause ();
+  return NULL;
+}
+
+void
+breakpoint_here (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_attr_t attr;
+  int started = 0;
+
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, 64 * 1024);
+
+  while (1)
+    {
+      for (; started < thread_count; started++)
+	{
+	  pthread_t thread;
+
+	  pthread_create (&thread, &attr, thread_function, NULL);
+	}
+
+      breakpoint_here ();
+    }
+
+  return 0;
+}
@@ -0,0 +1,45 @@
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when it stops and resumes
+# all the threads of the inferior at each breakpoint hit.
+
+from perftest import perftest
+
+
+class StopThreads(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, thread_count):
+        super(StopThreads, self).__init__("stop-threads")
+        self.thread_count = thread_count
+
+    def warm_up(self):
+        gdb.execute("continue", False, True)
+
+    def _run(self):
+        for _ in range(0, 10):
+            gdb.execute("continue", False, True)
+
+    def execute_test(self):
+        count = 1
+        while True:
+            # Let the inferior start the threads.
+            gdb.execute("set variable thread_count = %d" % count)
+            gdb.execute("continue", False, True)
+
+            self.measure.measure(self._run, count)
+
+            if count >= self.thread_count:
+                break
+            count = min(count * 4, self.thread_count)
@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2024 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define BUF_SIZE 1024
+
+static void
+marker (void)
+{
+}
+
+static int
+recurse (int depth)
+{
+  unsigned char buf[BUF_SIZE];
+  int i;
+
+  for (i = 0; i < BUF_SIZE; i++)
+    buf[i] = (unsigned char) (i * 7 + depth);
+
+  if (depth == 0)
+    marker ();
+  else
+    recurse (depth - 1);
+
+  return buf[depth];
+}
+
+int
+main (void)
+{
+  return recurse (10);
+}
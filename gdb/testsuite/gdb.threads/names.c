@@ -50,6 +50,11 @@ all_threads_ready (void)
 {
 }
 
+static void
+main_renamed (void)
+{
+}
+
 int
 main (int argc, char **argv)
 {
@@ -85,6 +90,11 @@ main (int argc, char **argv)
 
   all_threads_ready ();
 
+  res = pthread_setname_np (pthread_self (), "leek");
+  assert (res == 0);
+
+  main_renamed ();
+
   pthread_barrier_wait (&barrier);
 
   for (i = 0; i < NUM_THREADS; i++)
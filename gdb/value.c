@@ -1760,6 +1760,21 @@ value_history_count ()
   return value_history.size ();
 }
 
+/* See value.h.  */
+
+size_t
+value_history_memory_used ()
+{
+  size_t result = value_history.capacity () * sizeof (value_ref_ptr);
+  for (const value_ref_ptr &val : value_history)
+    {
+      result += sizeof (struct value);
+      if (!val->lazy ())
+	result += val->enclosing_type ()->length ();
+    }
+  return result;
+}
+
 static void
 show_values (const char *num_exp, int from_tty)
 {
@@ -1409,6 +1409,10 @@ extern struct value *access_value_history (int num);
 
 extern ULONGEST value_history_count ();
 
+/* Return the number of bytes of memory used by the value history.  */
+
+extern size_t value_history_memory_used ();
+
 extern struct value *value_of_internalvar (struct gdbarch *gdbarch,
 					   struct internalvar *var);
 
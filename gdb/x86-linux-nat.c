@@ -24,6 +24,7 @@
 #include <sys/user.h>
 #include <sys/procfs.h>
 #include <sys/uio.h>
+#include <sys/syscall.h>
 
 #include "x86-nat.h"
 #ifndef __x86_64__
@@ -41,8 +42,21 @@
 #include "nat/x86-linux.h"
 #include "nat/x86-linux-dregs.h"
 #include "nat/linux-ptrace.h"
+#include "nat/linux-waitpid.h"
 #include "x86-tdep.h"
 
+#ifdef __x86_64__
+/* Value of CS segment register:
+     64bit process: 0x33
+     32bit process: 0x23  */
+#define AMD64_LINUX_USER64_CS 0x33
+
+/* Value of DS segment register:
+     LP64 process: 0x0
+     X32 process: 0x2b  */
+#define AMD64_LINUX_X32_DS 0x2b
+#endif
+
 /* linux_nat_target::low_new_fork implementation.  */
 
 void
@@ -76,6 +90,145 @@ x86_linux_nat_target::low_new_fork (struct lwp_info *parent, pid_t child_pid)
   child_state = x86_debug_reg_state (child_pid);
   *child_state = *parent_state;
 }
+
+/* Implement the region_ok_for_hw_watchpoint target method.  */
+
+int
+x86_linux_nat_target::region_ok_for_hw_watchpoint (CORE_ADDR addr, int len)
+{
+  if (x86_nat_target::region_ok_for_hw_watchpoint (addr, len))
+    return 1;
+
+  return linux_nat_page_watchpoint_ok_p (addr, len);
+}
+
+/* Implement the insert_watchpoint target method.  */
+
+int
+x86_linux_nat_target::insert_watchpoint (CORE_ADDR addr, int len,
+					 enum target_hw_bp_type type,
+					 struct expression *cond)
+{
+  int ret = x86_nat_target::insert_watchpoint (addr, len, type, cond);
+
+  /* Only writes fault in write-protected pages.  */
+  if (ret != 0 && type == hw_write && linux_nat_page_watchpoints_p ())
+    ret = linux_nat_insert_page_watchpoint (addr, len);
+
+  return ret;
+}
+
+/* Implement the remove_watchpoint target method.  */
+
+int
+x86_linux_nat_target::remove_watchpoint (CORE_ADDR addr, int len,
+					 enum target_hw_bp_type type,
+					 struct expression *cond)
+{
+  if (type == hw_write && linux_nat_page_watchpoint_p (addr, len))
+    return linux_nat_remove_page_watchpoint (addr, len);
+
+  return x86_nat_target::remove_watchpoint (addr, len, type, cond);
+}
+
+/* The number of the mprotect system call for i386 programs.  */
+
+#define I386_LINUX_SYS_MPROTECT 125
+
+/* linux_nat_target::low_inferior_mprotect implementation.  Make TID
+   execute a system call instruction written at its PC, with the
+   registers set up for mprotect, then restore the instruction and
+   the registers.  */
+
+bool
+x86_linux_nat_target::low_inferior_mprotect (pid_t tid, CORE_ADDR addr,
+					     ULONGEST len, int prot)
+{
+  static const gdb_byte syscall_insn[] = { 0x0f, 0x05 };	/* syscall */
+  static const gdb_byte int80_insn[] = { 0xcd, 0x80 };	/* int $0x80 */
+  struct user_regs_struct saved_regs, regs;
+
+  if (ptrace (PTRACE_GETREGS, tid, 0, &saved_regs) < 0)
+    return false;
+  regs = saved_regs;
+
+#ifdef __x86_64__
+  CORE_ADDR pc = regs.rip;
+  bool is_64bit = regs.cs == AMD64_LINUX_USER64_CS;
+
+  if (is_64bit)
+    {
+      regs.rax = amd64_sys_mprotect;
+      regs.rdi = addr;
+      regs.rsi = len;
+      regs.rdx = prot;
+    }
+  else
+    {
+      regs.rax = I386_LINUX_SYS_MPROTECT;
+      regs.rbx = addr;
+      regs.rcx = len;
+      regs.rdx = prot;
+    }
+  /* Don't let the kernel restart an interrupted system call.  */
+  regs.orig_rax = -1;
+#else
+  CORE_ADDR pc = regs.eip;
+  bool is_64bit = false;
+
+  regs.eax = I386_LINUX_SYS_MPROTECT;
+  regs.ebx = addr;
+  regs.ecx = len;
+  regs.edx = prot;
+  regs.orig_eax = -1;
+#endif
+
+  errno = 0;
+  PTRACE_TYPE_RET saved_insn = ptrace (PTRACE_PEEKTEXT, tid, pc, 0);
+  if (errno != 0)
+    return false;
+
+  PTRACE_TYPE_RET insn = saved_insn;
+  memcpy (&insn, is_64bit ? syscall_insn : int80_insn, 2);
+  if (ptrace (PTRACE_POKETEXT, tid, pc, insn) < 0)
+    return false;
+
+  bool done = false;
+  int pending_signal = 0;
+  if (ptrace (PTRACE_SETREGS, tid, 0, &regs) == 0)
+    {
+      /* A signal may be reported before the instruction executes.
+	 Keep it for later, and step again.  */
+      for (int tries = 0; !done && tries < 8; tries++)
+	{
+	  int status;
+
+	  if (ptrace (PTRACE_SINGLESTEP, tid, 0, 0) < 0
+	      || my_waitpid (tid, &status, __WALL) != tid)
+	    break;
+
+	  /* The process is gone, and there is nothing to restore.  */
+	  if (!WIFSTOPPED (status))
+	    return false;
+
+	  if (WSTOPSIG (status) == SIGTRAP)
+	    done = ptrace (PTRACE_GETREGS, tid, 0, &regs) == 0;
+	  else
+	    pending_signal = WSTOPSIG (status);
+	}
+    }
+
+  ptrace (PTRACE_POKETEXT, tid, pc, saved_insn);
+  ptrace (PTRACE_SETREGS, tid, 0, &saved_regs);
+  if (pending_signal != 0)
+    syscall (SYS_tkill, tid, pending_signal);
+
+#ifdef __x86_64__
+  return done && regs.rax == 0;
+#else
+  return done && regs.eax == 0;
+#endif
+}
 
 
 x86_linux_nat_target::~x86_linux_nat_target ()
@@ -91,18 +244,6 @@ x86_linux_nat_target::post_startup_inferior (ptid_t ptid)
   linux_nat_target::post_startup_inferior (ptid);
 }
 
-#ifdef __x86_64__
-/* Value of CS segment register:
-     64bit process: 0x33
-     32bit process: 0x23  */
-#define AMD64_LINUX_USER64_CS 0x33
-
-/* Value of DS segment register:
-     LP64 process: 0x0
-     X32 process: 0x2b  */
-#define AMD64_LINUX_X32_DS 0x2b
-#endif
-
 /* Get Linux/x86 target description from running target.  */
 
 const struct target_desc *
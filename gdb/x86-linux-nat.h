@@ -61,8 +61,24 @@ struct x86_linux_nat_target : public x86_nat_target<linux_nat_target>
   bool low_stopped_data_address (CORE_ADDR *addr_p) override
   { return x86_nat_target::stopped_data_address (addr_p); }
 
+  /* Fall back to page-protection watchpoints, see "set
+     page-watchpoints", for regions the debug registers can't
+     watch.  */
+  int region_ok_for_hw_watchpoint (CORE_ADDR addr, int len) override;
+
+  int insert_watchpoint (CORE_ADDR addr, int len,
+			 enum target_hw_bp_type type,
+			 struct expression *cond) override;
+
+  int remove_watchpoint (CORE_ADDR addr, int len,
+			 enum target_hw_bp_type type,
+			 struct expression *cond) override;
+
   void low_new_fork (struct lwp_info *parent, pid_t child_pid) override;
 
+  bool low_inferior_mprotect (pid_t tid, CORE_ADDR addr, ULONGEST len,
+			      int prot) override;
+
   void low_forget_process (pid_t pid) override
   { x86_forget_process (pid); }
 
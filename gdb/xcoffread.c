@@ -2935,6 +2935,8 @@ static const struct sym_fns xcoff_sym_fns =
   aix_process_linenos,
   default_symfile_relocate,	/* Relocate a debug section.  */
   NULL,				/* sym_probe_fns */
+  NULL,				/* sym_prefetch */
+  NULL,				/* sym_prefetch_release */
 };
 
 /* Same as xcoff_get_n_import_files, but for core files.  */
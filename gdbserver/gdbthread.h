@@ -86,6 +86,11 @@ struct thread_info : public intrusive_list_node<thread_info>
   /* Target description for this thread.  Only present if it's different
      from the one in process_info.  */
   const struct target_desc *tdesc = nullptr;
+
+  /* The registers of this thread as last sent to GDB by a 'g' or
+     qDeltaRegisters packet, in the format of the 'g' packet.  Only
+     kept if GDB supports the qDeltaRegisters packet.  */
+  std::string delta_registers_baseline;
 };
 
 void remove_thread (struct thread_info *thread);
@@ -25,11 +25,13 @@
 #include "debug.h"
 #include "dll.h"
 #include "gdbsupport/rsp-low.h"
+#include "gdbsupport/byte-vector.h"
 #include "gdbsupport/scope-exit.h"
 #include "gdbsupport/netstuff.h"
 #include "gdbsupport/filestuff.h"
 #include "gdbsupport/gdb-sigmask.h"
 #include <ctype.h>
+#include <zlib.h>
 #if HAVE_SYS_IOCTL_H
 #include <sys/ioctl.h>
 #endif
@@ -626,6 +628,46 @@ read_prim (void *buf, int count)
     return read (remote_desc, buf, count);
 }
 
+/* Compress the CNT bytes of packet data in BUF, as requested by GDB
+   with the QCompressReplies packet.  The result, in OUT, has the form
+   "}Z<length>:<data>", where LENGTH is CNT in hex and DATA is the
+   zlib stream, escaped like other binary data.  No uncompressed reply
+   starts with '}', which is the escape character.  Return false,
+   leaving OUT unspecified, if the result would not be shorter than
+   the original packet data.  */
+
+static bool
+compress_packet (const char *buf, int cnt, gdb::byte_vector &out)
+{
+  uLongf zlen = compressBound (cnt);
+  gdb::byte_vector zbuf (zlen);
+
+  if (compress2 (zbuf.data (), &zlen, (const Bytef *) buf, cnt,
+		 Z_BEST_SPEED) != Z_OK)
+    return false;
+
+  char header[32];
+  int header_len = xsnprintf (header, sizeof (header), "}Z%x:", cnt);
+  if (header_len + zlen >= (uLongf) cnt)
+    return false;
+
+  /* Every escaped byte takes at most two bytes.  */
+  out.resize (header_len + 2 * zlen);
+  memcpy (out.data (), header, header_len);
+
+  int out_units;
+  int escaped_len = remote_escape_output (zbuf.data (), zlen, 1,
+					  out.data () + header_len,
+					  &out_units, 2 * zlen);
+  gdb_assert (out_units == (int) zlen);
+
+  if (header_len + escaped_len >= cnt)
+    return false;
+
+  out.resize (header_len + escaped_len);
+  return true;
+}
+
 /* Send a packet to the remote machine, with error checking.
    The data of the packet is in BUF, and the length of the
    packet is in CNT.  Returns >= 0 on success, -1 otherwise.  */
@@ -639,9 +681,21 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
   char *buf2;
   char *p;
   int cc;
+  gdb::byte_vector compressed;
 
   SCOPE_EXIT { suppressed_remote_debug = false; };
 
+  if (!is_notif
+      && cs.compress_replies_threshold != 0
+      && (unsigned int) cnt >= cs.compress_replies_threshold
+      && compress_packet (buf, cnt, compressed))
+    {
+      remote_debug_printf ("compressed reply from %d to %zu bytes",
+			   cnt, compressed.size ());
+      buf = (char *) compressed.data ();
+      cnt = compressed.size ();
+    }
+
   buf2 = (char *) xmalloc (strlen ("$") + cnt + strlen ("#nn") + 1);
 
   /* Copy the packet into buffer BUF2, encapsulating it
@@ -1056,6 +1110,46 @@ outreg (struct regcache *regcache, int regno, char *buf)
   return buf;
 }
 
+/* Output the expedited registers of REGCACHE into BUF, as a list of
+   'regno:value;' pairs: the registers that the target description
+   marks as expedited, then the ones that GDB asked for with the
+   QExpeditedRegisters packet, skipping those that would not fit
+   before BUF_END.  Return a pointer past the output.  */
+
+static char *
+outreg_expedited (struct regcache *regcache, char *buf, const char *buf_end)
+{
+  client_state &cs = get_client_state ();
+  const target_desc *tdesc = regcache->tdesc;
+  std::vector<bool> sent (tdesc->reg_defs.size ());
+
+  for (const std::string &expedited_reg : tdesc->expedite_regs)
+    {
+      int regno = find_regno (tdesc, expedited_reg.c_str ());
+
+      buf = outreg (regcache, regno, buf);
+      sent[regno] = true;
+    }
+
+  for (int regno : cs.expedite_regnos)
+    {
+      /* GDB may have asked for registers that this thread's target
+	 description doesn't have.  */
+      if (regno >= tdesc->reg_defs.size () || sent[regno]
+	  || register_size (tdesc, regno) == 0)
+	continue;
+
+      /* Leave room for the register number and the separators.  */
+      if (buf + 2 * register_size (tdesc, regno) + 8 > buf_end)
+	continue;
+
+      buf = outreg (regcache, regno, buf);
+      sent[regno] = true;
+    }
+
+  return buf;
+}
+
 /* See remote-utils.h.  */
 
 unsigned int
@@ -1247,11 +1341,9 @@ prepare_resume_reply (char *buf, ptid_t ptid, const target_waitstatus &status)
 	    buf += strlen (buf);
 	  }
 
-	/* Handle the expedited registers.  */
-	for (const std::string &expedited_reg :
-	     current_target_desc ()->expedite_regs)
-	  buf = outreg (regcache, find_regno (regcache->tdesc,
-					      expedited_reg.c_str ()), buf);
+	/* Handle the expedited registers.  Leave room for the thread
+	   and core fields below.  */
+	buf = outreg_expedited (regcache, buf, buf_start + PBUFSIZ - 256);
 	*buf = '\0';
 
 	/* Formerly, if the debugger had not used any thread features
@@ -1361,10 +1453,7 @@ output_expedite_registers (char *buf)
      fetch the registers alltogether.  */
   regcache *regcache = get_thread_regcache (current_thread, false);
 
-  for (const std::string &expedited_reg : regcache->tdesc->expedite_regs)
-    buf = outreg (regcache, find_regno (regcache->tdesc,
-					expedited_reg.c_str ()), buf);
-
+  buf = outreg_expedited (regcache, buf, buf + PBUFSIZ - 1);
   *buf = '\0';
 }
 
@@ -44,7 +44,8 @@ void prepare_resume_reply (char *buf, ptid_t ptid,
 			   const target_waitstatus &status);
 
 /* Output the expedited registers of the current thread into BUF
-   as a list of 'regno:value;' pairs.  */
+   as a list of 'regno:value;' pairs.  This includes the registers
+   that GDB asked for with the QExpeditedRegisters packet.  */
 void output_expedite_registers (char *buf);
 
 const char *decode_address_to_semicolon (CORE_ADDR *addrp, const char *start);
@@ -846,6 +846,63 @@ handle_general_set (char *own_buf)
       return;
     }
 
+  if (startswith (own_buf, "QCompressReplies:"))
+    {
+      const char *p = own_buf + strlen ("QCompressReplies:");
+
+      if (!startswith (p, "zlib,"))
+	{
+	  strcpy (own_buf, "E.Unknown compression method.");
+	  return;
+	}
+
+      p += strlen ("zlib,");
+      char *endp;
+      errno = 0;
+      unsigned long threshold = strtoul (p, &endp, 16);
+      if (endp == p || *endp != '\0' || errno != 0
+	  || threshold > UINT_MAX)
+	{
+	  strcpy (own_buf, "E.Bad threshold value.");
+	  return;
+	}
+
+      remote_debug_printf ("[compressing replies of %lu bytes or more]",
+			   threshold);
+
+      cs.compress_replies_threshold = threshold;
+      write_ok (own_buf);
+      return;
+    }
+
+  if (startswith (own_buf, "QExpeditedRegisters:"))
+    {
+      const char *p = own_buf + strlen ("QExpeditedRegisters:");
+      std::vector<int> regnos;
+
+      while (*p != '\0')
+	{
+	  ULONGEST regno;
+	  const char *q = unpack_varlen_hex (p, &regno);
+
+	  if (q == p || (*q != ';' && *q != '\0') || regno > INT_MAX)
+	    {
+	      strcpy (own_buf, "E.Bad register number.");
+	      return;
+	    }
+
+	  regnos.push_back (regno);
+	  p = (*q == ';') ? q + 1 : q;
+	}
+
+      remote_debug_printf ("[expediting %zu more registers]",
+			   regnos.size ());
+
+      cs.expedite_regnos = std::move (regnos);
+      write_ok (own_buf);
+      return;
+    }
+
   if (startswith (own_buf, "QNonStop:"))
     {
       char *mode = own_buf + 9;
@@ -2726,6 +2783,62 @@ supported_btrace_packets (char *buf)
   strcat (buf, ";qXfer:btrace-conf:read+");
 }
 
+/* Handle a "qDeltaRegisters" packet: output into OWN_BUF, as a list
+   of 'regno:value;' pairs, the registers of the current thread that
+   changed since they were last sent to GDB by a 'g' or qDeltaRegisters
+   packet, and remember the new values.  Output all the registers if
+   there is no such baseline, e.g. because the thread's target
+   description changed, and "OK" if no register changed.  */
+
+static void
+handle_delta_registers (char *own_buf)
+{
+  client_state &cs = get_client_state ();
+
+  /* From now on, remember the registers sent by 'g' packets too,
+     even if GDB didn't say in qSupported that it would use this
+     packet.  */
+  cs.delta_registers_feature = true;
+
+  regcache *regcache = get_thread_regcache (current_thread);
+  const target_desc *tdesc = regcache->tdesc;
+  std::string &baseline = current_thread->delta_registers_baseline;
+  std::string current (2 * tdesc->registers_size, '\0');
+  bool have_baseline = baseline.size () == current.size ();
+  std::string reply;
+
+  regcache->registers_to_string (&current[0]);
+
+  for (int regno = 0; regno < tdesc->reg_defs.size (); regno++)
+    {
+      const gdb::reg &reg = tdesc->reg_defs[regno];
+      size_t offset = 2 * (reg.offset / 8);
+      size_t len = 2 * (reg.size / 8);
+
+      if (len == 0
+	  || (have_baseline
+	      && baseline.compare (offset, len, current, offset, len) == 0))
+	continue;
+
+      string_appendf (reply, "%x:", regno);
+      reply.append (current, offset, len);
+      reply += ';';
+    }
+
+  /* GDB falls back to the 'g' packet in case of error.  */
+  if (reply.size () >= PBUFSIZ)
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  if (reply.empty ())
+    write_ok (own_buf);
+  else
+    strcpy (own_buf, reply.c_str ());
+  baseline = std::move (current);
+}
+
 /* Handle all of the extended 'q' packets.  */
 
 static void
@@ -2968,6 +3081,12 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 		;
 	      else if (feature == "QThreadOptions+")
 		;
+	      else if (feature == "qDeltaRegisters+")
+		{
+		  /* GDB will ask for the registers that changed since
+		     it last read them.  */
+		  cs.delta_registers_feature = true;
+		}
 	      else if (feature == "no-resumed+")
 		{
 		  /* GDB supports and wants TARGET_WAITKIND_NO_RESUMED
@@ -3138,6 +3257,17 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       /* Binary memory read support.  */
       strcat (own_buf, ";x+");
 
+      /* Multiple memory ranges read support.  */
+      strcat (own_buf, ";vReadMemRanges+");
+
+      /* Compression of large replies.  */
+      strcat (own_buf, ";QCompressReplies+");
+
+      /* Negotiation of the expedited registers, and register
+	 deltas.  */
+      strcat (own_buf, ";QExpeditedRegisters+");
+      strcat (own_buf, ";qDeltaRegisters+");
+
       /* Z points support.  */
       strcat (own_buf, z_type_supported ('0') ? ";Z0+" : ";Z0-");
       strcat (own_buf, z_type_supported ('1') ? ";Z1+" : ";Z1-");
@@ -3304,6 +3434,17 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  if (strcmp (own_buf, "qDeltaRegisters") == 0)
+    {
+      require_running_or_return (own_buf);
+
+      if (cs.current_traceframe >= 0 || !set_desired_thread ())
+	write_enn (own_buf);
+      else
+	handle_delta_registers (own_buf);
+      return;
+    }
+
   if (strcmp (own_buf, "qDeltaThreadList") == 0)
     {
       strcpy (own_buf,
@@ -3877,6 +4018,85 @@ handle_v_kill (char *own_buf)
     write_enn (own_buf);
 }
 
+/* Handle a "vReadMemRanges:" packet: read each of the memory ranges
+   it lists, and reply with "b" followed, for each range, by the number
+   of bytes read, a colon, and those bytes.  Ranges that don't fit in
+   the reply are left out.  */
+
+static void
+handle_v_read_mem_ranges (char *own_buf, int *new_packet_len)
+{
+  std::vector<std::pair<CORE_ADDR, ULONGEST>> ranges;
+  const char *p = own_buf + strlen ("vReadMemRanges:");
+
+  require_running_or_return (own_buf);
+
+  while (*p != '\0')
+    {
+      ULONGEST addr, len;
+
+      p = unpack_varlen_hex (p, &addr);
+      if (*p != ',')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      p = unpack_varlen_hex (p + 1, &len);
+      if (*p == ';')
+	p++;
+      else if (*p != '\0')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      ranges.emplace_back (addr, len);
+    }
+
+  if (ranges.empty ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  int buf_size = target_query_pbuf_size ();
+  gdb::byte_vector escaped (buf_size);
+  gdb_byte *out = (gdb_byte *) own_buf;
+  int out_len = 0;
+
+  out[out_len++] = 'b';
+  for (const auto &[addr, len] : ranges)
+    {
+      char header[sizeof (ULONGEST) * 2 + 2];
+      int room = buf_size - out_len - (int) sizeof (header);
+      if (room <= 0)
+	break;
+
+      int todo = std::min (len, (ULONGEST) room);
+      int res = gdb_read_memory (addr, mem_buf, todo);
+      if (res < 0)
+	res = 0;
+
+      int escaped_len = 0;
+      int out_len_units = 0;
+      if (res > 0)
+	escaped_len = remote_escape_output (mem_buf, res, 1, escaped.data (),
+					    &out_len_units, room);
+
+      xsnprintf (header, sizeof (header), "%x:", out_len_units);
+      memcpy (out + out_len, header, strlen (header));
+      out_len += strlen (header);
+      memcpy (out + out_len, escaped.data (), escaped_len);
+      out_len += escaped_len;
+
+      /* The contents of this range didn't fit.  */
+      if (out_len_units < res)
+	break;
+    }
+
+  *new_packet_len = out_len;
+  suppress_next_putpkt_log ();
+}
+
 /* Handle all of the extended 'v' packets.  */
 void
 handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
@@ -3978,6 +4198,12 @@ handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
       return;
     }
 
+  if (startswith (own_buf, "vReadMemRanges:"))
+    {
+      handle_v_read_mem_ranges (own_buf, new_packet_len);
+      return;
+    }
+
   if (handle_notif_ack (own_buf, packet_len))
     return;
 
@@ -4784,6 +5010,7 @@ captured_main (int argc, char *argv[])
   while (1)
     {
       cs.noack_mode = 0;
+      cs.compress_replies_threshold = 0;
       cs.multi_process = 0;
       cs.report_fork_events = 0;
       cs.report_vfork_events = 0;
@@ -4795,6 +5022,12 @@ captured_main (int argc, char *argv[])
       cs.hwbreak_feature = 0;
       cs.vCont_supported = 0;
       cs.memory_tagging_feature = false;
+      cs.expedite_regnos.clear ();
+      cs.delta_registers_feature = false;
+      for_each_thread ([] (thread_info *thread)
+	{
+	  thread->delta_registers_baseline.clear ();
+	});
 
       remote_open (port);
 
@@ -5108,6 +5341,11 @@ process_serial_event (void)
 	    {
 	      regcache = get_thread_regcache (current_thread);
 	      regcache->registers_to_string (cs.own_buf);
+
+	      /* Remember what GDB got, for the next qDeltaRegisters
+		 packets.  */
+	      if (cs.delta_registers_feature)
+		current_thread->delta_registers_baseline = cs.own_buf;
 	    }
 	}
       break;
@@ -206,6 +206,21 @@ struct client_state
   /* If true, then we tell GDB to use noack mode by default.  */
   int transport_is_reliable = 0;
 
+  /* Replies at least this many bytes long are sent compressed, if
+     that makes them shorter.  Zero if GDB did not ask for compressed
+     replies with the QCompressReplies packet.  */
+  unsigned int compress_replies_threshold = 0;
+
+  /* The numbers of the registers that GDB asked to be expedited in
+     stop replies with the QExpeditedRegisters packet, in addition to
+     the ones of the target description.  */
+  std::vector<int> expedite_regnos;
+
+  /* True if GDB supports the qDeltaRegisters packet.  In that case,
+     the registers sent to GDB by the 'g' and qDeltaRegisters packets
+     are remembered for each thread.  */
+  bool delta_registers_feature = false;
+
   /* The traceframe to be used as the source of data to send back to
      GDB.  A value of -1 means to get data from the live program.  */
 